@@ -44,6 +44,7 @@ struct ForkContextConfig {
 	int mCurrentBranchesTimeout = 0;              /*timeout for receiving response on current branches*/
 	bool mForkLate = false;
 	bool mSaveForkMessageEnabled = false;
+	std::chrono::seconds mSaveForkMessageDelay{0}; /* idle duration before a saved fork message is evicted from memory */
 	bool mTreatAllErrorsAsUrgent = false; /*treat all SIP response code as urgent replies in the fork mechanism.*/
 	bool mForkNoGlobalDecline = false;
 	bool mTreatDeclineAsUrgent =
@@ -0,0 +1,100 @@
+/*
+    Flexisip, a flexible SIP proxy server with media capabilities.
+    Copyright (C) 2010-2024 Belledonne Communications SARL, All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace flexisip {
+
+/**
+ * @class ForkMap
+ * @brief Index of the pending forks by routing key (AoR or alias).
+ *
+ * Each key is stored once, whatever the number of forks waiting on it, and maps to the list of these forks in insertion
+ * order. Looking up the forks of a key, which is done on every contact registration, costs a single hash lookup
+ * instead of a tree traversal with string comparisons.
+ *
+ * @tparam Fork The type of the indexed elements, typically std::shared_ptr<ForkContext>.
+ */
+template <typename Fork>
+class ForkMap {
+public:
+	using ForkList = std::vector<Fork>;
+
+	void add(const std::string& key, Fork fork) {
+		auto it = mIndex.find(key);
+		if (it == mIndex.end()) it = mIndex.emplace(key, ForkList{}).first;
+		it->second.push_back(std::move(fork));
+		mSize++;
+	}
+
+	/**
+	 * @return the forks stored with the given key, or nullptr if there is none. The pointer is invalidated by any
+	 * modification of the map.
+	 */
+	const ForkList* find(const std::string& key) const noexcept {
+		const auto it = mIndex.find(key);
+		return it == mIndex.end() ? nullptr : &it->second;
+	}
+
+	/**
+	 * Remove all the occurrences of a fork stored with one of the given keys.
+	 * @return the number of removed entries.
+	 */
+	std::size_t remove(const std::vector<std::string>& keys, const Fork& fork) {
+		std::size_t removed = 0;
+		for (const auto& key : keys) {
+			const auto it = mIndex.find(key);
+			if (it == mIndex.end()) continue;
+			auto& forks = it->second;
+			const auto newEnd = std::remove(forks.begin(), forks.end(), fork);
+			removed += std::distance(newEnd, forks.end());
+			forks.erase(newEnd, forks.end());
+			if (forks.empty()) mIndex.erase(it);
+		}
+		mSize -= removed;
+		return removed;
+	}
+
+	/**
+	 * Number of (key, fork) entries. A fork stored with several keys is counted once per key.
+	 */
+	std::size_t size() const noexcept {
+		return mSize;
+	}
+	std::size_t keyCount() const noexcept {
+		return mIndex.size();
+	}
+	bool empty() const noexcept {
+		return mSize == 0;
+	}
+	void reserve(std::size_t keyCount) {
+		mIndex.reserve(keyCount);
+	}
+
+private:
+	std::unordered_map<std::string, ForkList> mIndex{};
+	std::size_t mSize = 0;
+};
+
+} // namespace flexisip
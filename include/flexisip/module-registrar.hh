@@ -129,6 +129,13 @@ public:
 
 	virtual void onResponse(std::shared_ptr<ResponseSipEvent>& ev);
 
+	SipMethodSet getHandledRequestMethods() const override {
+		return {sip_method_register};
+	}
+	SipMethodSet getHandledResponseMethods() const override {
+		return {sip_method_register};
+	}
+
 	template <typename SipEventT, typename ListenerT>
 	void processUpdateRequest(std::shared_ptr<SipEventT>& ev, const sip_t* sip);
 
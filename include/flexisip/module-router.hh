@@ -22,6 +22,7 @@
 #include <vector>
 
 #include "flexisip/fork-context/fork-context.hh"
+#include "flexisip/fork-context/fork-map.hh"
 #include "flexisip/module-router-interface.hh"
 #include "flexisip/module.hh"
 #include "flexisip/registrar/registar-listeners.hh"
@@ -39,6 +40,7 @@ struct RouterStats {
 
 class OnContactRegisteredListener;
 class Injector;
+class ForkMessageContextRepository;
 class Agent;
 class Record;
 
@@ -109,6 +111,9 @@ public:
 	const std::shared_ptr<ForkContextConfig>& getOtherForkCfg() const {
 		return mOtherForkCfg;
 	}
+	const std::shared_ptr<ForkMessageContextRepository>& getForkMessageRepository() const {
+		return mForkMessageRepository;
+	}
 
 	void sendToInjector(const std::shared_ptr<RequestSipEvent>& ev,
 	                    const std::shared_ptr<ForkContext>& context,
@@ -126,7 +131,7 @@ protected:
 	ModuleRouter(Agent* ag, const ModuleInfoBase* moduleInfo);
 
 	using ForkMapElem = std::shared_ptr<ForkContext>;
-	using ForkMap = std::multimap<std::string, ForkMapElem>;
+	using ForkMap = flexisip::ForkMap<ForkMapElem>;
 	using ForkRefList = std::vector<ForkMapElem>;
 
 	// This template method has a single specialization that returns the key
@@ -160,15 +165,14 @@ protected:
 	url_t* mFallbackRouteParsed = nullptr;
 
 private:
-#if ENABLE_SOCI
 	void restoreForksFromDatabase();
-#endif
 
 	static ModuleInfo<ModuleRouter> sInfo;
 	static sofiasip::MsgSipPriority sMaxPriorityHandled;
 	std::shared_ptr<SipBooleanExpression> mFallbackRouteFilter;
 	std::shared_ptr<OnContactRegisteredListener> mOnContactRegisteredListener{nullptr};
 	std::unique_ptr<Injector> mInjector;
+	std::shared_ptr<ForkMessageContextRepository> mForkMessageRepository;
 	std::vector<SipUri> mStaticTargets;
 };
 
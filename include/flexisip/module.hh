@@ -18,8 +18,12 @@
 
 #pragma once
 
+#include <cstdint>
+#include <initializer_list>
+
 #include <sofia-sip/msg_header.h>
 #include <sofia-sip/nta_tport.h>
+#include <sofia-sip/sip.h>
 #include <sofia-sip/tport.h>
 
 #include "flexisip/configmanager.hh"
@@ -44,6 +48,40 @@ class EntryFilter;
 
 enum class ModuleClass { Experimental, Production };
 
+/**
+ * Set of SIP methods, as enumerated by SofiaSip. Extension methods (e.g. DECLINE) are all represented by
+ * sip_method_unknown.
+ */
+class SipMethodSet {
+public:
+	constexpr SipMethodSet() = default;
+	constexpr SipMethodSet(std::initializer_list<sip_method_t> methods) {
+		for (auto method : methods) {
+			mBits |= bit(method);
+		}
+	}
+
+	static constexpr SipMethodSet all() {
+		SipMethodSet set{};
+		set.mBits = ~std::uint32_t{0};
+		return set;
+	}
+
+	constexpr bool contains(sip_method_t method) const {
+		return (mBits & bit(method)) != 0;
+	}
+	constexpr bool empty() const {
+		return mBits == 0;
+	}
+
+private:
+	static constexpr std::uint32_t bit(sip_method_t method) {
+		return method < sip_method_unknown || method > sip_method_publish ? 1 : std::uint32_t{1} << method;
+	}
+
+	std::uint32_t mBits{0};
+};
+
 /**
  * Abstract base class for all Flexisip module.
  * A module is an object that is able to process sip requests and sip responses.
@@ -88,6 +126,21 @@ public:
 		return mInfo;
 	}
 
+	/**
+	 * Methods of the requests this module may act on. The Agent doesn't pass the other requests to this module.
+	 * Modules which need to see every request must keep the default implementation.
+	 */
+	virtual SipMethodSet getHandledRequestMethods() const {
+		return SipMethodSet::all();
+	}
+	/**
+	 * Methods (from the CSeq header) of the responses this module may act on. The Agent doesn't pass the other
+	 * responses to this module. Return an empty set when onResponse() does nothing.
+	 */
+	virtual SipMethodSet getHandledResponseMethods() const {
+		return SipMethodSet::all();
+	}
+
 protected:
 	virtual void onLoad([[maybe_unused]] const GenericStruct* root) {
 	}
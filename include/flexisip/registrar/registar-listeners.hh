@@ -60,6 +60,10 @@ class ListContactUpdateListener {
 public:
 	virtual ~ListContactUpdateListener() = default;
 	virtual void onContactsUpdated() = 0;
+	// Called instead of onContactsUpdated() when the records could not be fetched (e.g. the database is unreachable).
+	virtual void onError([[maybe_unused]] const SipStatus& response) {
+		onContactsUpdated();
+	}
 
 	std::vector<std::shared_ptr<Record>> records;
 };
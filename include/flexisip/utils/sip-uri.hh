@@ -181,6 +181,13 @@ public:
 	 * the new URL would be invalid.
 	 */
 	Url replaceUser(const std::string& newUser) const;
+	/**
+	 * Create a new URL by replacing the port part by another string.
+	 * An empty string removes the port part.
+	 * @throw UrlModificationError when the actual URL is empty or
+	 * the new URL would be invalid.
+	 */
+	Url replacePort(const std::string& newPort) const;
 
 	/**
 	 * Test whether the URL has a given param by its name.
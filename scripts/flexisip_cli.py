@@ -29,7 +29,7 @@ def parse_args():
 		'REGISTRAR_UPSERT': {'help': 'Update or Insert a binding for an Adress of Record (AOR) in the registrar database.'},
 		'REGISTRAR_DELETE': {'help': 'Remove a specific binding of an address of record from the registrar database.'},
 		'REGISTRAR_CLEAR': {'help': 'Remove an address-of-record from the registrar database.'},
-		'REGISTRAR_DUMP': {'help': 'Dump list of registered address-of-records for this proxy instance only (not all the cluster !)'},
+		'REGISTRAR_DUMP': {'help': 'Dump the list of registered address-of-records, one JSON object per line.'},
 		'SIP_BRIDGE': {'help': 'Send commands to the external SIP provider bridge. (If active)'},
 	}
 
@@ -62,6 +62,9 @@ def parse_args():
 	commands['REGISTRAR_UPSERT']['parser'].add_argument('uuid', help='Unique identifier of the binding. Get it from REGISTRAR_GET for updates, leave it out to be autogenerated on insertions.', default=None, nargs='?')
 	commands['REGISTRAR_DELETE']['parser'].add_argument('uri', help='AOR sip uri.')
 	commands['REGISTRAR_DELETE']['parser'].add_argument('uuid', help='+sip.instance value identifying the binding.')
+	commands['REGISTRAR_DUMP']['parser'].add_argument('scope', choices=('local', 'all'), default='local', nargs='?',
+		help='\'local\' for the address-of-records registered on this proxy instance only, \'all\' for every '
+		'address-of-record of the registrar database (the whole cluster when using Redis). (default: local)')
 	commands['SIP_BRIDGE']['parser'].add_argument('subcommand', help='The command to send to the bridge. Valid commands: INFO')
 
 	return parser.parse_args()
@@ -108,18 +111,34 @@ def formatMessage(args):
 	elif args.command == 'REGISTRAR_DELETE':
 		messageArgs.append(args.uri)
 		messageArgs.append(args.uuid)
+	elif args.command == 'REGISTRAR_DUMP':
+		messageArgs.append(args.scope)
 	elif args.command == 'SIP_BRIDGE':
 		messageArgs.append(args.subcommand)
 	return ' '.join(messageArgs)
 
 
-def sendMessage(remote_socket, message):
+def receiveStream(s):
+	"""Copy everything the server sends to stdout until it closes the connection. Returns the first chunk."""
+	first = s.recv(65535)
+	chunk = first
+	while chunk:
+		sys.stdout.buffer.write(chunk)
+		chunk = s.recv(65535)
+	sys.stdout.flush()
+	return first.decode(errors='replace')
+
+
+def sendMessage(remote_socket, message, stream=False):
 	import socket
 	with socket.socket(socket.AF_UNIX) as s:
 		s.settimeout(1)
 		try:
 			s.connect(remote_socket)
 			s.send(message.encode())
+			if stream:
+				received = receiveStream(s)
+				return os.EX_USAGE if received.startswith('Error') else os.EX_OK
 			received = s.recv(65535).decode()
 			print(received)
 			if received.startswith('Error'):
@@ -144,7 +163,8 @@ def main():
 	socket = '/tmp/{}-{}'.format(proc_name, pid)
 
 	message = formatMessage(args)
-	return sendMessage(socket, message)
+	# The registrar dump may be much larger than a single read, it is streamed until the server closes the socket.
+	return sendMessage(socket, message, stream=(args.command == 'REGISTRAR_DUMP'))
 
 
 if __name__ == '__main__':
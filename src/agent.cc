@@ -43,6 +43,7 @@
 #include "nat/contact-correction-strategy.hh"
 #include "nat/flow-token-strategy.hh"
 #include "plugin/plugin-loader.hh"
+#include "utils/pool-allocator.hh"
 #include "utils/uri-utils.hh"
 
 #define IPADDR_SIZE 64
@@ -53,6 +54,17 @@ using namespace sofiasip;
 namespace flexisip {
 
 namespace {
+/*
+ * Shift the port of a transport URI. Used when several proxy workers run side by side: each of them listens on its own
+ * set of ports. Random ports ('0' or '*') are left untouched.
+ */
+Url shiftTransportPort(const Url& url, int offset) {
+	if (offset == 0) return url;
+	const auto port = url.getPort(true);
+	if (port.empty() || port == "0" || port == "*") return url;
+	return url.replacePort(to_string(stoi(port) + offset));
+}
+
 void createAgentCounters(GenericStruct& root) {
 	auto* globalConfig = root.get<GenericStruct>("global");
 	auto createCounter = [&globalConfig](string keyprefix, string helpprefix, string value) {
@@ -246,6 +258,7 @@ void Agent::loadModules() {
 		module->checkConfig();
 		module->load();
 	}
+	buildModuleChains();
 	if (mDrm) mDrm->load(mPassphrase);
 	mPassphrase = "";
 }
@@ -306,7 +319,7 @@ static void timerfunc([[maybe_unused]] su_root_magic_t* magic, [[maybe_unused]]
 	a->idle();
 }
 
-void Agent::start(const string& transport_override, const string& passphrase) {
+void Agent::start(const string& transport_override, const string& passphrase, int transportPortOffset) {
 	char cCurrDir[FILENAME_MAX];
 	if (!getcwd(cCurrDir, sizeof(cCurrDir))) {
 		LOGA("Could not get current file path");
@@ -356,11 +369,11 @@ void Agent::start(const string& transport_override, const string& passphrase) {
 	}
 
 	for (const auto& uri : transports) {
-		Url url{uri};
+		const auto url = shiftTransportPort(Url{uri}, transportPortOffset);
 		int err;
 		su_home_t home;
 		su_home_init(&home);
-		LOGD("Enabling transport %s", uri.c_str());
+		LOGD("Enabling transport %s", url.str().c_str());
 		if (uri.find("sips") == 0) {
 			unsigned int tls_policy = 0;
 
@@ -420,13 +433,17 @@ void Agent::start(const string& transport_override, const string& passphrase) {
 				LOGF("Specifying an URI with transport=tls is not understood in flexisip configuration. Use 'sips' uri "
 				     "scheme instead.");
 			}
-			LOGF("Could not enable transport %s: %s", uri.c_str(), strerror(errno));
+			LOGF("Could not enable transport %s: %s", url.str().c_str(), strerror(errno));
 		}
 		su_home_deinit(&home);
 	}
 
 	/* Setup the internal transport*/
 	if (mPreferredRouteV4 != nullptr) {
+		if (transportPortOffset != 0) {
+			mPreferredRouteV4 =
+			    url_hdup(&mHome, shiftTransportPort(Url{mPreferredRouteV4}, transportPortOffset).get());
+		}
 		if (nta_agent_add_tport(mAgent, (const url_string_t*)mPreferredRouteV4, TPTAG_IDLE(tports_idle_timeout),
 		                        TPTAG_TIMEOUT(incompleteIncomingMessageTimeout), TPTAG_IDENT(sInternalTransportIdent),
 		                        TPTAG_KEEPALIVE(keepAliveInterval), TPTAG_QUEUESIZE(queueSize), TPTAG_SDWN_ERROR(1),
@@ -955,6 +972,55 @@ shared_ptr<Module> Agent::findModuleByFunction(const std::string& moduleFunction
 	return it != mModules.cend() ? *it : nullptr;
 }
 
+void Agent::buildModuleChains() {
+	for (auto& chain : mRequestChains) {
+		chain.clear();
+	}
+	for (auto& chain : mResponseChains) {
+		chain.clear();
+	}
+
+	for (const auto& module : mModules) {
+		if (!module->isEnabled()) continue;
+		const auto requestMethods = module->getHandledRequestMethods();
+		const auto responseMethods = module->getHandledResponseMethods();
+		for (int method = sip_method_unknown; method <= sip_method_publish; ++method) {
+			if (requestMethods.contains(static_cast<sip_method_t>(method))) mRequestChains[method].push_back(module);
+			if (responseMethods.contains(static_cast<sip_method_t>(method))) mResponseChains[method].push_back(module);
+		}
+	}
+}
+
+static size_t chainIndex(sip_method_t method) {
+	return method < sip_method_unknown || method > sip_method_publish ? sip_method_unknown : method;
+}
+
+const vector<shared_ptr<Module>>& Agent::getRequestChain(const sip_t* sip) const {
+	return mRequestChains[chainIndex(sip->sip_request ? sip->sip_request->rq_method : sip_method_unknown)];
+}
+
+const vector<shared_ptr<Module>>& Agent::getResponseChain(const sip_t* sip) const {
+	return mResponseChains[chainIndex(sip->sip_cseq ? sip->sip_cseq->cs_method : sip_method_unknown)];
+}
+
+/*
+ * Find where to resume the processing of an event in a module chain, i.e. after currModule.
+ */
+template <typename ModuleChain>
+static typename ModuleChain::const_iterator findNextInChain(const ModuleChain& chain,
+                                                            const list<shared_ptr<Module>>& modules,
+                                                            const shared_ptr<Module>& currModule) {
+	auto it = find(chain.cbegin(), chain.cend(), currModule);
+	if (it != chain.cend()) return ++it;
+
+	// currModule has been disabled since it took the event, resume at the first chained module placed after it.
+	const auto next = find(modules.cbegin(), modules.cend(), currModule);
+	if (next == modules.cend()) return chain.cend();
+	return find_if(chain.cbegin(), chain.cend(), [&](const auto& module) {
+		return find(std::next(next), modules.cend(), module) != modules.cend();
+	});
+}
+
 template <typename SipEventT, typename ModuleIter>
 void Agent::doSendEvent(std::shared_ptr<SipEventT> ev, const ModuleIter& begin, const ModuleIter& end) {
 	for (auto it = begin; it != end; ++it) {
@@ -1013,7 +1079,8 @@ void Agent::sendRequestEvent(shared_ptr<RequestSipEvent> ev) {
 			break;
 	}
 
-	doSendEvent(ev, mModules.begin(), mModules.end());
+	const auto& chain = getRequestChain(sip);
+	doSendEvent(ev, chain.cbegin(), chain.cend());
 }
 
 void Agent::sendResponseEvent(const shared_ptr<ResponseSipEvent>& ev) {
@@ -1073,7 +1140,8 @@ void Agent::sendResponseEvent(const shared_ptr<ResponseSipEvent>& ev) {
 			break;
 	}
 
-	doSendEvent(ev, mModules.begin(), mModules.end());
+	const auto& chain = getResponseChain(sip);
+	doSendEvent(ev, chain.cbegin(), chain.cend());
 }
 
 void Agent::injectRequestEvent(const shared_ptr<RequestSipEvent>& ev) {
@@ -1082,8 +1150,8 @@ void Agent::injectRequestEvent(const shared_ptr<RequestSipEvent>& ev) {
 	SLOGD << "Inject request SIP event [" << ev << "] after " << currModule->getModuleName() << ":\n"
 	      << *ev->getMsgSip();
 	ev->restartProcessing();
-	auto it = find(mModules.cbegin(), mModules.cend(), currModule);
-	doSendEvent(ev, ++it, mModules.cend());
+	const auto& chain = getRequestChain(ev->getMsgSip()->getSip());
+	doSendEvent(ev, findNextInChain(chain, mModules, currModule), chain.cend());
 	printEventTailSeparator();
 }
 
@@ -1093,8 +1161,8 @@ void Agent::injectResponseEvent(const shared_ptr<ResponseSipEvent>& ev) {
 	SLOGD << "Injecting response SIP event [" << ev << "] after " << currModule->getModuleName() << ":\n"
 	      << *ev->getMsgSip();
 	ev->restartProcessing();
-	auto it = find(mModules.cbegin(), mModules.cend(), currModule);
-	doSendEvent(ev, ++it, mModules.cend());
+	const auto& chain = getResponseChain(ev->getMsgSip()->getSip());
+	doSendEvent(ev, findNextInChain(chain, mModules, currModule), chain.cend());
 	printEventTailSeparator();
 }
 
@@ -1125,12 +1193,12 @@ int Agent::onIncomingMessage(msg_t* msg, const sip_t* sip) {
 		return -1;
 	}
 	// Assuming sip is derived from msg
-	auto ms = make_shared<MsgSip>(ownership::owned(msg));
+	auto ms = makePooled<MsgSip>(ownership::owned(msg));
 	if (sip->sip_request) {
-		auto ev = make_shared<RequestSipEvent>(shared_from_this(), ms, getIncomingTport(ms->getMsg()));
+		auto ev = makePooled<RequestSipEvent>(shared_from_this(), ms, getIncomingTport(ms->getMsg()));
 		sendRequestEvent(ev);
 	} else {
-		auto ev = make_shared<ResponseSipEvent>(shared_from_this(), ms, getIncomingTport(msg));
+		auto ev = makePooled<ResponseSipEvent>(shared_from_this(), ms, getIncomingTport(msg));
 		sendResponseEvent(ev);
 	}
 	printEventTailSeparator();
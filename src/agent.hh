@@ -18,10 +18,12 @@
 
 #pragma once
 
+#include <array>
 #include <ifaddrs.h>
 #include <memory>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #if defined(HAVE_CONFIG_H) && !defined(FLEXISIP_INCLUDED)
 #include "flexisip-config.h"
@@ -130,7 +132,12 @@ public:
 	      const std::shared_ptr<AuthDb>& authDb,
 	      const std::shared_ptr<RegistrarDb>& registrarDb);
 
-	void start(const std::string& transport_override, const std::string& passphrase);
+	/**
+	 * Bind the SIP transports and start processing requests.
+	 * @param transportPortOffset added to the port of every transport (including the internal one). Used by the
+	 * proxy workers spawned when 'global/workers' is greater than 1, so that each of them gets its own ports.
+	 */
+	void start(const std::string& transport_override, const std::string& passphrase, int transportPortOffset = 0);
 	void unloadConfig();
 	~Agent() override;
 	// Add agent and modules sections
@@ -286,6 +293,13 @@ private:
 	void checkAllowedParams(const url_t* uri);
 	void initializePreferredRoute();
 	void loadModules();
+	/**
+	 * Build, for each method, the chains of the enabled modules that may act on requests and responses. Must be
+	 * called each time a module is (re)loaded.
+	 */
+	void buildModuleChains();
+	const std::vector<std::shared_ptr<Module>>& getRequestChain(const sip_t* sip) const;
+	const std::vector<std::shared_ptr<Module>>& getResponseChain(const sip_t* sip) const;
 	void startMdns();
 
 	static int messageCallback(nta_agent_magic_t* context, nta_agent_t* agent, msg_t* msg, sip_t* sip);
@@ -299,6 +313,9 @@ private:
 	const std::shared_ptr<ConfigManager> mConfigManager;
 	const std::shared_ptr<AuthDb> mAuthDb;
 	std::list<std::shared_ptr<Module>> mModules;
+	// Enabled modules from mModules, per request method (resp. response CSeq method). Indexed by sip_method_t.
+	std::array<std::vector<std::shared_ptr<Module>>, sip_method_publish + 1> mRequestChains;
+	std::array<std::vector<std::shared_ptr<Module>>, sip_method_publish + 1> mResponseChains;
 	// Disconnecting the Redis registar DB may trigger callbacks on mModules,
 	// so they must still be alive when dtor()ing it.
 	const std::shared_ptr<RegistrarDb> mRegistrarDb;
@@ -16,11 +16,13 @@
     along with this program. If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
 #include <bitset>
 #include <cstdint>
 #include <regex>
 #include <string_view>
 #include <thread>
+#include <unordered_set>
 
 #include <soci/mysql/soci-mysql.h>
 
@@ -88,6 +90,32 @@ buildSociParamInjecter(std::string_view request) {
 	}
 }
 
+// Add a password read from the database to the passwords of a user.
+// Returns true when the password is in clear text: it then replaces all the others, as every supported hash is derived
+// from it.
+bool addPassword(vector<passwd_algo_t>& passwd,
+                 const string& unescapedId,
+                 const string& domain,
+                 const string& password,
+                 const string& algo) {
+	if (algo == "CLRTXT") {
+		auto input = unescapedId + ":" + domain + ":" + password;
+		passwd.clear();
+		passwd.emplace_back(password, algo);
+		passwd.emplace_back(Md5{}.compute<string>(input), "MD5");
+		passwd.emplace_back(Sha256{}.compute<string>(input), "SHA-256");
+		return true;
+	}
+	passwd.emplace_back(StringUtils::toLower(password), algo);
+	return false;
+}
+
+// The batch request does not take the authorization username into account, it only returns the passwords of users who
+// authenticate with their own username.
+bool isBatchable(const string& id, const string& authid) {
+	return authid == id;
+}
+
 } // namespace
 
 void SociAuthDB::declareConfig(GenericStruct* mc) {
@@ -130,6 +158,21 @@ void SociAuthDB::declareConfig(GenericStruct* mc) {
 	     "\tselect password, 'MD5' from accounts where login = :id and domain = :domain",
 	     "select password, 'MD5' from accounts where login = :id and domain = :domain"},
 
+	    {String, "soci-password-batch-request",
+	     "Soci SQL request used to obtain the passwords of several users of the same domain at once, when many "
+	     "password lookups are waiting for a database connection (e.g. registration storm after a network outage).\n"
+	     "The string MUST contain the ':ids' keyword, which will be replaced by the list of users found in the from "
+	     "headers, each of them being bound as a parameter of the request. The ':domain' keyword will be "
+	     "replaced by the authorization realm. Only the users whose authorization username is their own username "
+	     "are looked up this way, the others still use 'soci-password-request'.\n"
+	     "The request MUST return a three-columns table: the two columns of 'soci-password-request' then the user the "
+	     "password belongs to.\n"
+	     "Leave empty to run 'soci-password-request' for each user.\n"
+	     "\n"
+	     "Example:\n"
+	     "\tselect password, algorithm, login from accounts where login in (:ids) and domain = :domain",
+	     ""},
+
 	    {Integer, "soci-max-queue-size",
 	     "Amount of queries that will be allowed to be queued before bailing password requests.\n"
 	     "This value should be chosen accordingly with 'soci-poolsize', so that you have a coherent behavior.\n"
@@ -196,6 +239,7 @@ SociAuthDB::SociAuthDB(const GenericStruct& cr) : AuthDbBackend(cr) {
 	backend = ma->get<ConfigString>("soci-backend")->read();
 
 	mGetPassword = buildSociParamInjecter(ma->get<ConfigString>("soci-password-request")->read());
+	get_passwords_request = ma->get<ConfigString>("soci-password-batch-request")->read();
 
 	auto max_queue_size = (unsigned int)ma->get<ConfigInt>("soci-max-queue-size")->read();
 
@@ -241,42 +285,146 @@ void SociAuthDB::closeOpenedSessions() {
 	_connected = false;
 }
 
-void SociAuthDB::getPasswordWithPool(const string& id,
-                                     const string& domain,
-                                     const string& authid,
-                                     AuthDbListener* listener) {
+void SociAuthDB::processQueuedLookups() {
+	vector<string> lookupKeys{};
+	string domain{};
+	string id{};
+	string authid{};
+	{
+		const lock_guard<mutex> lock{mLookupsMutex};
+		// The lookup this task was created for may have been handled by the batch of another task
+		if (mQueuedLookups.empty()) return;
+
+		lookupKeys.push_back(std::move(mQueuedLookups.front()));
+		mQueuedLookups.pop_front();
+		const auto& lookup = mPendingLookups.at(lookupKeys.front());
+		domain = lookup.domain;
+		id = lookup.id;
+		authid = lookup.authid;
+		if (!get_passwords_request.empty() && isBatchable(id, authid)) {
+			for (auto it = mQueuedLookups.begin();
+			     it != mQueuedLookups.end() && lookupKeys.size() < kMaxPasswordBatchSize;) {
+				const auto& queuedLookup = mPendingLookups.at(*it);
+				if (queuedLookup.domain != domain || !isBatchable(queuedLookup.id, queuedLookup.authid)) {
+					++it;
+					continue;
+				}
+				lookupKeys.push_back(std::move(*it));
+				it = mQueuedLookups.erase(it);
+			}
+		}
+	}
+
+	try {
+		if (lookupKeys.size() == 1) {
+			const auto passwd = getPasswordWithPool(id, domain, authid);
+			if (!passwd.empty()) cachePassword(createPasswordKey(id, authid), domain, passwd, mCacheExpire);
+			notifyLookupListeners(lookupKeys.front(), passwd.empty() ? PASSWORD_NOT_FOUND : PASSWORD_FOUND, passwd);
+			return;
+		}
+
+		vector<pair<string, string>> users{}; // Lookup key and id (which is also the authid)
+		vector<string> unescapedIds{};
+		{
+			const lock_guard<mutex> lock{mLookupsMutex};
+			for (const auto& lookupKey : lookupKeys) {
+				const auto& lookup = mPendingLookups.at(lookupKey);
+				users.emplace_back(lookupKey, lookup.id);
+				unescapedIds.push_back(urlUnescape(lookup.id));
+			}
+		}
+		SLOGD << "[SOCI] Fetching the passwords of " << users.size() << " users of domain " << domain << " at once";
+		const auto passwords = getPasswordsWithPool(unescapedIds, domain);
+		for (const auto& [lookupKey, userId] : users) {
+			const auto unescapedId = urlUnescape(userId);
+			auto passwd = PwList{};
+			if (const auto found = passwords.find(unescapedId); found != passwords.cend()) {
+				passwd = found->second;
+			} else if (any_of(passwords.cbegin(), passwords.cend(),
+			                  [&unescapedId](const auto& user) { return StringUtils::iequals(user.first, unescapedId); })) {
+				// The database returned the user with another case, as its collation may be case-insensitive. Only
+				// the database can tell whether this is the requested user: ask for this one alone.
+				passwd = getPasswordWithPool(userId, domain, userId);
+			}
+			if (!passwd.empty()) cachePassword(createPasswordKey(userId, userId), domain, passwd, mCacheExpire);
+			notifyLookupListeners(lookupKey, passwd.empty() ? PASSWORD_NOT_FOUND : PASSWORD_FOUND, passwd);
+		}
+	} catch (SociHelper::DatabaseException& e) {
+		for (const auto& lookupKey : lookupKeys) {
+			notifyLookupListeners(lookupKey, AUTH_ERROR, {});
+		}
+	}
+}
+
+AuthDbBackend::PwList SociAuthDB::getPasswordWithPool(const string& id, const string& domain, const string& authid) {
 	vector<passwd_algo_t> passwd{};
 	auto unescapedIdStr = urlUnescape(id);
 
 	SociHelper sociHelper{*conn_pool};
+	sociHelper.execute([&](session& sql) {
+		rowset<row> results = mGetPassword(sql, unescapedIdStr, domain, authid);
+		for (const auto& r : results) {
+			/* If size == 1 then we only have the password so we assume MD5 */
+			auto algo = r.size() > 1 ? r.get<string>(1) : "MD5";
+			if (addPassword(passwd, unescapedIdStr, domain, r.get<string>(0), algo)) break;
+		}
+	});
+	return passwd;
+}
 
-	try {
-		sociHelper.execute([&](session& sql) {
-			rowset<row> results = mGetPassword(sql, unescapedIdStr, domain, authid);
-			for (const auto& r : results) {
-				/* If size == 1 then we only have the password so we assume MD5 */
-				auto algo = r.size() > 1 ? r.get<string>(1) : "MD5";
-				if (algo == "CLRTXT") {
-					const auto& password = r.get<string>(0);
-					auto input = unescapedIdStr + ":" + domain + ":" + password;
-					passwd.clear();
-					passwd.emplace_back(password, algo);
-					passwd.emplace_back(Md5{}.compute<string>(input), "MD5");
-					passwd.emplace_back(Sha256{}.compute<string>(input), "SHA-256");
-					break;
-				} else {
-					auto hash = StringUtils::toLower(r.get<string>(0));
-					passwd.emplace_back(std::move(hash), algo);
-				}
-			}
-		});
+unordered_map<string, AuthDbBackend::PwList> SociAuthDB::getPasswordsWithPool(const vector<string>& ids,
+                                                                              const string& domain) {
+	unordered_map<string, PwList> passwords{};
+	unordered_set<string> clearTextFound{};
+
+	// One bound parameter per user (:id0, :id1...), the ids are never inserted in the request itself.
+	vector<string> idNames{};
+	string idPlaceholders{};
+	for (size_t index = 0; index < ids.size(); ++index) {
+		idNames.push_back("id" + to_string(index));
+		if (!idPlaceholders.empty()) idPlaceholders += ",";
+		idPlaceholders += ":" + idNames.back();
+	}
+	auto request = get_passwords_request;
+	for (auto index = request.find(":ids"); index != string::npos; index = request.find(":ids", index)) {
+		request.replace(index, 4, idPlaceholders);
+		index += idPlaceholders.size();
+	}
+	const auto bindDomain = request.find(":domain") != string::npos;
 
-		if (!passwd.empty()) cachePassword(createPasswordKey(id, authid), domain, passwd, mCacheExpire);
-		if (listener) {
-			listener->onResult(passwd.empty() ? PASSWORD_NOT_FOUND : PASSWORD_FOUND, passwd);
+	SociHelper sociHelper{*conn_pool};
+	const auto readResults = [&](rowset<row> results) {
+		for (const auto& r : results) {
+			const auto id = r.get<string>(2);
+			// A clear text password has already replaced all the others for this user
+			if (clearTextFound.count(id)) continue;
+			if (addPassword(passwords[id], id, domain, r.get<string>(0), r.get<string>(1))) clearTextFound.insert(id);
 		}
-	} catch (SociHelper::DatabaseException& e) {
-		if (listener) listener->onResult(AUTH_ERROR, passwd);
+	};
+	sociHelper.execute([&](session& sql) {
+		passwords.clear();
+		clearTextFound.clear();
+		auto prepared = (sql.prepare << request);
+		for (size_t index = 0; index < ids.size(); ++index) {
+			prepared, use(ids[index], idNames[index]);
+		}
+		if (bindDomain) prepared, use(domain, "domain");
+		readResults(prepared);
+	});
+	return passwords;
+}
+
+void SociAuthDB::notifyLookupListeners(const string& lookupKey, AuthDbResult result, const PwList& passwd) {
+	vector<AuthDbListener*> listeners{};
+	{
+		const lock_guard<mutex> lock{mLookupsMutex};
+		auto lookup = mPendingLookups.find(lookupKey);
+		if (lookup == mPendingLookups.end()) return;
+		listeners = std::move(lookup->second.listeners);
+		mPendingLookups.erase(lookup);
+	}
+	for (auto* listener : listeners) {
+		if (listener) listener->onResult(result, passwd);
 	}
 }
 
@@ -406,15 +554,33 @@ void SociAuthDB::getPasswordFromBackend(const string& id,
 		return;
 	}
 
-	// create a thread to grab a pool connection and use it to retrieve the auth information
-	auto func = bind(&SociAuthDB::getPasswordWithPool, this, id, domain, authid, listener);
+	// Requests for credentials that are already being looked up wait for the result of the pending query
+	const auto lookupKey = createCacheKey(createPasswordKey(id, authid), domain);
+	{
+		const lock_guard<mutex> lock{mLookupsMutex};
+		const auto [lookup, inserted] =
+		    mPendingLookups.try_emplace(lookupKey, PendingLookup{id, domain, authid, {listener}});
+		if (!inserted) {
+			lookup->second.listeners.push_back(listener);
+			return;
+		}
+		mQueuedLookups.push_back(lookupKey);
+	}
 
-	bool success = thread_pool->run(func);
+	// create a thread to grab a pool connection and use it to retrieve the auth information
+	bool success = thread_pool->run([this] { processQueuedLookups(); });
 	if (!success) {
 		// Enqueue() can fail when the queue is full, so we have to act on that
 		SLOGE << "[SOCI] Auth queue is full, cannot fullfil password request for " << id << " / " << domain << " / "
 		      << authid;
-		if (listener) listener->onResult(AUTH_ERROR, PwList());
+		{
+			const lock_guard<mutex> lock{mLookupsMutex};
+			const auto queued = find(mQueuedLookups.begin(), mQueuedLookups.end(), lookupKey);
+			// Already taken by the batch of a running task, which will notify the listeners
+			if (queued == mQueuedLookups.end()) return;
+			mQueuedLookups.erase(queued);
+		}
+		notifyLookupListeners(lookupKey, AUTH_ERROR, PwList());
 	}
 }
 
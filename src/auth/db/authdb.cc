@@ -105,26 +105,40 @@ string AuthDbBackend::createPasswordKey(string_view user, string_view auth_usern
 	return urlUnescape(user) + "#" + urlUnescape(auth_username);
 }
 
+// Domains cannot contain a '/', so this is unambiguous.
+string AuthDbBackend::createCacheKey(const string& key, const string& domain) {
+	return domain + "/" + key;
+}
+
+AuthDbBackend::PasswordCacheShard& AuthDbBackend::getPasswordCacheShard(const string& cacheKey) {
+	return mCachedPasswords[hash<string>{}(cacheKey) % mCachedPasswords.size()];
+}
+
 AuthDbBackend::CacheResult
 AuthDbBackend::getCachedPassword(const string& key, const string& domain, vector<passwd_algo_t>& pass) {
 	time_t now = getCurrentTime();
-	auto& passwords = mCachedPasswords[domain];
-	unique_lock<mutex> lck(mCachedPasswordMutex);
-	auto it = passwords.find(key);
-	if (it != passwords.end()) {
+	const auto cacheKey = createCacheKey(key, domain);
+	auto& shard = getPasswordCacheShard(cacheKey);
+	{
+		shared_lock<shared_mutex> lck(shard.mutex);
+		auto it = shard.passwords.find(cacheKey);
+		if (it == shard.passwords.end()) return NO_PASS_FOUND;
 		pass = it->second.pass;
-		if (now < it->second.expire_date) {
-			return VALID_PASS_FOUND;
-		} else {
-			passwords.erase(it);
-			return EXPIRED_PASS_FOUND;
-		}
+		if (now < it->second.expire_date) return VALID_PASS_FOUND;
 	}
-	return NO_PASS_FOUND;
+
+	unique_lock<shared_mutex> lck(shard.mutex);
+	// The entry may have been refreshed in the meantime
+	auto it = shard.passwords.find(cacheKey);
+	if (it != shard.passwords.end() && it->second.expire_date <= now) shard.passwords.erase(it);
+	return EXPIRED_PASS_FOUND;
 }
 
 void AuthDbBackend::clearCache() {
-	mCachedPasswords.clear();
+	for (auto& shard : mCachedPasswords) {
+		unique_lock<shared_mutex> lck(shard.mutex);
+		shard.passwords.clear();
+	}
 }
 
 bool AuthDbBackend::cachePassword(const string& key,
@@ -133,15 +147,16 @@ bool AuthDbBackend::cachePassword(const string& key,
                                   int expires) {
 	if (pass.empty()) throw invalid_argument("empty password list");
 	time_t now = getCurrentTime();
-	map<string, CachedPassword>& passwords = mCachedPasswords[domain];
-	unique_lock<mutex> lck(mCachedPasswordMutex);
-	map<string, CachedPassword>::iterator it = passwords.find(key);
 	if (expires == -1) expires = mCacheExpire;
-	if (it != passwords.end()) {
+	const auto cacheKey = createCacheKey(key, domain);
+	auto& shard = getPasswordCacheShard(cacheKey);
+	unique_lock<shared_mutex> lck(shard.mutex);
+	auto it = shard.passwords.find(cacheKey);
+	if (it != shard.passwords.end()) {
 		it->second.pass = pass;
 		it->second.expire_date = now + expires;
 	} else {
-		passwords.insert(make_pair(key, CachedPassword(pass, now + expires)));
+		shard.passwords.emplace(cacheKey, CachedPassword(pass, now + expires));
 	}
 	return true;
 }
@@ -20,12 +20,16 @@
 
 #include <stdio.h>
 
+#include <array>
+#include <deque>
 #include <functional>
 #include <map>
 #include <mutex>
 #include <set>
+#include <shared_mutex>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "flexisip/configmanager.hh"
@@ -114,6 +118,8 @@ protected:
 
 	static std::string urlUnescape(std::string_view str);
 	static std::string createPasswordKey(std::string_view user, std::string_view auth);
+	// Key identifying the credentials of a user across all domains
+	static std::string createCacheKey(const std::string& key, const std::string& domain);
 
 	int mCacheExpire;
 
@@ -125,6 +131,17 @@ private:
 		}
 	};
 
+	// The password cache is split into independently locked shards, so that concurrent lookups of different users
+	// rarely contend, and lookups of cached passwords (the most frequent operation) only take a shared lock.
+	static constexpr std::size_t kPasswordCacheShardCount = 16;
+	struct PasswordCacheShard {
+		std::shared_mutex mutex;
+		// Cached passwords by domain and password key (see createCacheKey())
+		std::unordered_map<std::string, CachedPassword> passwords;
+	};
+
+	PasswordCacheShard& getPasswordCacheShard(const std::string& cacheKey);
+
 	struct ListenerToFunctionWrapper : public AuthDbListener {
 	public:
 		ListenerToFunctionWrapper() = default;
@@ -138,8 +155,7 @@ private:
 		ResultCb mCb;
 	};
 
-	std::map<std::string, std::map<std::string, CachedPassword>> mCachedPasswords;
-	std::mutex mCachedPasswordMutex;
+	std::array<PasswordCacheShard, kPasswordCacheShardCount> mCachedPasswords;
 	std::mutex mCachedUserWithPhoneMutex;
 	std::map<std::string, std::string> mPhone2User;
 };
@@ -310,15 +326,30 @@ public:
 	SociAuthDB(const GenericStruct&);
 
 private:
+	// Maximum number of users whose passwords are fetched by a single 'soci-password-batch-request' query
+	static constexpr std::size_t kMaxPasswordBatchSize = 100;
+
+	/**
+	 * A password lookup waiting for its query to complete. All the concurrent requests of the same credentials are
+	 * attached to the same lookup, so that only one query is sent to the database.
+	 */
+	struct PendingLookup {
+		std::string id;
+		std::string domain;
+		std::string authid;
+		std::vector<AuthDbListener*> listeners;
+	};
+
 	void connectDatabase();
 	void closeOpenedSessions();
 
 	void getUserWithPhoneWithPool(const std::string& phone, const std::string& domain, AuthDbListener* listener);
 	void getUsersWithPhonesWithPool(std::list<std::tuple<std::string, std::string, AuthDbListener*>>& creds);
-	void getPasswordWithPool(const std::string& id,
-	                         const std::string& domain,
-	                         const std::string& authid,
-	                         AuthDbListener* listener);
+	void processQueuedLookups();
+	PwList getPasswordWithPool(const std::string& id, const std::string& domain, const std::string& authid);
+	std::unordered_map<std::string, PwList> getPasswordsWithPool(const std::vector<std::string>& ids,
+	                                                             const std::string& domain);
+	void notifyLookupListeners(const std::string& lookupKey, AuthDbResult result, const PwList& passwd);
 
 	void notifyAllListeners(std::list<std::tuple<std::string, std::string, AuthDbListener*>>& creds,
 	                        const std::set<std::pair<std::string, std::string>>& presences);
@@ -331,6 +362,7 @@ private:
 	std::string get_user_with_phone_request;
 	std::string get_users_with_phones_request;
 	std::string get_password_algo_request;
+	std::string get_passwords_request;
 	// Get user password with soci using admin-provided query string.
 	// Will bind only known parameters detected in the query string
 	std::function<soci::rowset<soci::row>(soci::session&, const std::string&, const std::string&, const std::string&)>
@@ -338,6 +370,12 @@ private:
 	bool check_domain_in_presence_results = false;
 	bool _connected = false;
 
+	std::mutex mLookupsMutex;
+	// In-flight password lookups, by domain and password key
+	std::unordered_map<std::string, PendingLookup> mPendingLookups;
+	// Keys of the lookups of mPendingLookups whose query has not been started yet
+	std::deque<std::string> mQueuedLookups;
+
 	friend AuthDbBackend;
 };
 
@@ -20,15 +20,25 @@
 
 namespace flexisip::b2bua {
 
-AsyncStopCore::AsyncStopCore(const std::shared_ptr<linphone::Core>& core) : mCore(core) {
-	if (mCore->getGlobalState() != linphone::GlobalState::Off) mCore->stopAsync();
+AsyncStopCore::AsyncStopCore(const std::shared_ptr<linphone::Core>& core)
+    : AsyncStopCore(std::vector<std::shared_ptr<linphone::Core>>{core}) {
 }
 
-bool AsyncStopCore::finished() {
-	if (mCore->getGlobalState() == linphone::GlobalState::Off) return true;
+AsyncStopCore::AsyncStopCore(std::vector<std::shared_ptr<linphone::Core>>&& cores) : mCores(std::move(cores)) {
+	for (const auto& core : mCores) {
+		if (core->getGlobalState() != linphone::GlobalState::Off) core->stopAsync();
+	}
+}
 
-	mCore->iterate();
-	return mCore->getGlobalState() == linphone::GlobalState::Off;
+bool AsyncStopCore::finished() {
+	auto finished = true;
+	for (const auto& core : mCores) {
+		if (core->getGlobalState() == linphone::GlobalState::Off) continue;
+
+		core->iterate();
+		finished = finished && core->getGlobalState() == linphone::GlobalState::Off;
+	}
+	return finished;
 }
 
 } // namespace flexisip::b2bua
@@ -19,6 +19,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "linphone++/linphone.hh"
 
@@ -26,15 +27,16 @@
 
 namespace flexisip::b2bua {
 
-/// Instructs the linphone::Core to shutdown and iterates it until it reaches linphone::GlobalState::Off
+/// Instructs the linphone::Core(s) to shutdown and iterates them until they all reach linphone::GlobalState::Off
 class AsyncStopCore : public AsyncCleanup {
 public:
 	AsyncStopCore(const std::shared_ptr<linphone::Core>&);
+	AsyncStopCore(std::vector<std::shared_ptr<linphone::Core>>&&);
 
 	bool finished() override;
 
 private:
-	std::shared_ptr<linphone::Core> mCore;
+	std::vector<std::shared_ptr<linphone::Core>> mCores;
 };
 
 } // namespace flexisip::b2bua
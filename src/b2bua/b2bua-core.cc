@@ -33,7 +33,7 @@ namespace flexisip::b2bua {
 
 using namespace std;
 
-shared_ptr<B2buaCore> B2buaCore::create(linphone::Factory& factory, const GenericStruct& config) {
+shared_ptr<B2buaCore> B2buaCore::create(linphone::Factory& factory, const GenericStruct& config, int portOffset) {
 	const auto& configLinphone = factory.createConfig("");
 	configLinphone->setBool("misc", "conference_server_enabled", true);
 	configLinphone->setInt("misc", "max_calls", 1000);
@@ -151,6 +151,8 @@ shared_ptr<B2buaCore> B2buaCore::create(linphone::Factory& factory, const Generi
 			auto listeningPort = stoi(urlTransport.getPort(true));
 			if (listeningPort == 0) {
 				listeningPort = LC_SIP_TRANSPORT_RANDOM;
+			} else {
+				listeningPort += portOffset;
 			}
 			if (scheme == "sip") {
 				if (transportParam.empty() || transportParam == "udp") {
@@ -36,7 +36,8 @@ public:
 	B2buaCore() = delete;
 
 	// Instanciate and configure a linphone::Core for use in a B2BUA
-	static std::shared_ptr<B2buaCore> create(linphone::Factory&, const GenericStruct&);
+	// portOffset is added to the port of the 'transport' parameter (unless it is random), see the 'workers' parameter
+	static std::shared_ptr<B2buaCore> create(linphone::Factory&, const GenericStruct&, int portOffset = 0);
 };
 
 } // namespace flexisip::b2bua
@@ -18,11 +18,14 @@
 
 #include "b2bua-server.hh"
 
+#include <chrono>
+#include <future>
 #include <memory>
 
 #include <mediastreamer2/ms_srtp.h>
 
 #include "flexisip/logmanager.hh"
+#include "flexisip/sofia-wrapper/timer.hh"
 
 #include "b2bua/async-stop-core.hh"
 #include "sip-bridge/sip-bridge.hh"
@@ -33,20 +36,25 @@ using namespace std;
 using namespace linphone;
 
 namespace flexisip {
-namespace {
-shared_ptr<linphone::Call> kEmptyCall{};
-} // namespace
 
-const shared_ptr<linphone::Call>& B2buaServer::getPeerCall(const shared_ptr<linphone::Call>& call) const {
+shared_ptr<linphone::Call> B2buaServer::getPeerCall(const shared_ptr<linphone::Call>& call) const {
 	const auto callId = call->getCallLog()->getCallId();
+	const lock_guard<mutex> lock{mPeersMutex};
 	const auto peerCallEntry = mPeerCalls.find(callId);
 	if (peerCallEntry == mPeerCalls.cend()) {
 		SLOGW << "b2bua server hasn't found the peer call of callId " << callId;
-		return kEmptyCall;
+		return nullptr;
 	}
 	return peerCallEntry->second;
 }
 
+b2bua::Application& B2buaServer::getApplication(const shared_ptr<linphone::Core>& core) const {
+	for (const auto& worker : mWorkers) {
+		if (worker->core == core) return *worker->application;
+	}
+	return *mApplication;
+}
+
 B2buaServer::B2buaServer(const shared_ptr<sofiasip::SuRoot>& root, const std::shared_ptr<ConfigManager>& cfg)
     : ServiceServer(root), mConfigManager(cfg), mCli("b2bua", cfg, root) {
 }
@@ -54,7 +62,7 @@ B2buaServer::B2buaServer(const shared_ptr<sofiasip::SuRoot>& root, const std::sh
 B2buaServer::~B2buaServer() {
 }
 
-void B2buaServer::onCallStateChanged(const shared_ptr<linphone::Core>&,
+void B2buaServer::onCallStateChanged(const shared_ptr<linphone::Core>& core,
                                      const shared_ptr<linphone::Call>& call,
                                      linphone::Call::State state,
                                      const string&) {
@@ -66,12 +74,12 @@ void B2buaServer::onCallStateChanged(const shared_ptr<linphone::Core>&,
 			      << " from " << call->getRemoteAddress()->asString();
 			// Create outgoing call using parameters created from the incoming call in order to avoid duplicating the
 			// callId
-			auto outgoingCallParams = mCore->createCallParams(call);
+			auto outgoingCallParams = core->createCallParams(call);
 			// add this custom header so this call will not be intercepted by the b2bua
 			// TODO(jabiru) rename to x-flexisip-b2bua to be RFC compliant OR get rid of it entirely
 			outgoingCallParams->addCustomHeader(kCustomHeader, "ignore");
 
-			const auto callee = Match(mApplication->onCallCreate(*call, *outgoingCallParams))
+			const auto callee = Match(getApplication(core).onCallCreate(*call, *outgoingCallParams))
 			                        .against([](shared_ptr<const linphone::Address> callee) { return callee; },
 			                                 [&call](linphone::Reason&& reason) {
 				                                 call->decline(reason);
@@ -80,17 +88,17 @@ void B2buaServer::onCallStateChanged(const shared_ptr<linphone::Core>&,
 			if (callee == nullptr) return;
 
 			// create a conference and attach it
-			auto conferenceParams = mCore->createConferenceParams(nullptr);
+			auto conferenceParams = core->createConferenceParams(nullptr);
 			conferenceParams->setHidden(true); // Hide conference to prevent the contact address from being updated
 			conferenceParams->enableVideo(true);
 			conferenceParams->enableLocalParticipant(false); // b2bua core is not part of it
 			conferenceParams->enableOneParticipantConference(true);
 			conferenceParams->setConferenceFactoryAddress(nullptr);
 
-			auto conference = mCore->createConferenceWithParams(conferenceParams);
+			auto conference = core->createConferenceWithParams(conferenceParams);
 
 			// create legB and add it to the conference
-			auto legB = mCore->inviteAddressWithParams(callee, outgoingCallParams);
+			auto legB = core->inviteAddressWithParams(callee, outgoingCallParams);
 			if (!legB) {
 				// E.g. TLS is not supported
 				SLOGE << "Could not establish bridge call. Please check your config.";
@@ -103,6 +111,7 @@ void B2buaServer::onCallStateChanged(const shared_ptr<linphone::Core>&,
 			conference->addParticipant(call);
 
 			// store each peer call
+			const lock_guard<mutex> lock{mPeersMutex};
 			mPeerCalls[call->getCallLog()->getCallId()] = legB;
 			mPeerCalls[legB->getCallLog()->getCallId()] = call;
 		} break;
@@ -134,7 +143,7 @@ void B2buaServer::onCallStateChanged(const shared_ptr<linphone::Core>&,
 			    (peerCall->getState() == linphone::Call::State::IncomingReceived ||
 			     peerCall->getState() == linphone::Call::State::IncomingEarlyMedia)) {
 				SLOGD << "b2bua server leg B running -> answer legA";
-				auto incomingCallParams = mCore->createCallParams(peerCall);
+				auto incomingCallParams = core->createCallParams(peerCall);
 				// add this custom header so this call will not be intercepted by the b2bua
 				incomingCallParams->addCustomHeader(kCustomHeader, "ignore");
 				// enforce same video/audio enable to legA than on legB - manage video rejected by legB
@@ -147,7 +156,7 @@ void B2buaServer::onCallStateChanged(const shared_ptr<linphone::Core>&,
 				SLOGD << "b2bua server onCallStateChanged: peer call defered update, accept it now";
 				// update is defered only on video/audio add remove
 				// create call params for peer call and copy video/audio enabling settings from this call
-				auto peerCallParams = mCore->createCallParams(peerCall);
+				auto peerCallParams = core->createCallParams(peerCall);
 				peerCallParams->enableVideo(call->getCurrentParams()->videoEnabled());
 				peerCallParams->enableAudio(call->getCurrentParams()->audioEnabled());
 				peerCall->acceptUpdate(peerCallParams);
@@ -157,7 +166,7 @@ void B2buaServer::onCallStateChanged(const shared_ptr<linphone::Core>&,
 				if (peerCallAudioDirection == linphone::MediaDirection::SendOnly ||
 				    peerCallAudioDirection == linphone::MediaDirection::Inactive) {
 					SLOGD << "b2bua server onCallStateChanged: peer call is paused, update it to resume";
-					auto peerCallParams = mCore->createCallParams(peerCall);
+					auto peerCallParams = core->createCallParams(peerCall);
 					peerCallParams->setAudioDirection(linphone::MediaDirection::SendRecv);
 					peerCall->update(peerCallParams);
 				}
@@ -174,7 +183,7 @@ void B2buaServer::onCallStateChanged(const shared_ptr<linphone::Core>&,
 		case linphone::Call::State::Error:
 			// when call in error we shall kill the conf, just do as in End
 		case linphone::Call::State::End: {
-			mApplication->onCallEnd(*call);
+			getApplication(core).onCallEnd(*call);
 			// terminate peer Call, copy error info from this call
 			const auto& peerCall = getPeerCall(call);
 			if (peerCall) peerCall->terminateWithErrorInfo(call->getErrorInfo());
@@ -193,11 +202,11 @@ void B2buaServer::onCallStateChanged(const shared_ptr<linphone::Core>&,
 				return;
 			}
 
-			const auto peerCallAudioDirection = mCore->createCallParams(peerCall)->getAudioDirection();
+			const auto peerCallAudioDirection = core->createCallParams(peerCall)->getAudioDirection();
 			// Nothing to do if peer call is already not sending audio
 			if (peerCallAudioDirection != linphone::MediaDirection::Inactive &&
 			    peerCallAudioDirection != linphone::MediaDirection::SendOnly) {
-				const auto peerCallParams = mCore->createCallParams(peerCall);
+				const auto peerCallParams = core->createCallParams(peerCall);
 				peerCallParams->setAudioDirection(linphone::MediaDirection::SendOnly);
 				peerCall->update(peerCallParams);
 			}
@@ -206,7 +215,7 @@ void B2buaServer::onCallStateChanged(const shared_ptr<linphone::Core>&,
 			// Manage add/remove video - ignore for other changes
 			const auto& peerCall = getPeerCall(call);
 			if (!peerCall) return;
-			auto peerCallParams = mCore->createCallParams(peerCall);
+			auto peerCallParams = core->createCallParams(peerCall);
 			const auto selfCallParams = call->getCurrentParams();
 			const auto selfRemoteCallParams = call->getRemoteParams();
 			bool updatePeerCall = false;
@@ -239,6 +248,7 @@ void B2buaServer::onCallStateChanged(const shared_ptr<linphone::Core>&,
 		case linphone::Call::State::Released: {
 			// If there are some data in that call, it is the first one to end
 			const auto callId = call->getCallLog()->getCallId();
+			const lock_guard<mutex> lock{mPeersMutex};
 			const auto peerCallEntry = mPeerCalls.find(callId);
 			if (peerCallEntry != mPeerCalls.cend()) {
 				mPeerCalls.erase(peerCallEntry);
@@ -279,7 +289,7 @@ void B2buaServer::onSubscribeReceived(const std::shared_ptr<linphone::Core>& cor
 		return;
 	}
 
-	const auto subscriber = Match(mApplication->onSubscribe(*legAEvent, subscribeEvent))
+	const auto subscriber = Match(getApplication(core).onSubscribe(*legAEvent, subscribeEvent))
 	                            .against([](shared_ptr<const linphone::Address> subscriber) { return subscriber; },
 	                                     [&legAEvent](linphone::Reason&& reason) {
 		                                     legAEvent->denySubscription(reason);
@@ -302,6 +312,7 @@ void B2buaServer::onSubscribeReceived(const std::shared_ptr<linphone::Core>& cor
 	}
 
 	// Store a shared pointer to each event
+	const lock_guard<mutex> lock{mPeersMutex};
 	mPeerEvents[legAEvent->getCallId()] = {.peerEvent = legBEvent, .isLegA = true};
 	mPeerEvents[legBEvent->getCallId()] = {.peerEvent = legAEvent, .isLegA = false};
 	legAEvent->addListener(shared_from_this());
@@ -309,16 +320,20 @@ void B2buaServer::onSubscribeReceived(const std::shared_ptr<linphone::Core>& cor
 
 void B2buaServer::onSubscribeStateChanged(const std::shared_ptr<linphone::Event>& event,
                                           linphone::SubscriptionState state) {
-	const auto eventEntry = mPeerEvents.find(event->getCallId());
-	if (eventEntry == mPeerEvents.cend()) return;
-	const auto& eventInfo = eventEntry->second;
+	EventInfo eventInfo{};
+	{
+		const lock_guard<mutex> lock{mPeersMutex};
+		const auto eventEntry = mPeerEvents.find(event->getCallId());
+		if (eventEntry == mPeerEvents.cend()) return;
+		eventInfo = eventEntry->second;
+	}
 	if (eventInfo.isLegA) {
 		if (state == linphone::SubscriptionState::Terminated) {
 			// Un-SUBSCRIBE from the subscriber
 			eventInfo.peerEvent->terminate();
-			const auto peerEventEntry = mPeerEvents.find(eventInfo.peerEvent->getCallId());
-			if (peerEventEntry != mPeerEvents.cend()) mPeerEvents.erase(peerEventEntry);
-			mPeerEvents.erase(eventEntry);
+			const lock_guard<mutex> lock{mPeersMutex};
+			mPeerEvents.erase(eventInfo.peerEvent->getCallId());
+			mPeerEvents.erase(event->getCallId());
 		}
 	} else {
 		if (state == linphone::SubscriptionState::Active) {
@@ -336,13 +351,18 @@ void B2buaServer::onSubscribeStateChanged(const std::shared_ptr<linphone::Event>
 // subscription.
 void B2buaServer::onNotifyReceived(const std::shared_ptr<linphone::Event>& event,
                                    const std::shared_ptr<const linphone::Content>& content) {
-	auto eventEntry = mPeerEvents.find(event->getCallId());
-	if (eventEntry == mPeerEvents.cend()) {
-		SLOGE << "No data associated to the event, can't forward the NOTIFY";
-		return;
+	shared_ptr<linphone::Event> peerEvent{};
+	{
+		const lock_guard<mutex> lock{mPeersMutex};
+		const auto eventEntry = mPeerEvents.find(event->getCallId());
+		if (eventEntry == mPeerEvents.cend()) {
+			SLOGE << "No data associated to the event, can't forward the NOTIFY";
+			return;
+		}
+		peerEvent = eventEntry->second.peerEvent;
 	}
 	// Forward NOTIFY
-	eventEntry->second.peerEvent->notify(content);
+	peerEvent->notify(content);
 }
 
 // MWI listener on the core.
@@ -354,7 +374,7 @@ void B2buaServer::onMessageWaitingIndicationChanged(
 
 	// Try to create a temporary account configured with the correct outbound proxy to be able to bridge the received
 	// NOTIFY.
-	const auto destination = mApplication->onNotifyToBeSent(*legBEvent);
+	const auto destination = getApplication(core).onNotifyToBeSent(*legBEvent);
 	if (!destination) return;
 	const auto& [subscriber, accountUsedToSendNotify] = *destination;
 
@@ -396,11 +416,22 @@ void B2buaServer::_init() {
 
 	mCore->addListener(shared_from_this());
 
+	const auto workers = config->get<ConfigInt>("workers")->read();
+	if (workers < 1) {
+		LOGF("'%s' must be at least 1", config->get<ConfigInt>("workers")->getCompleteName().c_str());
+	}
+	if (workers > 1 && stoi(SipUri{config->get<ConfigString>("transport")->read()}.getPort(true)) == 0) {
+		// The proxy reaches worker i on the port of the transport + i, a random port cannot be shared with it.
+		LOGF("'%s' cannot be a random port (0) when there are several workers",
+		     config->get<ConfigString>("transport")->getCompleteName().c_str());
+	}
 	auto applicationType = config->get<ConfigString>("application")->read();
-	SLOGD << "B2BUA server starting with '" << applicationType << "' application";
+	SLOGD << "B2BUA server starting with '" << applicationType << "' application and " << workers << " worker(s)";
 	if (applicationType == "trenscrypter") {
 		mApplication = make_unique<b2bua::trenscrypter::Trenscrypter>();
 	} else if (applicationType == "sip-bridge") {
+		// The accounts of the bridge are shared between all the calls, they cannot be split between several cores.
+		if (workers != 1) LOGF("The 'sip-bridge' B2BUA application does not support more than one worker");
 		auto bridge = make_unique<b2bua::bridge::SipBridge>(mRoot, mCore);
 		mCli.registerHandler(*bridge);
 		mApplication = std::move(bridge);
@@ -409,7 +440,31 @@ void B2buaServer::_init() {
 	}
 	mApplication->init(mCore, *mConfigManager);
 
+	// Additional cores, only created when the application is the trenscrypter (see above)
+	for (auto index = 1; index < workers; ++index) {
+		auto& worker = *mWorkers.emplace_back(make_unique<Worker>());
+		worker.core = b2bua::B2buaCore::create(*factory, *config, index);
+		worker.core->addListener(shared_from_this());
+		worker.application = make_unique<b2bua::trenscrypter::Trenscrypter>();
+		worker.application->init(worker.core, *mConfigManager);
+	}
+
 	mCore->start();
+	for (auto& worker : mWorkers) {
+		worker->core->start();
+		// The core is not thread-safe: from now on, it is only used from this thread until it is joined.
+		promise<sofiasip::SuRoot*> rootReady{};
+		auto root = rootReady.get_future();
+		worker->thread = thread([&core = *worker->core, &rootReady]() {
+			sofiasip::SuRoot root{};
+			// Same iteration period as the main core (see ServiceServer::init())
+			sofiasip::Timer timer{root.getCPtr(), 10ms};
+			timer.setForEver([&core]() { core.iterate(); });
+			rootReady.set_value(&root);
+			root.run();
+		});
+		worker->root = root.get();
+	}
 	mCli.start();
 }
 
@@ -420,9 +475,21 @@ void B2buaServer::_run() {
 std::unique_ptr<AsyncCleanup> B2buaServer::_stop() {
 	if (mCore == nullptr) return nullptr;
 
-	mCore->removeListener(shared_from_this());
+	vector<shared_ptr<linphone::Core>> cores{mCore};
+	for (auto& worker : mWorkers) {
+		if (worker->thread.joinable()) {
+			// The main loop of the worker must be broken from its own thread.
+			worker->root->addToMainLoop([root = worker->root]() { root->quit(); });
+			worker->thread.join();
+			worker->root = nullptr;
+		}
+		cores.push_back(worker->core);
+	}
+	for (const auto& core : cores) {
+		core->removeListener(shared_from_this());
+	}
 	mCli.stop();
-	return std::make_unique<b2bua::AsyncStopCore>(mCore);
+	return std::make_unique<b2bua::AsyncStopCore>(std::move(cores));
 }
 
 namespace {
@@ -506,6 +573,15 @@ auto& defineConfig = ConfigManager::defaultInit().emplace_back([](GenericStruct&
 	        "Same as 'audio-codec' but for video.",
 	        "",
 	    },
+	    {
+	        Integer,
+	        "workers",
+	        "Number of cores among which the B2BUA spreads the calls it bridges, each of them being run on its own "
+	        "thread. Worker i (starting from 0) listens on the port of the 'transport' parameter + i, so these ports must "
+	        "be available and the port of 'transport' cannot be random (0) when there are several workers. Set the 'workers' parameter of module::B2bua to the same value so that the proxy dispatches "
+	        "the calls between them. Only the 'trenscrypter' application supports more than one worker.",
+	        "1",
+	    },
 	    {
 	        Boolean,
 	        "one-connection-per-account",
@@ -19,8 +19,11 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 #include <variant>
+#include <vector>
 
 #include "b2bua/b2bua-core.hh"
 #include "linphone++/linphone.hh"
@@ -139,11 +142,26 @@ protected:
 	std::unique_ptr<AsyncCleanup> _stop() override;
 
 private:
-	const std::shared_ptr<linphone::Call>& getPeerCall(const std::shared_ptr<linphone::Call>& call) const;
+	/**
+	 * Additional core iterated on its own thread, so that the B2BUA can bridge calls on several CPU cores.
+	 * Worker i listens on the port of the 'transport' parameter + i.
+	 */
+	struct Worker {
+		std::shared_ptr<b2bua::B2buaCore> core;
+		std::unique_ptr<b2bua::Application> application;
+		// Main loop of the thread, iterating the core. Only valid while the thread runs.
+		sofiasip::SuRoot* root = nullptr;
+		std::thread thread;
+	};
+
+	std::shared_ptr<linphone::Call> getPeerCall(const std::shared_ptr<linphone::Call>& call) const;
+	b2bua::Application& getApplication(const std::shared_ptr<linphone::Core>& core) const;
 
 	std::shared_ptr<ConfigManager> mConfigManager;
 	CommandLineInterface mCli;
 	std::shared_ptr<b2bua::B2buaCore> mCore;
+	// Peer calls and events of all the cores, guarded by mPeersMutex as they are accessed from the workers threads.
+	mutable std::mutex mPeersMutex;
 	std::unordered_map<std::string, std::shared_ptr<linphone::Call>> mPeerCalls;
 	struct EventInfo {
 		std::shared_ptr<linphone::Event> peerEvent;
@@ -151,6 +169,7 @@ private:
 	};
 	std::unordered_map<std::string, EventInfo> mPeerEvents;
 	std::unique_ptr<b2bua::Application> mApplication = nullptr;
+	std::vector<std::unique_ptr<Worker>> mWorkers;
 };
 
 } // namespace flexisip
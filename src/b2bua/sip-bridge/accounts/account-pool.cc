@@ -62,11 +62,11 @@ AccountPool::AccountPool(const std::shared_ptr<sofiasip::SuRoot>& suRoot,
 }
 
 void AccountPool::initialLoad() {
-	const auto accountsDesc = mLoader->initialLoad();
-	reserve(accountsDesc.size());
-	for (const auto& accountDesc : accountsDesc) {
-		setupNewAccount(accountDesc);
-	}
+	mLoader->loadByBatches(kInitialLoadBatchSize, [this](vector<config::v2::Account>&& accountsDesc) {
+		for (const auto& accountDesc : accountsDesc) {
+			setupNewAccount(accountDesc);
+		}
+	});
 	mAccountsQueuedForRegistration = true;
 }
 
@@ -74,6 +74,26 @@ void AccountPool::setupNewAccount(const config::v2::Account& accountDesc) {
 	if (accountDesc.uri.empty()) {
 		LOGF("An account of account pool '%s' is missing a `uri` field", mPoolName.c_str());
 	}
+
+	// The linphone::Account is only instantiated (and added to the core) when it is first needed: at registration time,
+	// or when the account is selected for a call if it does not need to register.
+	auto account = make_shared<Account>([this, accountDesc]() { return createLinphoneAccount(accountDesc); },
+	                                    mMaxCallsPerLine, accountDesc.alias);
+	if (mAccountParams->registerEnabled()) {
+		mRegistrationQueue.enqueue(std::move(account));
+		return;
+	}
+
+	const auto address = mCore->createAddress(accountDesc.uri);
+	if (!address) {
+		SLOGE << "AccountPool::setupNewAccount : invalid uri [" << accountDesc.uri << "] in pool '" << mPoolName
+		      << "'";
+		return;
+	}
+	try_emplace(address->asStringUriOnly(), accountDesc.alias, account);
+}
+
+shared_ptr<linphone::Account> AccountPool::createLinphoneAccount(const config::v2::Account& accountDesc) const {
 	const auto accountParams = mAccountParams->clone();
 	const auto address = mCore->createAddress(accountDesc.uri);
 	accountParams->setIdentityAddress(address);
@@ -82,19 +102,17 @@ void AccountPool::setupNewAccount(const config::v2::Account& accountDesc) {
 
 	handlePassword(accountDesc, address);
 
-	auto account = make_shared<Account>(mCore->createAccount(accountParams), mMaxCallsPerLine, accountDesc.alias);
-	mRegistrationQueue.enqueue(std::move(account));
+	const auto linphoneAccount = mCore->createAccount(accountParams);
+	if (mCore->addAccount(linphoneAccount) != 0) {
+		SLOGE << "Adding new Account to core failed for uri [" << accountDesc.uri << "]";
+	}
+	return linphoneAccount;
 }
 
 void AccountPool::addNewAccount(const shared_ptr<Account>& account) {
 	const auto& linphoneAccount = account->getLinphoneAccount();
 	const auto& uri = linphoneAccount->getParams()->getIdentityAddress();
 
-	if (mCore->addAccount(linphoneAccount) != 0) {
-		SLOGE << "Adding new Account to core failed for uri [" << uri << "]";
-		return;
-	}
-
 	const auto& alias = account->getAlias();
 	if (!try_emplace(uri->asStringUriOnly(), alias.str(), account)) {
 		mCore->removeAccount(linphoneAccount);
@@ -179,11 +197,6 @@ std::shared_ptr<Account> AccountPool::getAccountRandomly() const {
 	return nullptr;
 }
 
-void AccountPool::reserve(size_t sizeToReserve) {
-	mAccountsByUri.reserve(sizeToReserve);
-	mAccountsByAlias.reserve(sizeToReserve);
-}
-
 bool AccountPool::try_emplace(const string& uri, const string& alias, const shared_ptr<Account>& account) {
 	if (uri.empty()) {
 		SLOGE << "AccountPool::try_emplace called with empty uri, nothing happened";
@@ -227,7 +240,9 @@ void AccountPool::onAccountUpdate(const std::string& uri, const std::optional<co
 			return;
 		}
 
-		mCore->removeAccount(accountByUriIt->second->getLinphoneAccount());
+		if (accountByUriIt->second->isInstantiated()) {
+			mCore->removeAccount(accountByUriIt->second->getLinphoneAccount());
+		}
 
 		mAccountsByAlias.erase(accountByUriIt->second->getAlias().str());
 		mAccountsByUri.erase(uri);
@@ -263,6 +278,13 @@ void AccountPool::onAccountUpdate(const std::string& uri, const std::optional<co
 		}
 	}
 
+	if (!updatedAccount->isInstantiated()) {
+		// Do not create the linphone::Account now, it will be created from the updated description when first needed.
+		updatedAccount->setLinphoneAccountFactory(
+		    [this, accountDesc = *accountToUpdate]() { return createLinphoneAccount(accountDesc); });
+		return;
+	}
+
 	const auto accountParams = mAccountParams->clone();
 	const auto address = mCore->createAddress(accountToUpdate->uri);
 	accountParams->setIdentityAddress(address);
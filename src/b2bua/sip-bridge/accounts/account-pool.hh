@@ -70,13 +70,16 @@ public:
 	void onDisconnect(int status) override;
 
 private:
+	// Number of accounts requested at once from the loader during the initial load
+	static constexpr std::size_t kInitialLoadBatchSize = 1000;
+
 	void initialLoad();
 
-	void reserve(size_t sizeToReserve);
 	bool try_emplace(const std::string& uri, const std::string& alias, const std::shared_ptr<Account>& account);
 	bool try_emplaceAlias(const std::string& alias, const std::shared_ptr<Account>& account);
 
 	void setupNewAccount(const config::v2::Account& accountDesc);
+	std::shared_ptr<linphone::Account> createLinphoneAccount(const config::v2::Account& accountDesc) const;
 	void addNewAccount(const std::shared_ptr<Account>&);
 	void handleOutboundProxy(const std::shared_ptr<linphone::AccountParams>& accountParams,
 	                         const std::string& outboundProxy) const;
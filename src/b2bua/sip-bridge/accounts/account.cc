@@ -25,10 +25,18 @@ Account::Account(const std::shared_ptr<linphone::Account>& account, uint16_t fre
     : account(account), freeSlots(freeSlots), mAlias(alias) {
 }
 
+Account::Account(LinphoneAccountFactory&& accountFactory, uint16_t freeSlots, std::string_view alias)
+    : mAccountFactory(std::move(accountFactory)), freeSlots(freeSlots), mAlias(alias) {
+}
+
 bool Account::isAvailable() const {
 	if (freeSlots == 0) {
 		return false;
 	}
+	// Only accounts that do not need to register are instantiated lazily
+	if (account == nullptr) {
+		return true;
+	}
 	if (account->getParams()->registerEnabled() && account->getState() != linphone::RegistrationState::Ok) {
 		return false;
 	}
@@ -36,6 +44,10 @@ bool Account::isAvailable() const {
 }
 
 const std::shared_ptr<linphone::Account>& Account::getLinphoneAccount() const {
+	if (account == nullptr && mAccountFactory) {
+		account = mAccountFactory();
+		mAccountFactory = nullptr;
+	}
 	return account;
 }
 const SipUri& Account::getAlias() const {
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 
 #include "linphone++/linphone.hh"
@@ -28,13 +29,29 @@ namespace flexisip::b2bua::bridge {
 
 class Account {
 public:
+	// Creates the linphone::Account, called the first time it is needed
+	using LinphoneAccountFactory = std::function<std::shared_ptr<linphone::Account>()>;
+
 	Account(const std::shared_ptr<linphone::Account>& account, uint16_t freeSlots, std::string_view alias);
+	/**
+	 * Lazily created account: the linphone::Account is only instantiated on the first call to getLinphoneAccount().
+	 */
+	Account(LinphoneAccountFactory&& accountFactory, uint16_t freeSlots, std::string_view alias);
 
 	// Move constructor
 	Account(Account&& other) = default;
 
 	bool isAvailable() const;
 	const std::shared_ptr<linphone::Account>& getLinphoneAccount() const;
+	bool isInstantiated() const {
+		return account != nullptr;
+	}
+	/**
+	 * Replace the factory of an account that is not instantiated yet, so that it is created from up-to-date parameters.
+	 */
+	void setLinphoneAccountFactory(LinphoneAccountFactory&& accountFactory) {
+		mAccountFactory = std::move(accountFactory);
+	}
 	uint16_t getFreeSlotsCount() const;
 
 	const SipUri& getAlias() const;
@@ -50,7 +67,8 @@ private:
 	Account(const Account&) = delete;
 	Account& operator=(const Account&) = delete;
 
-	std::shared_ptr<linphone::Account> account;
+	mutable std::shared_ptr<linphone::Account> account;
+	mutable LinphoneAccountFactory mAccountFactory{};
 	uint16_t freeSlots = 0;
 	SipUri mAlias{};
 };
@@ -29,6 +29,7 @@ namespace flexisip::b2bua::bridge {
 
 using OnAccountUpdateCB =
     std::function<void(const std::string& uri, const std::optional<config::v2::Account>& accountToUpdate)>;
+using OnAccountsBatchCB = std::function<void(std::vector<config::v2::Account>&& accounts)>;
 
 class Loader {
 public:
@@ -37,6 +38,14 @@ public:
 
 	virtual std::vector<config::v2::Account> initialLoad() = 0;
 
+	/**
+	 * Load all the accounts and hand them over by batches of at most batchSize accounts, so that they never have to be
+	 * all held in memory at once. The default implementation hands over the result of initialLoad() in a single batch.
+	 */
+	virtual void loadByBatches([[maybe_unused]] std::size_t batchSize, const OnAccountsBatchCB& onBatch) {
+		onBatch(initialLoad());
+	}
+
 	virtual void accountUpdateNeeded(const RedisAccountPub& redisAccountPub, const OnAccountUpdateCB& cb) = 0;
 };
 } // namespace flexisip::b2bua::bridge
@@ -18,6 +18,8 @@
 
 #include "sql-account-loader.hh"
 
+#include <limits>
+
 #include <soci/session.h>
 
 #include "soci-helper.hh"
@@ -49,17 +51,29 @@ SQLAccountLoader::SQLAccountLoader(const std::shared_ptr<sofiasip::SuRoot>& suRo
 
 std::vector<config::v2::Account> SQLAccountLoader::initialLoad() {
 	std::vector<config::v2::Account> accountsLoaded{};
+	// Unbounded batch: everything is handed over at once
+	loadByBatches(numeric_limits<size_t>::max(),
+	              [&accountsLoaded](auto&& accounts) { accountsLoaded = std::move(accounts); });
+
+	return accountsLoaded;
+}
+
+void SQLAccountLoader::loadByBatches(std::size_t batchSize, const OnAccountsBatchCB& onBatch) {
 	SociHelper helper{mSociConnectionPool};
-	helper.execute([&initQuery = mInitQuery, &accountsLoaded](auto& sql) {
+	helper.execute([&initQuery = mInitQuery, batchSize, &onBatch](auto& sql) {
+		std::vector<config::v2::Account> batch{};
 		config::v2::Account account;
 		soci::statement statement = (sql.prepare << initQuery, into(account));
 		statement.execute();
 		while (statement.fetch()) {
-			accountsLoaded.push_back(account);
+			batch.push_back(account);
+			if (batch.size() < batchSize) continue;
+
+			onBatch(std::move(batch));
+			batch = {};
 		}
+		if (!batch.empty()) onBatch(std::move(batch));
 	});
-
-	return accountsLoaded;
 }
 
 void SQLAccountLoader::accountUpdateNeeded(const RedisAccountPub& redisAccountPub, const OnAccountUpdateCB& cb) {
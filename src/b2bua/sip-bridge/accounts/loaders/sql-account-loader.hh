@@ -35,6 +35,7 @@ public:
 	explicit SQLAccountLoader(const std::shared_ptr<sofiasip::SuRoot>& suRoot, const config::v2::SQLLoader& loaderConf);
 
 	std::vector<config::v2::Account> initialLoad() override;
+	void loadByBatches(std::size_t batchSize, const OnAccountsBatchCB& onBatch) override;
 
 	void accountUpdateNeeded(const RedisAccountPub& redisAccountPub, const OnAccountUpdateCB& cb) override;
 
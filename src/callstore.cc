@@ -132,7 +132,7 @@ CallContextBase::~CallContextBase() {
 	}
 }
 
-CallStore::CallStore() : mCountCalls(NULL), mCountCallsFinished(NULL) {
+CallStore::CallStore() : mNextInactivityCheck(mCalls.end()), mCountCalls(NULL), mCountCallsFinished(NULL) {
 }
 
 CallStore::~CallStore() {
@@ -141,62 +141,101 @@ CallStore::~CallStore() {
 void CallStore::store(const shared_ptr<CallContextBase> &ctx) {
 	if (mCountCalls)
 		++(*mCountCalls);
-	mCalls.push_back(ctx);
+	mCallsByCallId[ctx->getCallHash()].push_back(mCalls.insert(mCalls.end(), ctx));
+}
+
+const vector<CallStore::CallList::iterator> *CallStore::getCallsWithCallId(sip_t *sip) const {
+	if (sip->sip_call_id == NULL)
+		return NULL;
+	auto calls = mCallsByCallId.find(sip->sip_call_id->i_hash);
+	return calls != mCallsByCallId.end() ? &calls->second : NULL;
+}
+
+void CallStore::erase(CallList::iterator it) {
+	auto calls = mCallsByCallId.find((*it)->getCallHash());
+	if (calls != mCallsByCallId.end()) {
+		auto &sameCallId = calls->second;
+		sameCallId.erase(std::remove(sameCallId.begin(), sameCallId.end(), it), sameCallId.end());
+		if (sameCallId.empty())
+			mCallsByCallId.erase(calls);
+	}
+	if (mNextInactivityCheck == it)
+		++mNextInactivityCheck;
+	mCalls.erase(it);
 }
 
 shared_ptr<CallContextBase> CallStore::find(Agent *ag, sip_t *sip, bool match_call_id_only) {
-	for (auto it = mCalls.begin(); it != mCalls.end(); ++it) {
-		if ((*it)->match(ag, sip, match_call_id_only))
-			return *it;
+	if (const auto *calls = getCallsWithCallId(sip)) {
+		for (const auto &it : *calls) {
+			if ((*it)->match(ag, sip, match_call_id_only))
+				return *it;
+		}
 	}
 	return shared_ptr<CallContextBase>();
 }
 
 shared_ptr<CallContextBase> CallStore::findEstablishedDialog(Agent *ag, sip_t *sip) {
-	for (auto it = mCalls.begin(); it != mCalls.end(); ++it) {
-		if ((*it)->match(ag, sip, false, true))
-			return *it;
+	if (const auto *calls = getCallsWithCallId(sip)) {
+		for (const auto &it : *calls) {
+			if ((*it)->match(ag, sip, false, true))
+				return *it;
+		}
 	}
 	return shared_ptr<CallContextBase>();
 }
 
 void CallStore::findAndRemoveExcept(Agent *ag, sip_t *sip, const shared_ptr<CallContextBase> &ctx, bool stateful) {
-	int removed = 0;
-	for (auto it = mCalls.begin(); it != mCalls.end();) {
-		if (*it != ctx && (*it)->match(ag, sip, stateful)) {
-			if (mCountCallsFinished)
-				++(*mCountCallsFinished);
-			LOGD("CallStore::findAndRemoveExcept() removing CallContext %p", ctx.get());
-			it = mCalls.erase(it);
-			++removed;
-		} else
-			++it;
+	const auto *calls = getCallsWithCallId(sip);
+	if (calls == NULL) {
+		LOGD("Removed 0 maching call contexts from store");
+		return;
+	}
+	vector<CallList::iterator> matching;
+	for (const auto &it : *calls) {
+		if (*it != ctx && (*it)->match(ag, sip, stateful))
+			matching.push_back(it);
+	}
+	for (const auto &it : matching) {
+		if (mCountCallsFinished)
+			++(*mCountCallsFinished);
+		LOGD("CallStore::findAndRemoveExcept() removing CallContext %p", ctx.get());
+		erase(it);
 	}
-	LOGD("Removed %d maching call contexts from store", removed);
+	LOGD("Removed %zu maching call contexts from store", matching.size());
 }
 
 void CallStore::remove(const shared_ptr<CallContextBase> &ctx) {
-	auto it = std::find(mCalls.begin(), mCalls.end(), ctx);
-	if (it != mCalls.end()) {
+	auto calls = mCallsByCallId.find(ctx->getCallHash());
+	if (calls == mCallsByCallId.end())
+		return;
+	auto it = std::find_if(calls->second.begin(), calls->second.end(),
+						   [&ctx](const CallList::iterator &call) { return *call == ctx; });
+	if (it != calls->second.end()) {
 		LOGD("CallStore::remove() removing CallContext %p", ctx.get());
 		if (mCountCallsFinished)
 			++(*mCountCallsFinished);
-		(*it)->terminate();
-		mCalls.erase(it);
+		(*(*it))->terminate();
+		erase(*it);
 	}
 }
 
 void CallStore::removeAndDeleteInactives(time_t inactivityPeriod) {
 	time_t cur = getCurrentTime();
-	for (auto it = mCalls.begin(); it != mCalls.end();) {
+	// Only check a slice of the calls each time, resuming where the previous invocation stopped, so that the cost of an
+	// invocation stays bounded however many calls are stored.
+	auto remaining = std::min(mCalls.size(), std::max(kMinInactivityCheckSlice,
+													  (mCalls.size() + kInactivityCheckRounds - 1) / kInactivityCheckRounds));
+	for (; remaining > 0 && !mCalls.empty(); --remaining) {
+		if (mNextInactivityCheck == mCalls.end())
+			mNextInactivityCheck = mCalls.begin();
+		auto it = mNextInactivityCheck++;
 		if ((*it)->getLastActivity() + inactivityPeriod < cur) {
 			LOGD("CallStore::removeAndDeleteInactives() removing CallContext %p", (*it).get());
 			if (mCountCallsFinished)
 				++(*mCountCallsFinished);
 			(*it)->terminate();
-			it = mCalls.erase(it);
-		} else
-			++it;
+			erase(it);
+		}
 	}
 }
 
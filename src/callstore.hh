@@ -19,6 +19,8 @@
 #pragma once
 
 #include <list>
+#include <unordered_map>
+#include <vector>
 
 #include "agent.hh"
 #include "eventlogs/writers/event-log-writer.hh"
@@ -51,6 +53,9 @@ public:
 	uint32_t getViaCount() const {
 		return mViaCount;
 	}
+	uint32_t getCallHash() const {
+		return mCallHash;
+	}
 
 private:
 	su_home_t mHome;
@@ -91,7 +96,22 @@ public:
 	int size();
 
 private:
-	std::list<std::shared_ptr<CallContextBase>> mCalls;
+	using CallList = std::list<std::shared_ptr<CallContextBase>>;
+
+	// removeAndDeleteInactives() checks at least this number of calls at once...
+	static constexpr size_t kMinInactivityCheckSlice = 1000;
+	// ... and checks all the calls over this number of invocations at most.
+	static constexpr size_t kInactivityCheckRounds = 10;
+
+	const std::vector<CallList::iterator>* getCallsWithCallId(sip_t* sip) const;
+	void erase(CallList::iterator it);
+
+	CallList mCalls;
+	// Calls by hash of their Call-ID, in the order they were stored. Only calls with the same Call-ID hash as a message
+	// can match it.
+	std::unordered_map<uint32_t, std::vector<CallList::iterator>> mCallsByCallId;
+	// Next call to check for inactivity
+	CallList::iterator mNextInactivityCheck;
 	StatCounter64* mCountCalls;
 	StatCounter64* mCountCallsFinished;
 };
@@ -20,17 +20,21 @@
 
 #include <cerrno>
 #include <cstring>
+#include <optional>
 
+#include <fcntl.h>
 #include <poll.h>
 #include <stdlib.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
 #include <bctoolbox/ownership.hh>
+#include <sofia-sip/su_wait.h>
 
 #include "flexisip/logmanager.hh"
 #include "flexisip/registrar/registar-listeners.hh"
 #include "flexisip/sofia-wrapper/msg-sip.hh"
+#include "flexisip/sofia-wrapper/timer.hh"
 #include "flexisip/utils/sip-uri.hh"
 
 #include "agent.hh"
@@ -243,6 +247,12 @@ int SocketHandle::send(string_view message) {
 int SocketHandle::recv(char* buffer, size_t length, int flags) {
 	return socket_recv(mHandle, buffer, length, flags);
 }
+void SocketHandle::setNonBlocking() {
+	const auto flags = fcntl(mHandle, F_GETFL);
+	if (flags == -1 || fcntl(mHandle, F_SETFL, flags | O_NONBLOCK) == -1) {
+		SLOGW << "Failed to make CLI socket non-blocking: " << strerror(errno);
+	}
+}
 
 void CommandLineInterface::run() {
 	int server_socket = socket(AF_UNIX, SOCK_STREAM, 0);
@@ -592,24 +602,168 @@ void ProxyCommandLineInterface::handleRegistrarClear(std::shared_ptr<SocketHandl
 	                                    mAgent->getRegistrarDb()));
 }
 
-void ProxyCommandLineInterface::handleRegistrarDump(std::shared_ptr<SocketHandle> socket,
-                                                    [[maybe_unused]] const std::vector<std::string>& args) {
-	list<string> aorList;
+namespace {
 
-	mAgent->getRegistrarDb().getLocalRegisteredAors(aorList);
+// Streams the AoRs of the registrar database to the CLI socket, one JSON object per line (NDJSON). AoRs are sent by
+// pages through the non-blocking socket: the next page is only produced once the previous one has been written and the
+// socket is writable again, so that dumping a large registrar neither blocks the proxy nor the registrar database. The
+// dump is over when the socket is closed.
+class RegistrarDump : public std::enable_shared_from_this<RegistrarDump> {
+public:
+	static constexpr size_t kPageSize = 1000;
+	// Drop the client if that much of the dump is waiting for it to read.
+	static constexpr size_t kMaxPendingSize = 1024 * 1024;
+	// Drop the client if it does not read anything for that long while the socket is full.
+	static constexpr chrono::seconds kStallTimeout{1};
+
+	RegistrarDump(shared_ptr<SocketHandle> socket,
+	              const shared_ptr<sofiasip::SuRoot>& root,
+	              const RegistrarDb& registrarDb,
+	              bool wholeDatabase)
+	    : mSocket(std::move(socket)), mRoot(root), mRegistrarDb(registrarDb), mWholeDatabase(wholeDatabase),
+	      mStallTimer(root, kStallTimeout) {
+		mSocket->setNonBlocking();
+	}
+	~RegistrarDump() {
+		stopWaiting();
+	}
+
+	void nextPage() {
+		if (!mWholeDatabase) {
+			// Local AoRs are walked in lexicographic order, the cursor is the last AoR sent.
+			auto aors = mRegistrarDb.getLocalRegisteredAors(mCursor, kPageSize);
+			const auto last = aors.size() < kPageSize;
+			if (!aors.empty()) mCursor = aors.back();
+			sendPage(aors, last);
+			return;
+		}
 
-	cJSON* root = cJSON_CreateObject();
-	cJSON* contacts = cJSON_CreateArray();
+		mRegistrarDb.scanAors(mCursor, kPageSize, [self = shared_from_this()](optional<AorsPage>&& page) {
+			if (!page) {
+				self->write("Error: failed to walk the registrar database\n", true);
+				return;
+			}
+			self->mCursor = std::move(page->nextCursor);
+			self->sendPage(page->aors, self->mCursor.empty());
+		});
+	}
+
+private:
+	static int onWritable(su_root_magic_t*, su_wait_t*, su_wakeup_arg_t* arg) {
+		// Keep the dump alive: it is only owned by its registered wait.
+		const auto self = static_cast<RegistrarDump*>(arg)->shared_from_this();
+		self->stopWaiting();
+		if (self->mPending.empty()) self->nextPage();
+		else self->flush();
+		return 0;
+	}
+
+	void sendPage(const vector<string>& aors, bool last) {
+		string chunk{};
+		for (const auto& aor : aors) {
+			cJSON* item = cJSON_CreateObject();
+			cJSON_AddStringToObject(item, "aor", aor.c_str());
+			char* jsonOutput = cJSON_PrintUnformatted(item);
+			chunk.append(jsonOutput).append("\n");
+			free(jsonOutput);
+			cJSON_Delete(item);
+		}
+		write(chunk, last);
+	}
 
-	cJSON_AddItemToObject(root, "aors", contacts);
-	for (auto& aor : aorList) {
-		cJSON* pitem = cJSON_CreateString(aor.c_str());
-		cJSON_AddItemToArray(contacts, pitem);
+	void write(string_view chunk, bool last) {
+		mPending.append(chunk);
+		mLast = last;
+		if (mPending.size() > kMaxPendingSize) {
+			drop("the client does not read fast enough");
+			return;
+		}
+		flush();
+	}
+
+	void flush() {
+		while (!mPending.empty()) {
+			const auto sent = mSocket->send(mPending);
+			if (sent < 0) {
+				if (errno != EAGAIN && errno != EWOULDBLOCK) {
+					drop(strerror(errno));
+					return;
+				}
+				// The socket is full, give the client some time to read.
+				if (!mStallTimer.isRunning()) {
+					mStallTimer.set([this] {
+						mRoot->addToMainLoop([self = shared_from_this()] { self->drop("the client stopped reading"); });
+					});
+				}
+				break;
+			}
+			mPending.erase(0, sent);
+			mStallTimer.reset();
+		}
+		if (mPending.empty() && mLast) {
+			mSocket.reset();
+			return;
+		}
+		waitForWritable();
 	}
-	char* jsonOutput = cJSON_Print(root);
-	socket->send(jsonOutput);
-	free(jsonOutput);
-	cJSON_Delete(root);
+
+	void waitForWritable() {
+		if (mWaitIndex) return;
+		su_wait_create(&mWait, mSocket->getHandle(), SU_WAIT_OUT);
+		const auto index = su_root_register(mRoot->getCPtr(), &mWait, onWritable, this, su_pri_normal);
+		if (index < 0) {
+			su_wait_destroy(&mWait);
+			drop("failed to wait for the socket to be writable");
+			return;
+		}
+		mWaitIndex = index;
+		mSelf = shared_from_this();
+	}
+
+	// Callers must hold a reference to the dump, since the registered wait may be the last one.
+	void stopWaiting() {
+		if (!mWaitIndex) return;
+		su_root_deregister(mRoot->getCPtr(), *mWaitIndex);
+		mWaitIndex.reset();
+		mSelf.reset();
+	}
+
+	void drop(string_view reason) {
+		if (!mSocket) return;
+		SLOGW << "REGISTRAR_DUMP: aborting the dump, " << reason;
+		stopWaiting();
+		mStallTimer.reset();
+		mPending.clear();
+		mSocket.reset();
+	}
+
+	shared_ptr<SocketHandle> mSocket;
+	shared_ptr<sofiasip::SuRoot> mRoot;
+	const RegistrarDb& mRegistrarDb;
+	bool mWholeDatabase;
+	string mCursor{};
+	// Part of the dump not written to the socket yet.
+	string mPending{};
+	bool mLast = false;
+	sofiasip::Timer mStallTimer;
+	su_wait_t mWait{};
+	optional<int> mWaitIndex{};
+	shared_ptr<RegistrarDump> mSelf{};
+};
+
+} // namespace
+
+void ProxyCommandLineInterface::handleRegistrarDump(std::shared_ptr<SocketHandle> socket,
+                                                    const std::vector<std::string>& args) {
+	const auto scope = args.empty() ? "local"s : args.front();
+	if (scope != "local" && scope != "all") {
+		socket->send("Error: REGISTRAR_DUMP expects 'local' (AoRs registered on this instance, the default) or 'all' "
+		             "(every AoR of the registrar database) as argument");
+		return;
+	}
+
+	make_shared<RegistrarDump>(std::move(socket), mAgent->getRoot(), mAgent->getRegistrarDb(), scope == "all")
+	    ->nextPage();
 }
 
 void ProxyCommandLineInterface::parseAndAnswer(std::shared_ptr<SocketHandle> socket,
@@ -60,6 +60,11 @@ public:
 
 	int send(std::string_view message);
 	int recv(char*, size_t length, int flags);
+	// Make send() fail with EAGAIN instead of blocking when the peer does not read.
+	void setNonBlocking();
+	int getHandle() const {
+		return mHandle;
+	}
 
 	SocketHandle(SocketHandle&& other);
 
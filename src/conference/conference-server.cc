@@ -18,7 +18,10 @@
 
 #include "conference-server.hh"
 
+#include <algorithm>
 #include <fstream>
+#include <utility>
+#include <vector>
 
 #include <belle-sip/utils.h>
 #include <sofia-sip/sip_header.h>
@@ -394,16 +397,25 @@ void ConferenceServer::bindAddresses() {
 	bindFocusUris();
 
 	if (mMediaConfig.textEnabled) {
-		// Binding loaded chat room
+		// Binding loaded chat rooms, all at once: there may be a lot of them.
+		vector<shared_ptr<const linphone::Address>> focusAddresses{};
+		for (const auto& uris : mConfServerUris) {
+			focusAddresses.emplace_back(linphone::Factory::get()->createAddress(uris.second));
+		}
+		sofiasip::Home home{};
+		const auto* contact = makeChatRoomContact(home, mTransport.str());
+		vector<pair<SipUri, const sip_contact_t*>> chatRoomBindings{};
 		for (const auto& chatRoom : mCore->getChatRooms()) {
-			const auto &peerAddress = chatRoom->getPeerAddress();
+			const auto& peerAddress = chatRoom->getPeerAddress();
 			// If the peer address is not one of the focus uris
-			if (std::find_if(mConfServerUris.cbegin(), mConfServerUris.cend(), [&peerAddress] (const auto &p) {
-				return peerAddress->weakEqual(linphone::Factory::get()->createAddress(p.second));
-			}) == mConfServerUris.cend()) {
-				bindChatRoom(peerAddress->asStringUriOnly(), mTransport.str(), nullptr);
+			if (std::none_of(focusAddresses.cbegin(), focusAddresses.cend(),
+			                 [&peerAddress](const auto& focus) { return peerAddress->weakEqual(focus); })) {
+				SipUri uri(peerAddress->asStringUriOnly());
+				if (uri.getUser().empty()) LOGA("Trying to bind with no username !");
+				chatRoomBindings.emplace_back(std::move(uri), contact);
 			}
 		}
+		mRegistrarDb->bindMany(chatRoomBindings, makeChatRoomBindingParameters(), nullptr);
 	}
 	mAddressesBound = true;
 }
@@ -519,25 +531,31 @@ void ConferenceServer::bindFocusUris() {
 void ConferenceServer::bindChatRoom(const string& bindingUrl,
                                     const string& contact,
                                     const shared_ptr<ContactUpdateListener>& listener) {
-	BindingParameters parameter;
-	const auto gruu = getUuid();
+	sip_contact_t* sipContact = makeChatRoomContact(mHome, contact);
 
-	sip_contact_t* sipContact =
-	    sip_contact_create(mHome.home(), reinterpret_cast<const url_string_t*>(url_make(mHome.home(), contact.c_str())),
-	                       su_strdup(mHome.home(), ("+sip.instance=" + UriUtils::grToUniqueId(gruu)).c_str()), nullptr);
+	SipUri uri(bindingUrl);
 
+	if (uri.getUser().empty()) LOGA("Trying to bind with no username !");
+
+	mRegistrarDb->bind(uri, sipContact, makeChatRoomBindingParameters(), listener);
+}
+
+sip_contact_t* ConferenceServer::makeChatRoomContact(sofiasip::Home& home, const string& contact) {
+	const auto gruu = getUuid();
+	return sip_contact_create(home.home(), reinterpret_cast<const url_string_t*>(url_make(home.home(), contact.c_str())),
+	                          su_strdup(home.home(), ("+sip.instance=" + UriUtils::grToUniqueId(gruu)).c_str()),
+	                          nullptr);
+}
+
+BindingParameters ConferenceServer::makeChatRoomBindingParameters() const {
+	BindingParameters parameter;
 	parameter.callId = "dummy-call-id"; // Mandatory parameter but useless in our case.
 	parameter.path.add(mPath);
 	parameter.globalExpire = numeric_limits<int>::max();
 	parameter.alias = false;
 	parameter.version = 0;
 	parameter.withGruu = true;
-
-	SipUri uri(bindingUrl);
-
-	if (uri.getUser().empty()) LOGA("Trying to bind with no username !");
-
-	mRegistrarDb->bind(uri, sipContact, parameter, listener);
+	return parameter;
 }
 
 namespace {
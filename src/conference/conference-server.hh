@@ -120,6 +120,8 @@ private:
 	const std::string& readUuid();
 	void writeUuid(const std::string& uuid);
 	std::string getUuid();
+	sip_contact_t* makeChatRoomContact(sofiasip::Home& home, const std::string& contact);
+	BindingParameters makeChatRoomBindingParameters() const;
 	std::shared_ptr<linphone::Core> mCore{};
 	std::shared_ptr<RegistrationEvent::ClientFactory> mRegEventClientFactory{};
 	SipUri mPath{};
@@ -727,6 +727,16 @@ ConfigManager::ConfigManager()
 	     "Automatically respawn flexisip in case of abnormal termination (crashes). This has an effect if "
 	     "Flexisip has been launched with '--daemon' option only",
 	     "true"},
+	    {Integer, "workers",
+	     "Number of proxy worker processes spawned by the watchdog. This has an effect if Flexisip has been launched "
+	     "with '--daemon' option and the proxy is the only started server.\n"
+	     "When greater than 1, worker number N (starting from 0) listens on the transports declared in "
+	     "'global/transports' and 'cluster/internal-transport' with their port shifted by N. Incoming traffic "
+	     "must be spread over these ports by DNS SRV records or a front load balancer. In-dialog requests stick to "
+	     "the worker that has record-routed the dialog.\n"
+	     "Workers share their registrations through the registrar database, so 'module::Registrar/db-implementation' "
+	     "must be set to 'redis'.",
+	     "1"},
 	    {String, "plugins-dir", "Path to the directory where plugins can be found.", DEFAULT_PLUGINS_DIR},
 	    {StringList, "plugins",
 	     "Plugins to load. Look at <prefix>/lib/flexisip/plugins to know the list of installed plugin. The name of a "
@@ -30,6 +30,7 @@
 #include "module-toolbox.hh"
 #include "transaction/incoming-transaction.hh"
 #include "transaction/outgoing-transaction.hh"
+#include "utils/pool-allocator.hh"
 #include "utils/socket-address.hh"
 
 using namespace std;
@@ -251,7 +252,7 @@ std::shared_ptr<IncomingTransaction> RequestSipEvent::createIncomingTransaction(
 	auto transaction = dynamic_pointer_cast<IncomingTransaction>(getIncomingAgent());
 	auto sharedAgent = mAgent.lock();
 	if (transaction == nullptr && sharedAgent) {
-		transaction = make_shared<IncomingTransaction>(sharedAgent->getAgent());
+		transaction = makePooled<IncomingTransaction>(sharedAgent->getAgent());
 		SipEvent::setIncomingAgent(transaction);
 		transaction->handle(mMsgSip);
 		linkTransactions();
@@ -263,7 +264,7 @@ std::shared_ptr<OutgoingTransaction> RequestSipEvent::createOutgoingTransaction(
 	auto transaction = dynamic_pointer_cast<OutgoingTransaction>(getOutgoingAgent());
 	auto sharedAgent = mAgent.lock();
 	if (transaction == nullptr && sharedAgent) {
-		transaction = make_shared<OutgoingTransaction>(sharedAgent->getAgent());
+		transaction = makePooled<OutgoingTransaction>(sharedAgent->getAgent());
 		setOutgoingAgent(transaction);
 		linkTransactions();
 	}
@@ -0,0 +1,26 @@
+/** Copyright (C) 2010-2024 Belledonne Communications SARL
+    SPDX-License-Identifier: AGPL-3.0-or-later
+
+	You can set your editor to Lua for this file to get syntax highlighting.
+
+	Brief:
+		Redis script to fetch several Records in a single round-trip.
+
+	KEYS:
+		1: Records to match (usually equal to "fs:*" to match everything)
+		   Only declared for consistency with the other scripts. [string]
+	ARGV:
+		1..n: Redis keys of the Records to fetch (e.g. "fs:user@example.org"). [string]
+
+	Implementation:
+		HGETALL every key and return the replies in the same order as the
+		arguments. A Record that does not exist is returned as an empty array.
+*/
+
+R"lua(
+local records = {}
+for i, key in ipairs(ARGV) do
+	records[i] = redis.call("HGETALL", key)
+end
+return records
+)lua"
@@ -0,0 +1,93 @@
+/** Copyright (C) 2010-2024 Belledonne Communications SARL
+    SPDX-License-Identifier: AGPL-3.0-or-later
+
+	You can set your editor to Lua for this file to get syntax highlighting.
+
+	Brief:
+		Redis script to fetch a Record along with the Records of the aliases
+		it leads to, so that they can be resolved in a single round-trip.
+
+	KEYS:
+		1: Records to match (usually equal to "fs:*" to match everything)
+		   Only declared for consistency with the other scripts. [string]
+	ARGV:
+		1: Redis key of the Record to start from (e.g. "fs:user@example.org"). [string]
+		2: Maximum number of alias levels to follow. [integer]
+		3: Whether Records are keyed on a global domain. ["yes" or "no"]
+		4: Current time, aliases expired at that time are not followed. [Unix timestamp]
+
+	Returns:
+		An array of {key, fields} pairs, one per Record visited, where fields is
+		the reply of HGETALL (empty if the Record does not exist).
+
+	Implementation:
+		Breadth-first walk on the aliases, computing the key of each alias the
+		same way as Record::Key does it from a SIP URI.
+		/!\ Lua string patterns are not POSIX regexps
+*/
+
+R"lua(
+local max_step = tonumber(ARGV[2])
+local use_global_domain = ARGV[3] == "yes"
+local current_time = tonumber(ARGV[4])
+
+local function record_key(contact)
+	local uri = contact:match("<([^>]*)>") or contact
+	uri = uri:match("^%a+:([^;?]*)")
+	if not uri then
+		return nil
+	end
+	local user, host = uri:match("^(.*)@(.*)$")
+	if not user then
+		host = uri
+	end
+	host = host:match("^(%[[^%]]*%])") or host:match("^([^:]*)")
+	if not user or user == "" then
+		return "fs:" .. host
+	end
+	user = user:match("^([^:]*)")
+	if use_global_domain then
+		host = "merged"
+	end
+	return "fs:" .. user .. "@" .. host
+end
+
+local function is_active_alias(contact)
+	if not contact:find(";alias=yes") then
+		return false
+	end
+	local updated_at = tonumber(contact:match("updatedAt=(%d+)"))
+	local expires = tonumber(contact:match("expires=(%d+)"))
+	if not updated_at or not expires then
+		return true
+	end
+	return current_time < updated_at + expires
+end
+
+local records = {}
+local visited = {}
+local current = {ARGV[1]}
+for step = max_step, 0, -1 do
+	local next_level = {}
+	for _, key in ipairs(current) do
+		if not visited[key] then
+			visited[key] = true
+			local fields = redis.call("HGETALL", key)
+			table.insert(records, {key, fields})
+			if step > 0 then
+				for i = 2, #fields, 2 do
+					if is_active_alias(fields[i]) then
+						local alias_key = record_key(fields[i])
+						if alias_key then
+							table.insert(next_level, alias_key)
+						end
+					end
+				end
+			end
+		end
+	end
+	current = next_level
+end
+
+return records
+)lua"
@@ -18,7 +18,6 @@
 
 #include "fork-message-context-db-proxy.hh"
 
-#include "fork-message-context-soci-repository.hh"
 #include "utils/thread/auto-thread-pool.hh"
 
 using namespace std;
@@ -58,7 +57,8 @@ shared_ptr<ForkMessageContextDbProxy> ForkMessageContextDbProxy::make(const shar
 ForkMessageContextDbProxy::ForkMessageContextDbProxy(const std::shared_ptr<ModuleRouter> router,
                                                      sofiasip::MsgSipPriority priority)
     : mForkMessage{}, mState{State::IN_MEMORY}, mProxyLateTimer{router->getAgent()->getRoot()},
-      mCounter{router->mStats.mCountMessageProxyForks}, mSavedRouter{router}, mSavedConfig{router->getMessageForkCfg()},
+      mSavingTimer{router->getAgent()->getRoot()}, mCounter{router->mStats.mCountMessageProxyForks},
+      mSavedRouter{router}, mRepository{router->getForkMessageRepository()}, mSavedConfig{router->getMessageForkCfg()},
       mSavedMsgPriority{priority}, mMaxThreadNumber{getMaxThreadNumber(router->getAgent()->getConfigManager())} {
 
 	LOGD("New ForkMessageContextDbProxy %p", this);
@@ -87,18 +87,18 @@ ForkMessageContextDbProxy::~ForkMessageContextDbProxy() {
 	}
 
 	if (!mForkUuidInDb.empty() && mIsFinished) {
-		// Destructor is called because the ForkContext is finished, removing info from database
+		// Destructor is called because the ForkContext is finished, removing info from database. Nobody waits for it,
+		// so it must not delay the loading of the messages of the devices that are registering.
 		LOGD("ForkMessageContextDbProxy[%p] was present in DB, cleaning UUID[%s]", this, mForkUuidInDb.c_str());
-		AutoThreadPool::getDbThreadPool(mMaxThreadNumber)->run([uuid = mForkUuidInDb]() {
-			ForkMessageContextSociRepository::getInstance()->deleteByUuid(uuid);
-		});
+		AutoThreadPool::getDbThreadPool(mMaxThreadNumber)
+		    ->run([repository = mRepository, uuid = mForkUuidInDb]() { repository->deleteByUuid(uuid); },
+		          ThreadPool::Priority::Low);
 	}
 }
 
 void ForkMessageContextDbProxy::loadFromDb() const {
 	LOGI("ForkMessageContextDbProxy[%p] retrieving message in DB for UUID [%s]", this, mForkUuidInDb.c_str());
-	mDbFork = make_unique<ForkMessageContextDb>(
-	    ForkMessageContextSociRepository::getInstance()->findForkMessageByUuid(mForkUuidInDb));
+	mDbFork = make_unique<ForkMessageContextDb>(mRepository->findForkMessageByUuid(mForkUuidInDb));
 }
 
 bool ForkMessageContextDbProxy::saveToDb(const ForkMessageContextDb& dbFork) {
@@ -106,10 +106,10 @@ bool ForkMessageContextDbProxy::saveToDb(const ForkMessageContextDb& dbFork) {
 	try {
 		if (mForkUuidInDb.empty()) {
 			LOGD("ForkMessageContextDbProxy[%p] not saved before, creating a new entry.", this);
-			mForkUuidInDb = ForkMessageContextSociRepository::getInstance()->saveForkMessageContext(dbFork);
+			mForkUuidInDb = mRepository->saveForkMessageContext(dbFork);
 		} else {
 			LOGD("ForkMessageContextDbProxy[%p] already in DB with UUID[%s], updating", this, mForkUuidInDb.c_str());
-			ForkMessageContextSociRepository::getInstance()->updateForkMessageContext(dbFork, mForkUuidInDb);
+			mRepository->updateForkMessageContext(dbFork, mForkUuidInDb);
 		}
 		if (mForkUuidInDb.empty()) {
 			SLOGE << errorLogPrefix() << "mForkUuidInDb empty after save, keeping message in memory";
@@ -188,6 +188,32 @@ void ForkMessageContextDbProxy::runSavingThread() {
 	    });
 }
 
+void ForkMessageContextDbProxy::scheduleSaving() {
+	if (mSavedConfig->mSaveForkMessageDelay <= 0s) {
+		runSavingThread();
+		return;
+	}
+
+	// Restarted on each response: the fork is only evicted once the recipients stopped answering for a while.
+	mSavingTimer.set(
+	    [weak = weak_ptr<ForkMessageContextDbProxy>{shared_from_this()}]() {
+		    if (auto shared = weak.lock(); shared && shared->canBeSaved()) {
+			    shared->runSavingThread();
+		    }
+	    },
+	    mSavedConfig->mSaveForkMessageDelay);
+}
+
+void ForkMessageContextDbProxy::start() {
+	checkState(__FUNCTION__, State::IN_MEMORY);
+	mForkMessage->start();
+
+	// Without any branch, no response will ever trigger the saving.
+	if (mSavedConfig->mSaveForkMessageDelay > 0s && canBeSaved()) {
+		scheduleSaving();
+	}
+}
+
 void ForkMessageContextDbProxy::onResponse(const shared_ptr<BranchInfo>& br,
                                            const shared_ptr<ResponseSipEvent>& event) {
 	LOGD("ForkMessageContextDbProxy[%p] onResponse", this);
@@ -196,7 +222,7 @@ void ForkMessageContextDbProxy::onResponse(const shared_ptr<BranchInfo>& br,
 	mForkMessage->onResponse(br, event);
 
 	if (canBeSaved()) {
-		runSavingThread();
+		scheduleSaving();
 	}
 }
 
@@ -237,9 +263,10 @@ void ForkMessageContextDbProxy::onNewRegister(const SipUri& dest,
 	}
 
 	// If the ForkMessage is only in database create a thread to access database and then recursively call this method.
+	// A device is waiting for the message: load it before the pending saving and cleaning tasks.
 	if (getState() == State::IN_DATABASE) {
 		LOGD("ForkMessageContext[%p] onNewRegister: message is in DB. Initiating load from DB.", this);
-		AutoThreadPool::getDbThreadPool(mMaxThreadNumber)->run([thiz = shared_from_this(), dest, uid, newContact]() {
+		auto loadFromDbTask = [thiz = shared_from_this(), dest, uid, newContact]() {
 			lock_guard<mutex> lock(thiz->mDbAccessMutex);
 			if (thiz->getState() == State::IN_DATABASE && !thiz->mDbFork) {
 				try {
@@ -264,7 +291,8 @@ void ForkMessageContextDbProxy::onNewRegister(const SipUri& dest,
 			} else {
 				SLOGE << thiz->errorLogPrefix() << " onNewRegister: router missing, this should not happened";
 			}
-		});
+		};
+		AutoThreadPool::getDbThreadPool(mMaxThreadNumber)->run(std::move(loadFromDbTask), ThreadPool::Priority::High);
 
 		return;
 	}
@@ -23,6 +23,7 @@
 #include <string>
 
 #include "fork-context/fork-context-base.hh"
+#include "fork-message-context-repository.hh"
 #include "fork-message-context.hh"
 
 #if ENABLE_UNIT_TESTS
@@ -94,10 +95,7 @@ public:
 		mForkMessage->processInternalError(status, phrase);
 	}
 
-	void start() override {
-		checkState(__FUNCTION__, State::IN_MEMORY);
-		mForkMessage->start();
-	}
+	void start() override;
 
 	void addKey(const std::string& key) override {
 		checkState(__FUNCTION__, State::IN_MEMORY);
@@ -194,6 +192,10 @@ private:
 	 */
 	bool restoreForkIfNeeded();
 	void runSavingThread();
+	/**
+	 * Save the fork right away, or once it has been idle for ForkContextConfig::mSaveForkMessageDelay.
+	 */
+	void scheduleSaving();
 
 	State getState() const;
 	void setState(State mState);
@@ -208,6 +210,7 @@ private:
 	mutable std::atomic_uint mCurrentVersion{1};
 	mutable std::atomic_uint mLastSavedVersion{0};
 	mutable sofiasip::Timer mProxyLateTimer;
+	sofiasip::Timer mSavingTimer;
 	// tuple<host, port, uid>
 	mutable std::set<std::tuple<std::string, std::string, std::string>> mAlreadyDelivered;
 
@@ -216,6 +219,7 @@ private:
 	bool mIsFinished = false;
 
 	std::weak_ptr<ModuleRouter> mSavedRouter;
+	std::shared_ptr<ForkMessageContextRepository> mRepository;
 	std::shared_ptr<ForkContextConfig> mSavedConfig;
 	std::vector<std::string> mSavedKeys{};
 	sofiasip::MsgSipPriority mSavedMsgPriority;
@@ -18,8 +18,12 @@
 
 #pragma once
 
+#include <ctime>
+#include <string>
 #include <vector>
 
+#include "flexisip/sofia-wrapper/msg-sip.hh"
+
 #include "branch-info-db.hh"
 
 namespace flexisip {
@@ -0,0 +1,430 @@
+/*
+    Flexisip, a flexible SIP proxy server with media capabilities.
+    Copyright (C) 2010-2024 Belledonne Communications SARL, All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "fork-message-context-file-store.hh"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "flexisip/logmanager.hh"
+
+using namespace std;
+
+namespace flexisip {
+namespace {
+
+constexpr uint32_t kRecordMagic = 0x31534d46; // "FMS1"
+constexpr auto kSegmentPrefix = "segment-";
+constexpr auto kSegmentSuffix = ".log";
+
+/*
+ * Record layout: magic, type, uuid size, payload size and checksum of uuid + payload (all of them uint32_t in host
+ * byte order), then the uuid and the payload.
+ */
+struct RecordHeader {
+	uint32_t magic;
+	uint32_t type;
+	uint32_t uuidSize;
+	uint32_t payloadSize;
+	uint32_t checksum;
+};
+
+// FNV-1a, only meant to detect records that were partially written before a crash.
+uint32_t checksum(const char* data, size_t size, uint32_t hash = 2166136261u) {
+	for (size_t i = 0; i < size; ++i) {
+		hash = (hash ^ static_cast<uint8_t>(data[i])) * 16777619u;
+	}
+	return hash;
+}
+
+class Writer {
+public:
+	template <typename T>
+	void put(T value) {
+		mBuffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+	void put(const string& value) {
+		put(static_cast<uint32_t>(value.size()));
+		mBuffer.append(value);
+	}
+
+	string mBuffer{};
+};
+
+class Reader {
+public:
+	explicit Reader(const string& buffer) : mBuffer(buffer) {
+	}
+
+	template <typename T>
+	T get() {
+		T value{};
+		memcpy(&value, take(sizeof(value)), sizeof(value));
+		return value;
+	}
+	string getString() {
+		const auto size = get<uint32_t>();
+		return string{take(size), size};
+	}
+
+private:
+	const char* take(size_t size) {
+		if (mBuffer.size() - mPosition < size) throw runtime_error{"truncated fork message record"};
+		const auto* data = mBuffer.data() + mPosition;
+		mPosition += size;
+		return data;
+	}
+
+	const string& mBuffer;
+	size_t mPosition = 0;
+};
+
+string serialize(const ForkMessageContextDb& dbFork) {
+	Writer writer{};
+	auto expirationDate = dbFork.expirationDate;
+	writer.put(dbFork.currentPriority);
+	writer.put(static_cast<int32_t>(dbFork.deliveredCount));
+	writer.put(static_cast<uint8_t>(dbFork.isFinished));
+	writer.put(static_cast<uint8_t>(dbFork.isMessage));
+	writer.put(static_cast<int64_t>(timegm(&expirationDate)));
+	writer.put(dbFork.request);
+	writer.put(static_cast<int32_t>(dbFork.msgPriority));
+	writer.put(static_cast<uint32_t>(dbFork.dbKeys.size()));
+	for (const auto& key : dbFork.dbKeys) {
+		writer.put(key);
+	}
+	writer.put(static_cast<uint32_t>(dbFork.dbBranches.size()));
+	for (const auto& branch : dbFork.dbBranches) {
+		writer.put(branch.contactUid);
+		writer.put(branch.priority);
+		writer.put(branch.request);
+		writer.put(branch.lastResponse);
+		writer.put(static_cast<int32_t>(branch.clearedCount));
+	}
+	return std::move(writer.mBuffer);
+}
+
+ForkMessageContextDb deserialize(const string& uuid, const string& payload) {
+	Reader reader{payload};
+	ForkMessageContextDb dbFork{};
+	dbFork.uuid = uuid;
+	dbFork.currentPriority = reader.get<double>();
+	dbFork.deliveredCount = reader.get<int32_t>();
+	dbFork.isFinished = reader.get<uint8_t>();
+	dbFork.isMessage = reader.get<uint8_t>();
+	const auto expirationDate = static_cast<time_t>(reader.get<int64_t>());
+	gmtime_r(&expirationDate, &dbFork.expirationDate);
+	dbFork.request = reader.getString();
+	dbFork.msgPriority = static_cast<sofiasip::MsgSipPriority>(reader.get<int32_t>());
+	for (auto count = reader.get<uint32_t>(); count > 0; --count) {
+		dbFork.dbKeys.push_back(reader.getString());
+	}
+	for (auto count = reader.get<uint32_t>(); count > 0; --count) {
+		auto& branch = dbFork.dbBranches.emplace_back();
+		branch.contactUid = reader.getString();
+		branch.priority = reader.get<double>();
+		branch.request = reader.getString();
+		branch.lastResponse = reader.getString();
+		branch.clearedCount = reader.get<int32_t>();
+	}
+	return dbFork;
+}
+
+string systemError(const string& message) {
+	return message + ": " + strerror(errno);
+}
+
+} // namespace
+
+ForkMessageContextFileStore::ForkMessageContextFileStore(const filesystem::path& directory, size_t segmentSize)
+    : mDirectory(directory), mSegmentSize(segmentSize) {
+	error_code error{};
+	filesystem::create_directories(mDirectory, error);
+	if (error) {
+		throw runtime_error{"cannot create directory '" + mDirectory.string() + "': " + error.message()};
+	}
+	openSegments();
+	openNewSegment();
+	SLOGI << "ForkMessageContextFileStore - " << mIndex.size() << " fork message(s) found in '" << mDirectory.string()
+	      << "'";
+}
+
+ForkMessageContextFileStore::~ForkMessageContextFileStore() {
+	for (const auto& [id, segment] : mSegments) {
+		close(segment.fd);
+	}
+}
+
+ForkMessageContextDb ForkMessageContextFileStore::findForkMessageByUuid(const string& uuid) {
+	lock_guard<mutex> lock(mMutex);
+	const auto it = mIndex.find(uuid);
+	if (it == mIndex.end()) throw runtime_error{"no fork message with uuid [" + uuid + "]"};
+	return deserialize(uuid, readPayload(uuid, it->second));
+}
+
+vector<ForkMessageContextDb> ForkMessageContextFileStore::findAllForkMessage() {
+	lock_guard<mutex> lock(mMutex);
+	vector<ForkMessageContextDb> allForkMessages{};
+	allForkMessages.reserve(mIndex.size());
+	for (const auto& [uuid, location] : mIndex) {
+		try {
+			auto dbFork = deserialize(uuid, readPayload(uuid, location));
+			// Only keep what is needed to create the proxy objects, the whole fork is read again on restoration.
+			dbFork.request.clear();
+			dbFork.dbBranches.clear();
+			allForkMessages.push_back(std::move(dbFork));
+		} catch (const exception& e) {
+			SLOGE << "ForkMessageContextFileStore - Cannot read fork message [" << uuid << "]: " << e.what();
+		}
+	}
+	sort(allForkMessages.begin(), allForkMessages.end(), [](const auto& lhs, const auto& rhs) {
+		auto lhsDate = lhs.expirationDate;
+		auto rhsDate = rhs.expirationDate;
+		return timegm(&lhsDate) < timegm(&rhsDate);
+	});
+	return allForkMessages;
+}
+
+string ForkMessageContextFileStore::saveForkMessageContext(const ForkMessageContextDb& dbFork) {
+	lock_guard<mutex> lock(mMutex);
+	auto uuid = to_string(mNextUuid++);
+	mIndex.emplace(uuid, append(RecordType::Fork, uuid, serialize(dbFork)));
+	return uuid;
+}
+
+void ForkMessageContextFileStore::updateForkMessageContext(const ForkMessageContextDb& dbFork, const string& uuid) {
+	lock_guard<mutex> lock(mMutex);
+	const auto it = mIndex.find(uuid);
+	if (it == mIndex.end()) throw runtime_error{"no fork message with uuid [" + uuid + "]"};
+	const auto previous = it->second;
+	it->second = append(RecordType::Fork, uuid, serialize(dbFork));
+	release(previous);
+	reclaimSegments();
+}
+
+void ForkMessageContextFileStore::deleteByUuid(const string& uuid) {
+	lock_guard<mutex> lock(mMutex);
+	const auto it = mIndex.find(uuid);
+	if (it == mIndex.end()) return;
+	const auto location = it->second;
+	mIndex.erase(it);
+	// The tombstone prevents the fork from being restored from an older segment when the store is opened again.
+	append(RecordType::Tombstone, uuid, "");
+	release(location);
+	reclaimSegments();
+}
+
+size_t ForkMessageContextFileStore::getForkCount() const {
+	lock_guard<mutex> lock(mMutex);
+	return mIndex.size();
+}
+
+size_t ForkMessageContextFileStore::getSegmentCount() const {
+	lock_guard<mutex> lock(mMutex);
+	return mSegments.size();
+}
+
+void ForkMessageContextFileStore::openSegments() {
+	vector<uint64_t> ids{};
+	for (const auto& entry : filesystem::directory_iterator{mDirectory}) {
+		const auto name = entry.path().filename().string();
+		if (name.rfind(kSegmentPrefix, 0) != 0 || entry.path().extension() != kSegmentSuffix) continue;
+		try {
+			ids.push_back(stoull(name.substr(strlen(kSegmentPrefix))));
+		} catch (const exception&) {
+			SLOGW << "ForkMessageContextFileStore - Ignoring unexpected file '" << entry.path().string() << "'";
+		}
+	}
+	sort(ids.begin(), ids.end());
+
+	for (const auto id : ids) {
+		const auto path = getSegmentPath(id);
+		const auto fd = open(path.c_str(), O_RDWR | O_CLOEXEC);
+		if (fd < 0) throw runtime_error{systemError("cannot open '" + path.string() + "'")};
+		auto& segment = mSegments[id] = Segment{fd, 0, 0, 0};
+		replaySegment(id, segment);
+		mActiveSegment = id;
+	}
+	// Segments made only of dead records or tombstones may be left by a previous run.
+	reclaimSegments();
+}
+
+void ForkMessageContextFileStore::replaySegment(uint64_t id, Segment& segment) {
+	const auto fileSize = lseek(segment.fd, 0, SEEK_END);
+	while (segment.size < fileSize) {
+		RecordHeader header{};
+		string body{};
+		if (pread(segment.fd, &header, sizeof(header), segment.size) == sizeof(header) &&
+		    header.magic == kRecordMagic && header.uuidSize > 0 &&
+		    sizeof(header) + header.uuidSize + header.payloadSize <= size_t(fileSize - segment.size)) {
+			body.resize(header.uuidSize + header.payloadSize);
+			if (pread(segment.fd, body.data(), body.size(), segment.size + sizeof(header)) != ssize_t(body.size()) ||
+			    checksum(body.data(), body.size()) != header.checksum) {
+				body.clear();
+			}
+		}
+		if (body.empty()) {
+			// Most likely a record that was being written when the process stopped: drop the end of the segment.
+			SLOGW << "ForkMessageContextFileStore - Invalid record in '" << getSegmentPath(id).string() << "' at offset "
+			      << segment.size << ", dropping " << fileSize - segment.size << " bytes";
+			if (ftruncate(segment.fd, segment.size) < 0) {
+				SLOGE << "ForkMessageContextFileStore - " << systemError("ftruncate failed");
+			}
+			break;
+		}
+
+		auto uuid = body.substr(0, header.uuidSize);
+		const Location location{id, segment.size, static_cast<uint32_t>(sizeof(header) + body.size())};
+		segment.size += location.size;
+		mNextUuid = max<uint64_t>(mNextUuid, strtoull(uuid.c_str(), nullptr, 10) + 1);
+
+		const auto it = mIndex.find(uuid);
+		if (it != mIndex.end()) {
+			release(it->second);
+			mIndex.erase(it);
+		}
+		if (static_cast<RecordType>(header.type) == RecordType::Fork) {
+			segment.liveRecords++;
+			segment.liveBytes += location.size;
+			mIndex.emplace(std::move(uuid), location);
+		}
+	}
+}
+
+void ForkMessageContextFileStore::openNewSegment() {
+	const auto id = mSegments.empty() ? 1 : mSegments.rbegin()->first + 1;
+	const auto path = getSegmentPath(id);
+	const auto fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+	if (fd < 0) throw runtime_error{systemError("cannot create '" + path.string() + "'")};
+	mSegments[id] = Segment{fd, 0, 0, 0};
+	mActiveSegment = id;
+}
+
+filesystem::path ForkMessageContextFileStore::getSegmentPath(uint64_t id) const {
+	return mDirectory / (kSegmentPrefix + to_string(id) + kSegmentSuffix);
+}
+
+ForkMessageContextFileStore::Location
+ForkMessageContextFileStore::append(RecordType type, const string& uuid, const string& payload) {
+	RecordHeader header{kRecordMagic, static_cast<uint32_t>(type), static_cast<uint32_t>(uuid.size()),
+	                    static_cast<uint32_t>(payload.size()), 0};
+	header.checksum = checksum(payload.data(), payload.size(), checksum(uuid.data(), uuid.size()));
+
+	string record{};
+	record.reserve(sizeof(header) + uuid.size() + payload.size());
+	record.append(reinterpret_cast<const char*>(&header), sizeof(header));
+	record.append(uuid);
+	record.append(payload);
+
+	Location location{};
+	appendRaw(record, location);
+	if (type == RecordType::Fork) {
+		auto& segment = mSegments.at(location.segment);
+		segment.liveRecords++;
+		segment.liveBytes += location.size;
+	}
+	return location;
+}
+
+void ForkMessageContextFileStore::appendRaw(const string& record, Location& location) {
+	if (mSegments.at(mActiveSegment).size > 0 && mSegments.at(mActiveSegment).size + record.size() > mSegmentSize) {
+		// A segment is never written again once full: make sure it reached the disk before moving on.
+		sync(mActiveSegment);
+		openNewSegment();
+	}
+	auto& segment = mSegments.at(mActiveSegment);
+	const auto written = pwrite(segment.fd, record.data(), record.size(), segment.size);
+	if (written != ssize_t(record.size())) {
+		// Do not leave a partial record in the middle of the segment.
+		if (ftruncate(segment.fd, segment.size) < 0) {
+			SLOGE << "ForkMessageContextFileStore - " << systemError("ftruncate failed");
+		}
+		throw runtime_error{systemError("cannot write to '" + getSegmentPath(mActiveSegment).string() + "'")};
+	}
+	location = Location{mActiveSegment, segment.size, static_cast<uint32_t>(record.size())};
+	segment.size += record.size();
+}
+
+void ForkMessageContextFileStore::sync(uint64_t id) const {
+	if (fdatasync(mSegments.at(id).fd) < 0) {
+		SLOGE << "ForkMessageContextFileStore - "
+		      << systemError("fdatasync of '" + getSegmentPath(id).string() + "' failed");
+	}
+}
+
+string ForkMessageContextFileStore::read(const Location& location) const {
+	string record(location.size, '\0');
+	const auto& segment = mSegments.at(location.segment);
+	if (pread(segment.fd, record.data(), record.size(), location.offset) != ssize_t(record.size())) {
+		throw runtime_error{systemError("cannot read from '" + getSegmentPath(location.segment).string() + "'")};
+	}
+	return record;
+}
+
+string ForkMessageContextFileStore::readPayload(const string& uuid, const Location& location) const {
+	return read(location).substr(sizeof(RecordHeader) + uuid.size());
+}
+
+void ForkMessageContextFileStore::release(const Location& location) {
+	auto& segment = mSegments.at(location.segment);
+	segment.liveRecords--;
+	segment.liveBytes -= location.size;
+}
+
+void ForkMessageContextFileStore::reclaimSegments() {
+	// Only the oldest segment may be removed: its tombstones are useless once there is no older segment left.
+	while (mSegments.size() > 1) {
+		auto oldest = mSegments.begin();
+		auto& [id, segment] = *oldest;
+		if (id == mActiveSegment) break;
+		if (segment.liveRecords > 0) {
+			if (segment.liveBytes * 4 > static_cast<size_t>(segment.size)) break;
+
+			SLOGD << "ForkMessageContextFileStore - Moving " << segment.liveRecords << " fork message(s) out of '"
+			      << getSegmentPath(id).string() << "'";
+			for (auto& [uuid, location] : mIndex) {
+				if (location.segment != id) continue;
+				const auto record = read(location);
+				appendRaw(record, location);
+				auto& active = mSegments.at(location.segment);
+				active.liveRecords++;
+				active.liveBytes += location.size;
+			}
+			// The moved records must be on disk before their original copy is removed.
+			sync(mActiveSegment);
+		}
+
+		close(segment.fd);
+		error_code error{};
+		filesystem::remove(getSegmentPath(id), error);
+		if (error) {
+			SLOGE << "ForkMessageContextFileStore - Cannot remove '" << getSegmentPath(id).string()
+			      << "': " << error.message();
+		}
+		mSegments.erase(oldest);
+	}
+}
+
+} // namespace flexisip
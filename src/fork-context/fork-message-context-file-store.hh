@@ -0,0 +1,110 @@
+/*
+    Flexisip, a flexible SIP proxy server with media capabilities.
+    Copyright (C) 2010-2024 Belledonne Communications SARL, All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/types.h>
+
+#include "fork-message-context-repository.hh"
+
+namespace flexisip {
+
+/**
+ * Local on-disk storage of the ForkMessageContexts evicted from memory, for proxies that do not use a message
+ * database.<br>
+ * <br>
+ * Forks are appended to log segment files in a directory and an in-memory index maps each uuid to the location of its
+ * latest record. Updates append a new record and deletions append a tombstone, so that the index can be rebuilt by
+ * replaying the segments in order when the store is opened (e.g. after a restart). A segment is removed once it is
+ * the oldest one and none of its records are live anymore; the live records of a mostly dead oldest segment are
+ * moved to the current segment so that one long-lived fork does not pin a whole segment on disk.<br>
+ * <br>
+ * Records are written to the page cache: they survive a crash of the process but not a crash of the host. A segment is
+ * only flushed to disk (fdatasync) when it is full and before the records moved out of a segment lose their original
+ * copy, so a host crash may lose the forks written since the current segment was opened.
+ */
+class ForkMessageContextFileStore : public ForkMessageContextRepository {
+public:
+	static constexpr std::size_t kDefaultSegmentSize = 64 * 1024 * 1024;
+
+	/**
+	 * Open the store, creating the directory if needed, and index the records of the existing segments.
+	 * @throw std::runtime_error if the directory or one of its segments cannot be opened.
+	 */
+	explicit ForkMessageContextFileStore(const std::filesystem::path& directory,
+	                                     std::size_t segmentSize = kDefaultSegmentSize);
+	ForkMessageContextFileStore(const ForkMessageContextFileStore&) = delete;
+	ForkMessageContextFileStore& operator=(const ForkMessageContextFileStore&) = delete;
+	~ForkMessageContextFileStore() override;
+
+	ForkMessageContextDb findForkMessageByUuid(const std::string& uuid) override;
+	std::vector<ForkMessageContextDb> findAllForkMessage() override;
+	std::string saveForkMessageContext(const ForkMessageContextDb& dbFork) override;
+	void updateForkMessageContext(const ForkMessageContextDb& dbFork, const std::string& uuid) override;
+	void deleteByUuid(const std::string& uuid) override;
+
+	std::size_t getForkCount() const;
+	std::size_t getSegmentCount() const;
+
+private:
+	enum class RecordType : std::uint32_t { Fork = 1, Tombstone = 2 };
+
+	struct Location {
+		std::uint64_t segment;
+		off_t offset;
+		std::uint32_t size; // Size of the whole record, header included.
+	};
+
+	struct Segment {
+		int fd;
+		off_t size;
+		std::size_t liveRecords;
+		std::size_t liveBytes;
+	};
+
+	void openSegments();
+	void replaySegment(std::uint64_t id, Segment& segment);
+	void openNewSegment();
+	std::filesystem::path getSegmentPath(std::uint64_t id) const;
+	void sync(std::uint64_t id) const;
+
+	Location append(RecordType type, const std::string& uuid, const std::string& payload);
+	void appendRaw(const std::string& record, Location& location);
+	std::string read(const Location& location) const;
+	std::string readPayload(const std::string& uuid, const Location& location) const;
+	void release(const Location& location);
+	void reclaimSegments();
+
+	std::filesystem::path mDirectory;
+	std::size_t mSegmentSize;
+	std::map<std::uint64_t, Segment> mSegments{};
+	std::unordered_map<std::string, Location> mIndex{};
+	std::uint64_t mActiveSegment = 0;
+	std::uint64_t mNextUuid = 1;
+	mutable std::mutex mMutex{};
+};
+
+} // namespace flexisip
@@ -0,0 +1,62 @@
+/*
+    Flexisip, a flexible SIP proxy server with media capabilities.
+    Copyright (C) 2010-2024 Belledonne Communications SARL, All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "fork-message-context-db.hh"
+
+namespace flexisip {
+
+/**
+ * Storage of the ForkMessageContexts evicted from memory by ForkMessageContextDbProxy.<br>
+ * <br>
+ * Methods may be called from any thread and may block on I/O, so call them from a thread pool, never from the main
+ * loop.
+ *
+ * @see ForkMessageContextSociRepository
+ * @see ForkMessageContextFileStore
+ */
+class ForkMessageContextRepository {
+public:
+	virtual ~ForkMessageContextRepository() = default;
+
+	/**
+	 * @throw std::exception if the fork cannot be read from the storage.
+	 */
+	virtual ForkMessageContextDb findForkMessageByUuid(const std::string& uuid) = 0;
+
+	/**
+	 * Load minimal information (uuid, expiration date and keys) about all the stored forks to re-create proxy objects
+	 * in database state.
+	 */
+	virtual std::vector<ForkMessageContextDb> findAllForkMessage() = 0;
+
+	/**
+	 * @return the uuid of the new entry.
+	 */
+	virtual std::string saveForkMessageContext(const ForkMessageContextDb& dbFork) = 0;
+
+	virtual void updateForkMessageContext(const ForkMessageContextDb& dbFork, const std::string& uuid) = 0;
+
+	virtual void deleteByUuid(const std::string& uuid) = 0;
+};
+
+} // namespace flexisip
@@ -25,6 +25,7 @@
 #include <soci/session.h>
 #include <soci/sqlite3/soci-sqlite3.h>
 
+#include "fork-message-context-repository.hh"
 #include "fork-message-context.hh"
 
 namespace flexisip {
@@ -34,7 +35,7 @@ namespace flexisip {
  * <br>
  * Instantiating the singleton connect to the database and create/update the schema if it doesn't already exist.
  */
-class ForkMessageContextSociRepository {
+class ForkMessageContextSociRepository : public ForkMessageContextRepository {
 public:
 	/**
 	 * ForkMessageContextSociRepository should not be cloneable.
@@ -55,18 +56,18 @@ public:
 		sNbThreadsMax = nbThreadsMax;
 	}
 
-	ForkMessageContextDb findForkMessageByUuid(const std::string& uuid);
+	ForkMessageContextDb findForkMessageByUuid(const std::string& uuid) override;
 
 	/**
 	 * Load minimal information about all fork_message_context to re-create proxy objects in Database state.
 	 */
-	std::vector<ForkMessageContextDb> findAllForkMessage();
+	std::vector<ForkMessageContextDb> findAllForkMessage() override;
 
-	std::string saveForkMessageContext(const ForkMessageContextDb& dbFork);
+	std::string saveForkMessageContext(const ForkMessageContextDb& dbFork) override;
 
-	void updateForkMessageContext(const ForkMessageContextDb& dbFork, const std::string& uuid);
+	void updateForkMessageContext(const ForkMessageContextDb& dbFork, const std::string& uuid) override;
 
-	void deleteByUuid(const std::string& uuid);
+	void deleteByUuid(const std::string& uuid) override;
 
 #ifdef ENABLE_UNIT_TESTS
 	void deleteAll();
@@ -227,7 +227,7 @@ bool isMessageARCSFileTransferMessage(shared_ptr<RequestSipEvent>& ev) {
 }
 
 bool isConversionFromRcsToExternalBodyUrlNeeded(shared_ptr<ExtendedContact>& ec) {
-	list<string> acceptHeaders = ec->mAcceptHeader;
+	const auto& acceptHeaders = ec->getAcceptHeaders();
 	if (acceptHeaders.size() == 0) {
 		return true;
 	}
@@ -19,7 +19,20 @@ void Script::call(const Session::Ready& session,
                   Session::CommandCallback&& callback) const {
 	auto args = std::make_unique<ArgsPacker>("EVALSHA", mSHA1, "1", "fs:*");
 	args->addArgs(scriptArgs);
+	call(session, std::move(args), std::move(callback));
+}
 
+void Script::call(const Session::Ready& session,
+                  const std::vector<std::string>& scriptArgs,
+                  Session::CommandCallback&& callback) const {
+	auto args = std::make_unique<ArgsPacker>("EVALSHA", mSHA1, "1", "fs:*");
+	args->addArgs(scriptArgs);
+	call(session, std::move(args), std::move(callback));
+}
+
+void Script::call(const Session::Ready& session,
+                  std::unique_ptr<ArgsPacker>&& args,
+                  Session::CommandCallback&& callback) const {
 	auto& argsRef = *args;
 	session.timedCommand(argsRef, [callScriptArgs = std::move(args), callback = std::move(callback),
 	                          this](Session& session, Reply reply) mutable {
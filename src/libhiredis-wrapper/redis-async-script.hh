@@ -5,6 +5,9 @@
 #pragma once
 
 #include <initializer_list>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include "redis-async-session.hh"
 
@@ -26,8 +29,14 @@ public:
 	void call(const async::Session::Ready&,
 	          std::initializer_list<std::string>&& scriptArgs,
 	          async::Session::CommandCallback&&) const;
+	// SAFETY: Same as above
+	void call(const async::Session::Ready&,
+	          const std::vector<std::string>& scriptArgs,
+	          async::Session::CommandCallback&&) const;
 
 private:
+	void call(const async::Session::Ready&, std::unique_ptr<ArgsPacker>&& args, async::Session::CommandCallback&&) const;
+
 	const char* mSource;
 	const char* mSHA1;
 };
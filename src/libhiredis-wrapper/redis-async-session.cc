@@ -250,6 +250,8 @@ void SubscriptionSession::SubscriptionEntry::subscribe(SubscriptionCallback&& ca
 	{
 		Subscription newSub{.callback = std::move(callback), .fresh = true, .unsubbed = false};
 		if (isInMap()) {
+			// hiredis replaces the callback of the channel with the one of this command.
+			releaseBatch(mSlot->second.batch);
 			mSlot->second = std::move(newSub);
 		} else {
 			mSlot = mMap.emplace(mChannel, std::move(newSub)).first;
@@ -261,40 +263,8 @@ void SubscriptionSession::SubscriptionEntry::subscribe(SubscriptionCallback&& ca
 	auto nodePtr = std::addressof(*mSlot);
 	int status = mSession.command(
 	    {"SUBSCRIBE", mChannel}, nodePtr, [](redisAsyncContext* asyncCtx, void* rawReply, void* rawHandle) noexcept {
-		    auto reply = reply::tryFrom(static_cast<const redisReply*>(rawReply));
 		    auto* const handle = static_cast<decltype(nodePtr)>(rawHandle);
-		    auto& subscription = handle->second;
-		    // Tag subscription as having been answered
-		    subscription.fresh = false;
-		    // We'd like to determine if we should free the subscription from the map after the callback finishes
-		    // (i.e. when the Redis server no longer has knowledge of this subscription on its side, and won't send us
-		    // replies to that topic.)
-		    auto serverHasIt = true;
-		    // So let's just fetch the info we need in the reply before forwarding it. (It will be the job of the
-		    // callback to deal with any undocumented reply)
-		    Match(reply).against([&serverHasIt](const reply::Disconnected&) { serverHasIt = false; },
-		                         [&serverHasIt](const reply::Array& message) {
-			                         try {
-				                         const auto type = std::get<reply::String>(message[0]);
-				                         if (type == "unsubscribe") {
-					                         serverHasIt = false;
-				                         }
-			                         } catch (const std::bad_variant_access&) {
-			                         }
-		                         },
-		                         [](const auto&) {});
-		    if (const auto& callback = subscription.callback) {
-			    try {
-				    callback(handle->first, std::move(reply));
-			    } catch (const std::exception& exc) {
-				    SLOGE << "Unhandled exception in Redis subscription callback: " << exc.what();
-			    } catch (...) {
-				    SLOGE << "Unidentified Thrown Object in Redis subscription callback";
-			    }
-		    }
-		    if (subscription.unsubbed && !serverHasIt) {
-			    getSubscriptionsFrom(asyncCtx).erase(handle->first);
-		    }
+		    onSubscriptionReply(asyncCtx, *handle, reply::tryFrom(static_cast<const redisReply*>(rawReply)));
 	    });
 	if (status != REDIS_OK) {
 		// All other preconditions are checked, hiredis must have failed to allocate memory.
@@ -302,6 +272,155 @@ void SubscriptionSession::SubscriptionEntry::subscribe(SubscriptionCallback&& ca
 	}
 }
 
+void SubscriptionSession::onSubscriptionReply(const redisAsyncContext* rawContext,
+                                              SubsMap::value_type& node,
+                                              Reply&& reply) {
+	auto& subscription = node.second;
+	// Tag subscription as having been answered
+	subscription.fresh = false;
+	// We'd like to determine if we should free the subscription from the map after the callback finishes
+	// (i.e. when the Redis server no longer has knowledge of this subscription on its side, and won't send us
+	// replies to that topic.)
+	auto serverHasIt = true;
+	// So let's just fetch the info we need in the reply before forwarding it. (It will be the job of the
+	// callback to deal with any undocumented reply)
+	Match(reply).against([&serverHasIt](const reply::Disconnected&) { serverHasIt = false; },
+	                     [&serverHasIt](const reply::Array& message) {
+		                     try {
+			                     const auto type = std::get<reply::String>(message[0]);
+			                     if (type == "unsubscribe") {
+				                     serverHasIt = false;
+			                     }
+		                     } catch (const std::bad_variant_access&) {
+		                     }
+	                     },
+	                     [](const auto&) {});
+	if (const auto& callback = subscription.callback) {
+		try {
+			callback(node.first, std::move(reply));
+		} catch (const std::exception& exc) {
+			SLOGE << "Unhandled exception in Redis subscription callback: " << exc.what();
+		} catch (...) {
+			SLOGE << "Unidentified Thrown Object in Redis subscription callback";
+		}
+	}
+	if (subscription.unsubbed && !serverHasIt) {
+		getSubscriptionsFrom(rawContext).erase(node.first);
+	}
+}
+
+void SubscriptionSession::Subscriptions::subscribe(const std::vector<std::string>& topics,
+                                                   const SubscriptionCallback& callback) {
+	for (const auto& topic : topics) {
+		Subscription newSub{.callback = callback, .fresh = true, .unsubbed = false, .batched = true};
+		if (auto slot = mMap.find(topic); slot != mMap.end()) {
+			// hiredis replaces the callback of the channel with the one of the new command.
+			releaseBatch(slot->second.batch);
+			slot->second = std::move(newSub);
+		} else {
+			mMap.emplace(topic, std::move(newSub));
+		}
+	}
+	sendBatchedSubscribe(topics);
+}
+
+void SubscriptionSession::Subscriptions::sendBatchedSubscribe(const std::vector<std::string>& topics) {
+	for (auto first = topics.begin(); first != topics.end();) {
+		const auto last = first + std::min<std::ptrdiff_t>(kMaxTopicsPerCommand, topics.end() - first);
+		auto* batch = new SubscriptionBatch{.channels = std::vector<std::string>(first, last),
+		                                     .registeredChannels = size_t(last - first)};
+		first = last;
+
+		ArgsPacker args{"SUBSCRIBE"};
+		for (const auto& topic : batch->channels) {
+			mMap.at(topic).batch = batch;
+			args.addFieldName(topic);
+		}
+		// hiredis registers this callback for each channel of the command, with the same private data: the channel
+		// is taken from the reply to find the subscription.
+		int status = mSession.command(
+		    args, batch, [](redisAsyncContext* asyncCtx, void* rawReply, void* rawBatch) noexcept {
+			    onBatchedSubscriptionReply(asyncCtx, *static_cast<SubscriptionBatch*>(rawBatch),
+			                               reply::tryFrom(static_cast<const redisReply*>(rawReply)));
+		    });
+		if (status != REDIS_OK) {
+			for (const auto& topic : batch->channels) {
+				mMap.at(topic).batch = nullptr;
+			}
+			delete batch;
+			// All other preconditions are checked, hiredis must have failed to allocate memory.
+			throw std::bad_alloc{};
+		}
+	}
+}
+
+void SubscriptionSession::onBatchedSubscriptionReply(redisAsyncContext* rawContext,
+                                                     SubscriptionBatch& batch,
+                                                     Reply&& reply) {
+	auto& subscriptions = getSubscriptionsFrom(rawContext);
+	if (std::holds_alternative<reply::Disconnected>(reply)) {
+		// hiredis calls this once per channel of the batch, without telling which one: handle them all at once.
+		if (!batch.disconnected) {
+			batch.disconnected = true;
+			for (const auto& channel : batch.channels) {
+				const auto node = subscriptions.find(channel);
+				if (node == subscriptions.end() || node->second.batch != &batch) continue;
+				// The server has forgotten this subscription, it must be sent again on reconnection.
+				node->second.fresh = false;
+				node->second.batch = nullptr;
+				if (node->second.unsubbed) subscriptions.erase(node);
+			}
+		}
+		releaseBatch(&batch);
+		return;
+	}
+
+	try {
+		const auto& message = std::get<reply::Array>(reply);
+		if (1 < message.size()) {
+			const auto unsubscribed = std::get<reply::String>(message[0]) == "unsubscribe";
+			const auto channel = std::string{std::get<reply::String>(message[1])};
+			const auto node = subscriptions.find(channel);
+			if (unsubscribed) {
+				// hiredis forgets the callback of the channel after this reply.
+				if (node != subscriptions.end() && node->second.batch == &batch) node->second.batch = nullptr;
+				releaseBatch(&batch);
+			}
+			if (node != subscriptions.end()) {
+				onSubscriptionReply(rawContext, *node, std::move(reply));
+				return;
+			}
+		}
+	} catch (const std::bad_variant_access&) {
+	}
+	SLOGW << "Redis reply to a batched subscription could not be dispatched: " << StreamableVariant(reply);
+}
+
+void SubscriptionSession::releaseBatch(SubscriptionBatch* batch) {
+	if (batch && --batch->registeredChannels == 0) delete batch;
+}
+
+void SubscriptionSession::Subscriptions::unsubscribe(const std::vector<std::string>& topics) {
+	ArgsPacker args{"UNSUBSCRIBE"};
+	size_t count = 0;
+	const auto send = [this, &args, &count] {
+		if (count == 0) return;
+		if (REDIS_OK != mSession.command(args, nullptr, nullptr)) {
+			throw std::bad_alloc{};
+		}
+		args = ArgsPacker{"UNSUBSCRIBE"};
+		count = 0;
+	};
+	for (const auto& topic : topics) {
+		auto slot = mMap.find(topic);
+		if (slot == mMap.end()) continue;
+		slot->second.unsubbed = true;
+		args.addFieldName(topic);
+		if (++count == kMaxTopicsPerCommand) send();
+	}
+	send();
+}
+
 void SubscriptionSession::SubscriptionEntry::unsubscribe() {
 	if (!isInMap()) return;
 
@@ -352,6 +471,7 @@ void SubscriptionSession::onConnect(int status) {
 		reSubbedChannelsLog
 		    << "redis::async::SubscriptionSession::onConnect - Channels automatically re-subscribed: (none)";
 		reSubbedChannelsLog.seekp(-sizeof("(none)"));
+		std::vector<std::string> batchedChannels{};
 		for (auto& [channel, subscription] : mSubscriptions) {
 			// This `onConnect()` callback is called before responses are processed, so skip over any subscription
 			// created early, we shall receive the answer shortly
@@ -366,10 +486,20 @@ void SubscriptionSession::onConnect(int status) {
 
 			// Subscription created on a previous connection.
 			// We have just reconnected successfully, let's re-subscribe it
+			if (subscription.batched) {
+				subscription.fresh = true;
+				batchedChannels.push_back(channel);
+				continue;
+			}
 			newSubs[channel].subscribe(std::move(subscription.callback));
 			reSubbedChannelsLog << " '" << channel << "',";
 		}
+		newSubs.sendBatchedSubscribe(batchedChannels);
 		SLOGI << reSubbedChannelsLog.str();
+		if (!batchedChannels.empty()) {
+			SLOGI << "redis::async::SubscriptionSession::onConnect - " << batchedChannels.size()
+			      << " batched channel(s) automatically re-subscribed";
+		}
 	}
 
 	if (auto listener = mListener.lock()) {
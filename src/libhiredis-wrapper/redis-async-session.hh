@@ -10,10 +10,12 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <string>
 #include <string_view>
 #include <type_traits>
 #include <utility>
 #include <variant>
+#include <vector>
 
 #include "compat/hiredis/async.h"
 #include "sofia-sip/su_wait.h"
@@ -199,6 +201,7 @@ class SubscriptionSession final : SessionListener {
 	// commands"
 private:
 	struct Subscription;
+	struct SubscriptionBatch;
 	// An std::map<> has the guarantee that iterators remain valid after both `.insert()` and `.erase()` operations.
 	// Meaning it's safe to keep pointers to its elements in long-lived subscription callbacks
 	using SubsMap = std::map<std::string, Subscription>;
@@ -206,6 +209,9 @@ private:
 public:
 	using SubscriptionCallback = std::function<void(std::string_view, Reply)>;
 
+	// Keep batched SUBSCRIBE/UNSUBSCRIBE commands reasonably small for the Redis server.
+	static constexpr std::size_t kMaxTopicsPerCommand = 1000;
+
 	class Subscriptions;
 
 	// An existing, or hypothetical subscription to a given topic.
@@ -276,11 +282,26 @@ public:
 
 		SubscriptionEntry operator[](const std::string_view& topic);
 
+		/**
+		 * Subscribe the same callback to several topics with SUBSCRIBE commands of up to `kMaxTopicsPerCommand`
+		 * channels. Equivalent to calling `operator[](topic).subscribe(callback)` for every topic, except that the
+		 * `Disconnected` reply is not forwarded to the callback when the session disconnects.
+		 */
+		void subscribe(const std::vector<std::string>& topics, const SubscriptionCallback& callback);
+		/**
+		 * Send UNSUBSCRIBE commands of up to `kMaxTopicsPerCommand` channels for all the given topics this session is
+		 * subscribed to.
+		 */
+		void unsubscribe(const std::vector<std::string>& topics);
+
 		SubsMap::size_type size() const;
 
 	private:
 		Subscriptions(const Session::Ready&, SubsMap&);
 
+		// Send SUBSCRIBE commands for topics already in the map, with their callback set.
+		void sendBatchedSubscribe(const std::vector<std::string>& topics);
+
 		const Session::Ready& mSession;
 		SubsMap& mMap;
 	};
@@ -340,12 +361,31 @@ private:
 		// This flag is a way to safely handle the asynchronicity of an unsbuscribe process.
 		// (We must handle the acknowledgement response from Redis before we can free the subscription)
 		bool unsubbed;
+		// Whether the subscription was made through `Subscriptions::subscribe()`, and must be resumed that way.
+		bool batched = false;
+		// The batch whose callback hiredis currently holds for this channel, if any.
+		SubscriptionBatch* batch = nullptr;
+	};
+	// Private data of a batched SUBSCRIBE command. hiredis registers the same callback and private data for every
+	// channel of the command, and calls it for each of them when the session disconnects.
+	struct SubscriptionBatch {
+		std::vector<std::string> channels;
+		// Number of channels for which hiredis still holds the callback of this batch. The batch is freed when it
+		// drops to 0.
+		std::size_t registeredChannels;
+		// Whether the disconnection has already been handled for the whole batch.
+		bool disconnected = false;
 	};
 
 	void onConnect(int status) override;
 	void onDisconnect(int status) override;
 
 	static auto& getSubscriptionsFrom(const redisAsyncContext* rawContext);
+	// Forward a reply to the callback of the subscription, and free the subscription once the server has forgotten it.
+	static void onSubscriptionReply(const redisAsyncContext* rawContext, SubsMap::value_type& node, Reply&& reply);
+	static void onBatchedSubscriptionReply(redisAsyncContext* rawContext, SubscriptionBatch& batch, Reply&& reply);
+	// Tell that hiredis no longer holds the callback of the batch for one of its channels.
+	static void releaseBatch(SubscriptionBatch* batch);
 
 	SubsMap mSubscriptions{};
 	Session mWrapped;
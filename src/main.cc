@@ -27,6 +27,7 @@
 #include <list>
 #include <memory>
 #include <regex>
+#include <vector>
 
 #include <sys/resource.h>
 #include <sys/time.h>
@@ -106,7 +107,8 @@ using namespace flexisip;
 
 static int run = 1;
 static pid_t monitor_pid = -1;
-static pid_t flexisip_pid = -1;
+static vector<pid_t> flexisip_pids{}; // Filled in the watchdog process only, one PID per proxy worker
+static int worker_index = 0;          // Index of the proxy worker run by the current process, see 'global/workers'
 static int pipe_wdog_flexisip[2] = {-1}; // Pipe in which flexisip will write to notify the watchdog that it has started
 static shared_ptr<sofiasip::SuRoot> root{};
 
@@ -130,11 +132,14 @@ static void setOpenSSLThreadSafe() {
 }
 
 static void flexisip_stop(int signum) {
-	if (flexisip_pid > 0) {
+	if (!flexisip_pids.empty()) {
 		// We can't log from the parent process
 		// LOGD("Watchdog received quit signal...passing to child.");
-		/*we are the watchdog, pass the signal to our child*/
-		kill(flexisip_pid, signum);
+		/*we are the watchdog, pass the signal to our children*/
+		run = 0; // workers exiting from now on must not be respawned
+		for (auto pid : flexisip_pids) {
+			if (pid > 0) kill(pid, signum);
+		}
 	} else if (run != 0) {
 		// LOGD("Received quit signal...");
 
@@ -294,8 +299,67 @@ static void set_process_name([[maybe_unused]] const string& process_name) {
 #endif
 }
 
-static void forkAndDetach(
-    ConfigManager& cfg, const string& pidfile, bool auto_respawn, bool startMonitor, const string& functionName) {
+static void killFlexisipProcesses(int signum) {
+	for (auto pid : flexisip_pids) {
+		if (pid > 0) kill(pid, signum);
+	}
+}
+
+/*
+ * Fork the flexisip process running the given proxy worker and wait for it to notify its successful start.
+ * Return true in the new flexisip process, false in the watchdog.
+ */
+static bool
+forkFlexisip(int index, const string& pidfile, const string& functionName, int pipeLauncherWdog, int workers) {
+	uint8_t buf[4];
+	int err = pipe(pipe_wdog_flexisip);
+	if (err == -1) {
+		throw Exit{EXIT_FAILURE, "could not create pipes: "s + strerror(errno)};
+	}
+	pid_t pid = fork();
+	if (pid < 0) {
+		throw Exit{EXIT_FAILURE, "could not fork: "s + strerror(errno)};
+	}
+	if (pid == 0) {
+		/* This is the real flexisip process now.
+		 * We can proceed with real start
+		 */
+		close(pipe_wdog_flexisip[0]);
+		flexisip_pids.clear();
+		worker_index = index;
+		set_process_name("flexisip-" + functionName);
+		if (index == 0) makePidFile(pidfile);
+		return true;
+	}
+
+	flexisip_pids[index] = pid;
+	if (workers > 1) LOGI("[WDOG] Flexisip worker %d PID: %d", index, pid);
+	else LOGI("[WDOG] Flexisip PID: %d", pid);
+
+	/*
+	 * We are in the watch-dog process again
+	 * Waiting for successful initialisation of the flexisip process
+	 */
+	close(pipe_wdog_flexisip[1]);
+	err = read(pipe_wdog_flexisip[0], buf, sizeof(buf));
+	if (err == -1 || err == 0) {
+		string message{};
+		if (err == -1) message = "[WDOG] read error from flexisip, "s + strerror(errno);
+		flexisip_pids[index] = -1;
+		killFlexisipProcesses(SIGTERM); // don't leave the other workers orphaned
+		close(pipeLauncherWdog);        // close launcher pipe to signify the error
+		throw Exit{EXIT_FAILURE, message};
+	}
+	close(pipe_wdog_flexisip[0]);
+	return false;
+}
+
+static void forkAndDetach(ConfigManager& cfg,
+                          const string& pidfile,
+                          bool auto_respawn,
+                          bool startMonitor,
+                          const string& functionName,
+                          int workers) {
 	int pipe_launcher_wdog[2];
 	int err = pipe(pipe_launcher_wdog);
 	bool launcherExited = false;
@@ -314,43 +378,12 @@ static void forkAndDetach(
 		close(pipe_launcher_wdog[0]);
 		set_process_name("flexisipwd-" + functionName);
 
-	/* Creation of the flexisip process */
-	fork_flexisip:
-		err = pipe(pipe_wdog_flexisip);
-		if (err == -1) {
-			throw Exit{EXIT_FAILURE, "could not create pipes: "s + strerror(errno)};
-		}
-		flexisip_pid = fork();
-		if (flexisip_pid < 0) {
-			throw Exit{EXIT_FAILURE, "could not fork: "s + strerror(errno)};
-		}
-		if (flexisip_pid == 0) {
-
-			/* This is the real flexisip process now.
-			 * We can proceed with real start
-			 */
-			close(pipe_wdog_flexisip[0]);
-			set_process_name("flexisip-" + functionName);
-			makePidFile(pidfile);
-			return;
-		} else {
-			LOGI("[WDOG] Flexisip PID: %d", flexisip_pid);
+		/* Creation of the flexisip processes, one per proxy worker */
+		flexisip_pids.assign(workers, -1);
+		for (int index = 0; index < workers; ++index) {
+			if (forkFlexisip(index, pidfile, functionName, pipe_launcher_wdog[1], workers)) return;
 		}
 
-		/*
-		 * We are in the watch-dog process again
-		 * Waiting for successful initialisation of the flexisip process
-		 */
-		close(pipe_wdog_flexisip[1]);
-		err = read(pipe_wdog_flexisip[0], buf, sizeof(buf));
-		if (err == -1 || err == 0) {
-			string message{};
-			if (err == -1) message = "[WDOG] read error from flexisip, "s + strerror(errno);
-			close(pipe_launcher_wdog[1]); // close launcher pipe to signify the error
-			throw Exit{EXIT_FAILURE, message};
-		}
-		close(pipe_wdog_flexisip[0]);
-
 	/*
 	 * Flexisip has successfully started.
 	 * We can now start the Flexisip monitor if it is requierd
@@ -360,7 +393,7 @@ static void forkAndDetach(
 			int pipe_wd_mo[2];
 			err = pipe(pipe_wd_mo);
 			if (err == -1) {
-				kill(flexisip_pid, SIGTERM);
+				killFlexisipProcesses(SIGTERM);
 				throw Exit{EXIT_FAILURE, "could not create pipes: "s + strerror(errno)};
 			}
 			monitor_pid = fork();
@@ -379,7 +412,7 @@ static void forkAndDetach(
 			close(pipe_wd_mo[1]);
 			err = read(pipe_wd_mo[0], buf, sizeof(buf));
 			if (err == -1 || err == 0) {
-				kill(flexisip_pid, SIGTERM);
+				killFlexisipProcesses(SIGTERM);
 				throw Exit{EXIT_FAILURE, "[WDOG] read error from Monitor process, killed flexisip"};
 			}
 			close(pipe_wd_mo[0]);
@@ -407,22 +440,42 @@ static void forkAndDetach(
 			int status = 0;
 			pid_t retpid = wait(&status);
 			if (retpid > 0) {
-				if (retpid == flexisip_pid) {
-					if (startMonitor) kill(monitor_pid, SIGTERM);
-					if (WIFEXITED(status)) {
-						if (WEXITSTATUS(status) == RESTART_EXIT_CODE) {
-							LOGI("Flexisip restart to apply new config...");
-							sleep(1);
-							goto fork_flexisip;
-						} else {
-							throw Exit{EXIT_SUCCESS, "Flexisip exited normally"};
-						}
+				auto worker = find(flexisip_pids.begin(), flexisip_pids.end(), retpid);
+				if (worker != flexisip_pids.end()) {
+					const auto index = static_cast<int>(distance(flexisip_pids.begin(), worker));
+					*worker = -1;
+					const auto exitedNormally = WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+					const auto allExited =
+					    all_of(flexisip_pids.begin(), flexisip_pids.end(), [](pid_t pid) { return pid <= 0; });
+					// The pid file holds the PID of the first worker, so init scripts stop Flexisip by sending SIGTERM
+					// to a worker rather than to the watchdog: a clean exit of a worker is a shutdown request.
+					const auto terminated =
+					    WIFSIGNALED(status) && (WTERMSIG(status) == SIGTERM || WTERMSIG(status) == SIGINT);
+					if (run != 0 && (exitedNormally || terminated)) {
+						run = 0;
+						killFlexisipProcesses(SIGTERM);
+					}
+					if (run == 0) {
+						// Stopping: wait for the other workers to exit as well
+						if (!allExited) continue;
+						if (startMonitor) kill(monitor_pid, SIGTERM);
+						throw Exit{EXIT_SUCCESS, "Flexisip exited normally"};
+					}
+					if (WIFEXITED(status) && WEXITSTATUS(status) == RESTART_EXIT_CODE) {
+						LOGI("Flexisip restart to apply new config...");
 					} else if (auto_respawn) {
 						LOGE("Flexisip apparently crashed, respawning now...");
-						sleep(1);
-						goto fork_flexisip;
+					} else {
+						if (!allExited) continue;
+						if (startMonitor) kill(monitor_pid, SIGTERM);
+						throw Exit{EXIT_FAILURE, "Flexisip apparently crashed"};
 					}
+					if (startMonitor) kill(monitor_pid, SIGTERM);
+					sleep(1);
+					if (forkFlexisip(index, pidfile, functionName, pipe_launcher_wdog[1], workers)) return;
+					goto fork_monitor;
 				} else if (retpid == monitor_pid) {
+					if (run == 0) continue; // stopping, see above
 					LOGE("The Flexisip monitor has crashed or has been illegally terminated. Restarting now");
 					sleep(1);
 					goto fork_monitor;
@@ -896,7 +949,22 @@ int _main(int argc, char* argv[]) {
 		So we can detach.*/
 		bool autoRespawn = cfg->getGlobal()->get<ConfigBoolean>("auto-respawn")->read();
 		if (!startProxy) monitorEnabled = false;
-		forkAndDetach(*cfg, pidFile.getValue(), autoRespawn, monitorEnabled, fName);
+		auto workers = cfg->getGlobal()->get<ConfigInt>("workers")->read();
+		if (workers < 1) {
+			LOGF("'global/workers' must be greater than or equal to 1.");
+		}
+		if (workers > 1 && fName != "proxy") {
+			LOGW("'global/workers' is ignored because servers other than the proxy are started.");
+			workers = 1;
+		}
+		if (workers > 1 && cfg->getRoot()
+		                           ->get<GenericStruct>("module::Registrar")
+		                           ->get<ConfigString>("db-implementation")
+		                           ->read() != "redis") {
+			LOGF("Running several proxy workers ('global/workers') requires 'module::Registrar/db-implementation' to be "
+			     "set to 'redis'.");
+		}
+		forkAndDetach(*cfg, pidFile.getValue(), autoRespawn, monitorEnabled, fName, workers);
 	} else if (pidFile.getValue().length() != 0) {
 		// not daemon but we want a pidfile anyway
 		makePidFile(pidFile.getValue());
@@ -961,7 +1029,7 @@ int _main(int argc, char* argv[]) {
 	setOpenSSLThreadSafe();
 
 	if (startProxy) {
-		a->start(transportsArg.getValue(), passphrase);
+		a->start(transportsArg.getValue(), passphrase, worker_index);
 #ifdef ENABLE_SNMP
 		bool snmpEnabled = cfg->getGlobal()->get<ConfigBoolean>("enable-snmp")->read();
 		if (snmpEnabled) {
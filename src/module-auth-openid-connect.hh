@@ -41,6 +41,9 @@ private:
 
 	void onRequest(std::shared_ptr<RequestSipEvent>& ev) override;
 	void onResponse(std::shared_ptr<ResponseSipEvent>& ev) override;
+	SipMethodSet getHandledResponseMethods() const override {
+		return {};
+	}
 
 	std::shared_ptr<Bearer> mBearerAuth;
 };
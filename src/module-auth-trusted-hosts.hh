@@ -39,6 +39,9 @@ private:
 
 	void onRequest(std::shared_ptr<RequestSipEvent>& ev) override;
 	void onResponse(std::shared_ptr<ResponseSipEvent>& ev) override;
+	SipMethodSet getHandledResponseMethods() const override {
+		return {};
+	}
 	void loadTrustedHosts(const ConfigStringList& trustedHosts);
 
 	std::set<BinaryIp> mTrustedHosts;
@@ -38,6 +38,9 @@ private:
 
 	void onRequest(std::shared_ptr<RequestSipEvent>& ev) override;
 	void onResponse(std::shared_ptr<ResponseSipEvent>& ev) override;
+	SipMethodSet getHandledResponseMethods() const override {
+		return {};
+	}
 
 	std::unordered_map<std::string, std::shared_ptr<AuthScheme>> mAuthModules;
 };
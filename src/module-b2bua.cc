@@ -16,6 +16,9 @@
     along with this program. If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <string_view>
+#include <vector>
+
 #include "flexisip/logmanager.hh"
 #include "flexisip/module.hh"
 #include "flexisip/utils/sip-uri.hh"
@@ -42,6 +45,8 @@ public:
 private:
 	static ModuleInfo<B2bua> sInfo;
 	unique_ptr<SipUri> mDestRoute;
+	// One route per worker of the B2BUA server, the first one being mDestRoute
+	vector<SipUri> mWorkerRoutes;
 	su_home_t mHome;
 
 	B2bua(Agent* agent, const ModuleInfoBase* moduleInfo) : Module(agent, moduleInfo) {
@@ -54,6 +59,12 @@ private:
 
 	void onRequest(shared_ptr<RequestSipEvent>& ev) override;
 	void onResponse(shared_ptr<ResponseSipEvent>& ev) override;
+	SipMethodSet getHandledRequestMethods() const override {
+		return {sip_method_invite, sip_method_cancel};
+	}
+	SipMethodSet getHandledResponseMethods() const override {
+		return {};
+	}
 };
 
 ModuleInfo<B2bua> B2bua::sInfo(
@@ -63,9 +74,15 @@ ModuleInfo<B2bua> B2bua::sInfo(
     ModuleInfoBase::ModuleOid::B2bua,
 
     [](GenericStruct& moduleConfig) {
-	    ConfigItemDescriptor configs[] = {{String, "b2bua-server", "A sip uri where to send all the relevent requests.",
-	                                       "sip:127.0.0.1:6067;transport=tcp"},
-	                                      config_item_end};
+	    ConfigItemDescriptor configs[] = {
+	        {String, "b2bua-server", "A sip uri where to send all the relevent requests.",
+	         "sip:127.0.0.1:6067;transport=tcp"},
+	        {Integer, "workers",
+	         "Number of workers of the B2BUA server (see 'workers' parameter of the 'b2bua-server' section). Calls are "
+	         "dispatched between them according to their Call-ID, worker i being reached on the port of 'b2bua-server' "
+	         "+ i. This port cannot be random (0) when there are several workers.",
+	         "1"},
+	        config_item_end};
 	    moduleConfig.get<ConfigBoolean>("enabled")->setDefault("false");
 	    moduleConfig.addChildrenValues(configs);
     });
@@ -95,6 +112,23 @@ void B2bua::onLoad(const GenericStruct* moduleConfig) {
 		LOGF("Invalid SIP URI (%s) in 'b2bua-server' parameter of 'B2bua' module: %s", destRouteStr.c_str(), e.what());
 	}
 	SLOGI << getModuleName() << ": b2bua server is [" << mDestRoute->str() << "]";
+
+	const auto* workersParam = moduleConfig->get<ConfigInt>("workers");
+	const auto workers = workersParam->read();
+	if (workers < 1) LOGF("'%s' must be at least 1", workersParam->getCompleteName().c_str());
+	const auto port = stoi(mDestRoute->getPort(true));
+	if (workers > 1 && port == 0) {
+		LOGF("'%s' cannot use a random port (0) when there are several workers",
+		     moduleConfig->get<ConfigString>("b2bua-server")->getCompleteName().c_str());
+	}
+	mWorkerRoutes.clear();
+	mWorkerRoutes.emplace_back(*mDestRoute);
+	for (auto index = 1; index < workers; ++index) {
+		auto* url = url_hdup(&mHome, mDestRoute->get());
+		url->url_port = su_strdup(&mHome, to_string(port + index).c_str());
+		mWorkerRoutes.emplace_back(url);
+		SLOGI << getModuleName() << ": b2bua server worker " << index << " is [" << mWorkerRoutes.back().str() << "]";
+	}
 }
 
 void B2bua::onUnload() {
@@ -107,9 +141,14 @@ void B2bua::onRequest(shared_ptr<RequestSipEvent>& ev) {
 		sip_unknown_t* header = ModuleToolbox::getCustomHeaderByName(sip, B2buaServer::kCustomHeader);
 
 		if (header == NULL) {
+			// The CANCEL has the same Call-ID as its INVITE, hence it reaches the same worker.
+			const auto& destRoute =
+			    sip->sip_call_id == nullptr
+			        ? mWorkerRoutes.front()
+			        : mWorkerRoutes[hash<string_view>{}(sip->sip_call_id->i_id) % mWorkerRoutes.size()];
 			ModuleToolbox::cleanAndPrependRoute(this->getAgent(), ev->getMsgSip()->getMsg(), ev->getSip(),
-			                                    sip_route_create(&mHome, mDestRoute->get(), nullptr));
-			SLOGD << "B2bua onRequest, clean and prepend done to route " << mDestRoute->str();
+			                                    sip_route_create(&mHome, destRoute.get(), nullptr));
+			SLOGD << "B2bua onRequest, clean and prepend done to route " << destRoute.str();
 		} else { // Do not intercept the call
 			// TODO: Remove the custom header flexisip-b2bua
 			SLOGD << "B2bua onRequest, ignore INVITE with custom header set to " << std::string(header->un_value);
@@ -34,6 +34,12 @@ private:
 	void onRequest(std::shared_ptr<RequestSipEvent>& ev) override;
 	void onResponse(std::shared_ptr<ResponseSipEvent>&) override {
 	}
+	SipMethodSet getHandledRequestMethods() const override {
+		return {sip_method_options};
+	}
+	SipMethodSet getHandledResponseMethods() const override {
+		return {};
+	}
 
 	// Private attributes
 	static const ModuleInfo<ModuleCapabilities> sInfo;
@@ -369,6 +369,9 @@ public:
 	virtual void onRequest(shared_ptr<RequestSipEvent>& ev);
 
 	virtual void onResponse(shared_ptr<ResponseSipEvent>& ev);
+	SipMethodSet getHandledResponseMethods() const override {
+		return {};
+	}
 
 	virtual bool isValidNextConfig(const ConfigValue& cv);
 
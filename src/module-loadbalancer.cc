@@ -16,13 +16,24 @@
     along with this program. If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <functional>
+#include <memory>
+#include <string_view>
 #include <vector>
 
+#include <sofia-sip/nta.h>
+
 #include <flexisip/module.hh>
 
 #include "agent.hh"
 #include "eventlogs/writers/event-log-writer.hh"
+#include "flexisip/sofia-wrapper/home.hh"
+#include "flexisip/sofia-wrapper/timer.hh"
+#include "flexisip/utils/sip-uri.hh"
 #include "module-toolbox.hh"
+#include "utils/rendezvous-hash.hh"
+#include "utils/string-utils.hh"
+#include "utils/uri-utils.hh"
 
 using namespace std;
 using namespace flexisip;
@@ -31,16 +42,32 @@ class LoadBalancer : public Module {
 	friend std::shared_ptr<Module> ModuleInfo<LoadBalancer>::create(Agent*);
 
 public:
-	virtual ~LoadBalancer();
-	virtual void onLoad(const GenericStruct* modconf);
-	virtual void onRequest(shared_ptr<RequestSipEvent>& ev);
-	virtual void onResponse(shared_ptr<ResponseSipEvent>& ev);
+	~LoadBalancer() override;
+	void onLoad(const GenericStruct* modconf) override;
+	void onUnload() override;
+	void onRequest(shared_ptr<RequestSipEvent>& ev) override;
+	void onResponse(shared_ptr<ResponseSipEvent>& ev) override;
+	SipMethodSet getHandledResponseMethods() const override {
+		return {};
+	}
 
 private:
+	struct Route {
+		string header; // value of the Route header prepended to the requests
+		sofiasip::Url url;
+		bool healthy{true};
+		nta_outgoing_t* probe{nullptr}; // pending OPTIONS request, if any
+	};
+
 	LoadBalancer(Agent* ag, const ModuleInfoBase* moduleInfo);
 
-	vector<string> mRoutes;
-	int mRoutesCount;
+	void probeRoutes();
+	static int onProbeResponse(nta_outgoing_magic_t* magic, nta_outgoing_t* orq, const sip_t* sip);
+
+	vector<unique_ptr<Route>> mRoutes;
+	RendezvousHash<Route*> mRing;
+	string mProbeFrom;
+	unique_ptr<sofiasip::Timer> mProbeTimer;
 
 	static ModuleInfo<LoadBalancer> sInfo;
 };
@@ -49,40 +76,112 @@ LoadBalancer::LoadBalancer(Agent* ag, const ModuleInfoBase* moduleInfo) : Module
 }
 
 LoadBalancer::~LoadBalancer() {
+	onUnload();
 }
 
 void LoadBalancer::onLoad(const GenericStruct* modconf) {
 	list<string> routes = modconf->get<ConfigStringList>("routes")->read();
-	list<string>::iterator it;
+	sofiasip::Home home{};
 
 	LOGI("Load balancer configured to balance over:");
-	for (it = routes.begin(); it != routes.end(); ++it) {
-		mRoutes.push_back(*it);
-		LOGI("%s", (*it).c_str());
+	for (const auto& routeStr : routes) {
+		const auto* header = sip_route_make(home.home(), routeStr.c_str());
+		if (header == nullptr) {
+			LOGF("LoadBalancer: invalid route '%s'", routeStr.c_str());
+		}
+		auto route = make_unique<Route>();
+		route->url = sofiasip::Url{header->r_url};
+		auto weight = 1.0;
+		if (route->url.hasParam("weight")) {
+			try {
+				weight = stod(route->url.getParam("weight"));
+			} catch (const logic_error&) {
+				weight = 0.0;
+			}
+			if (weight <= 0.0) {
+				LOGF("LoadBalancer: invalid weight in route '%s'", routeStr.c_str());
+			}
+			route->url.removeParam("weight");
+		}
+		route->header = "<" + route->url.str() + ">";
+		LOGI("%s (weight: %g)", route->header.c_str(), weight);
+		mRing.add(route.get(), hash<string>{}(route->url.str()), weight);
+		mRoutes.push_back(std::move(route));
+	}
+
+	const auto interval = modconf->get<ConfigDuration<chrono::seconds>>("health-check-interval")->read();
+	if (interval.count() > 0 && !mRoutes.empty()) {
+		auto host = getAgent()->getPublicIp();
+		if (!StringUtils::startsWith(host, "[") && UriUtils::isIpv6Address(host)) host = "[" + host + "]";
+		mProbeFrom = "<sip:" + host + ">";
+		mProbeTimer = make_unique<sofiasip::Timer>(getAgent()->getRoot(), interval);
+		mProbeTimer->setForEver([this] { probeRoutes(); });
+		probeRoutes();
+	}
+}
+
+void LoadBalancer::onUnload() {
+	mProbeTimer.reset();
+	for (const auto& route : mRoutes) {
+		if (route->probe) nta_outgoing_destroy(route->probe);
+	}
+	mRing.clear();
+	mRoutes.clear();
+}
+
+void LoadBalancer::probeRoutes() {
+	for (const auto& route : mRoutes) {
+		if (route->probe) continue; // the previous probe has not completed yet
+		route->probe = nta_outgoing_tcreate(getAgent()->getSofiaAgent(), onProbeResponse,
+		                                    reinterpret_cast<nta_outgoing_magic_t*>(route.get()),
+		                                    reinterpret_cast<const url_string_t*>(route->url.get()), SIP_METHOD_OPTIONS,
+		                                    reinterpret_cast<const url_string_t*>(route->url.get()),
+		                                    SIPTAG_FROM_STR(mProbeFrom.c_str()), SIPTAG_TO_STR(route->header.c_str()),
+		                                    TAG_END());
+		if (route->probe == nullptr) {
+			LOGE("LoadBalancer: could not send OPTIONS to %s", route->header.c_str());
+		}
 	}
-	mRoutesCount = mRoutes.size();
+}
+
+int LoadBalancer::onProbeResponse(nta_outgoing_magic_t* magic, nta_outgoing_t* orq, const sip_t* sip) {
+	auto* route = reinterpret_cast<Route*>(magic);
+	const auto status = sip && sip->sip_status ? sip->sip_status->st_status : nta_outgoing_status(orq);
+	if (status < 200) return 0;
+
+	// 408 and 503 are also generated locally by the transaction layer on timeout and transport errors.
+	const auto healthy = status != 408 && status != 503;
+	if (healthy != route->healthy) {
+		if (healthy) LOGI("LoadBalancer: %s is back, sending requests to it again", route->header.c_str());
+		else LOGW("LoadBalancer: %s answered %d to OPTIONS, excluding it", route->header.c_str(), status);
+		route->healthy = healthy;
+	}
+	nta_outgoing_destroy(orq);
+	route->probe = nullptr;
+	return 0;
 }
 
 void LoadBalancer::onRequest(shared_ptr<RequestSipEvent>& ev) {
 	const shared_ptr<MsgSip>& ms = ev->getMsgSip();
-	uint32_t call_hash;
 	sip_t* sip = ms->getSip();
-	int index;
 
-	if (mRoutesCount == 0) return;
+	if (mRing.empty()) return;
 
-	/* very simple load sharing algorithm, based on randomness of call id*/
+	/* Rendezvous hashing on the Call-ID: a given call always goes to the same route as long as this route is healthy,
+	 * and losing or adding a route only moves the calls of this route. */
 	if (sip->sip_call_id) {
-		const char* route;
-		call_hash = sip->sip_call_id->i_hash;
-		index = call_hash % mRoutesCount;
-		route = mRoutes[index].c_str();
-		ModuleToolbox::cleanAndPrependRoute(getAgent(), ms->getMsg(), sip, sip_route_make(ms->getHome(), route));
+		const auto callHash = hash<string_view>{}(sip->sip_call_id->i_id);
+		auto* const* route = mRing.pick(callHash, [](const Route* candidate) { return candidate->healthy; });
+		if (route == nullptr) {
+			// Every route seems down, rather try one than drop the request.
+			route = mRing.pick(callHash);
+		}
+		ModuleToolbox::cleanAndPrependRoute(getAgent(), ms->getMsg(), sip,
+		                                    sip_route_make(ms->getHome(), (*route)->header.c_str()));
 	} else {
 		LOGW("request has no call id");
 	}
 }
-
 void LoadBalancer::onResponse([[maybe_unused]] shared_ptr<ResponseSipEvent>& ev) {
 	/*nothing to do*/
 }
@@ -96,11 +195,21 @@ ModuleInfo<LoadBalancer> LoadBalancer::sInfo(
     [](GenericStruct& moduleConfig) {
 	    /*we need to be disabled by default*/
 	    moduleConfig.get<ConfigBoolean>("enabled")->setDefault("false");
-	    ConfigItemDescriptor items[] = {{StringList, "routes",
-	                                     "Whitespace separated list of sip routes to balance the "
-	                                     "requests. Example: <sip:192.168.0.22> <sip:192.168.0.23>",
-	                                     ""},
-	                                    config_item_end};
+	    ConfigItemDescriptor items[] = {
+	        {StringList, "routes",
+	         "Whitespace separated list of sip routes to balance the requests. Example: <sip:192.168.0.22> "
+	         "<sip:192.168.0.23>\n"
+	         "A 'weight' URI parameter can be set on a route to send it a proportionally bigger share of the calls "
+	         "(default is 1). Example: <sip:192.168.0.22;weight=2> <sip:192.168.0.23>\n"
+	         "Calls are assigned to routes by rendezvous hashing of their Call-ID, so that adding or removing a route "
+	         "only moves the calls of this route.",
+	         ""},
+	        {DurationS, "health-check-interval",
+	         "Interval between two OPTIONS requests sent to each route to check its health. A route that doesn't "
+	         "answer, or answers with a 503, is excluded until it answers again: only the calls it was handling are "
+	         "moved to other routes. Zero disables health checking.",
+	         "30"},
+	        config_item_end};
 	    moduleConfig.addChildrenValues(items);
     },
     ModuleClass::Experimental);
@@ -99,6 +99,12 @@ private:
 		if (isMessageAPresenceMessage(ev)) route(ev);
 	}
 	void onResponse([[maybe_unused]] std::shared_ptr<ResponseSipEvent>& ev){};
+	SipMethodSet getHandledRequestMethods() const override {
+		return {sip_method_subscribe, sip_method_publish};
+	}
+	SipMethodSet getHandledResponseMethods() const override {
+		return {};
+	}
 
 	ModulePresence(Agent* ag, const ModuleInfoBase* moduleInfo) : Module(ag, moduleInfo) {
 		su_home_init(&mHome);
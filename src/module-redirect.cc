@@ -63,6 +63,9 @@ private:
 		          SIPTAG_SERVER_STR(getAgent()->getServerString()), TAG_END());
 	}
 	void onResponse([[maybe_unused]] std::shared_ptr<ResponseSipEvent>& ev){};
+	SipMethodSet getHandledResponseMethods() const override {
+		return {};
+	}
 
 	ModuleRedirect(Agent* ag, const ModuleInfoBase* moduleInfo) : Module(ag, moduleInfo) {
 		su_home_init(&mHome);
@@ -76,6 +76,12 @@ private:
 	}
 
 	void onResponse([[maybe_unused]] std::shared_ptr<ResponseSipEvent>& ev){};
+	SipMethodSet getHandledRequestMethods() const override {
+		return {sip_method_subscribe};
+	}
+	SipMethodSet getHandledResponseMethods() const override {
+		return {};
+	}
 
 	RegEvent(Agent* ag, const ModuleInfoBase* moduleInfo) : Module(ag, moduleInfo) {
 		su_home_init(&mHome);
@@ -61,7 +61,7 @@ static void _onContactUpdated(ModuleRegistrar* module, tport_t* new_tport, const
 	tp_name_t name = {0, 0, 0, 0, 0, 0};
 	tport_t* old_tport;
 
-	if (module->getAgent() != nullptr && ec->mPath.size() == 1) {
+	if (module->getAgent() != nullptr && ec->getPath().size() == 1) {
 		if (tport_name_by_url(home.home(), &name, (url_string_t*)ec->mSipContact->m_url) == 0) {
 			old_tport = tport_by_name(nta_agent_tports(module->getSofiaAgent()), &name);
 
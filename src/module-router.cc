@@ -18,6 +18,7 @@
 
 #include "flexisip/module-router.hh"
 
+#include <algorithm>
 #include <memory>
 
 #include "sofia-sip/sip.h"
@@ -29,6 +30,8 @@
 #include "eventlogs/events/calls/call-ended-event-log.hh"
 #include "fork-context/fork-basic-context.hh"
 #include "fork-context/fork-call-context.hh"
+#include "fork-context/fork-message-context-db-proxy.hh"
+#include "fork-context/fork-message-context-file-store.hh"
 #include "fork-context/fork-message-context.hh"
 #include "module-toolbox.hh"
 #include "registrar/extended-contact.hh"
@@ -36,9 +39,9 @@
 #include "router/agent-injector.hh"
 #include "router/inject-context.hh"
 #include "router/schedule-injector.hh"
+#include "utils/uri-utils.hh"
 
 #if ENABLE_SOCI
-#include "fork-context/fork-message-context-db-proxy.hh"
 #include "fork-context/fork-message-context-soci-repository.hh"
 #endif
 
@@ -104,6 +107,20 @@ void ModuleRouter::declareConfig(GenericStruct& moduleConfig) {
 	     "db='mydb' user='myuser' password='mypass' host='myhost.com'"},
 	    {Integer, "message-database-pool-size",
 	     "Size of the pool of connections that Soci will use for accessing the message database.", "100"},
+	    {String, "message-spill-directory",
+	     "If not empty and message-database-enabled is 'false', the messages that are waiting for delivery are "
+	     "written to log files in this directory and evicted from memory once they have been idle for "
+	     "message-spill-delay. They are loaded back when one of their recipients registers, and restored from the "
+	     "directory when Flexisip restarts. This allows a standalone proxy to keep a large number of undelivered "
+	     "messages with a bounded memory usage. This property applies only if message-fork-late is 'true'.\n"
+	     "Durability: the messages written to this directory survive a restart or a crash of Flexisip, but the log "
+	     "files are only flushed to disk when they are rotated (every 64 MiB). The messages evicted since the last "
+	     "rotation may be lost if the host itself crashes or loses power.",
+	     ""},
+	    {DurationS, "message-spill-delay",
+	     "Time a message waiting for delivery must stay idle (i.e. without any response from its recipients) before "
+	     "being evicted from memory to message-spill-directory.",
+	     "60"},
 	    {String, "fallback-route",
 	     "Default route to apply when the recipient is unreachable or when when all attempted destination have "
 	     "failed."
@@ -255,40 +272,54 @@ void ModuleRouter::onLoad(const GenericStruct* mc) {
 
 #if ENABLE_SOCI
 	if (mMessageForkCfg->mForkLate && mc->get<ConfigBoolean>("message-database-enabled")->read()) {
-		mMessageForkCfg->mSaveForkMessageEnabled = true;
-		InjectContext::setMaxRequestRetentionTime(
-		    mc->get<ConfigDuration<chrono::seconds>>("max-request-retention-time")->read());
-		mInjector = make_unique<ScheduleInjector>(this);
 		ForkMessageContextSociRepository::prepareConfiguration(
 		    mc->get<ConfigString>("message-database-backend")->read(),
 		    mc->get<ConfigString>("message-database-connection-string")->read(),
 		    mc->get<ConfigInt>("message-database-pool-size")->read());
+		// The repository is a process-wide singleton, do not take its ownership.
+		mForkMessageRepository = shared_ptr<ForkMessageContextRepository>{
+		    shared_ptr<void>{}, ForkMessageContextSociRepository::getInstance().get()};
+	}
+#endif
+	const auto spillDirectory = mc->get<ConfigString>("message-spill-directory")->read();
+	if (!mForkMessageRepository && mMessageForkCfg->mForkLate && !spillDirectory.empty()) {
+		try {
+			mForkMessageRepository = make_shared<ForkMessageContextFileStore>(spillDirectory);
+		} catch (const exception& e) {
+			LOGF("Cannot use [%s] as message-spill-directory in module::Router: %s", spillDirectory.c_str(), e.what());
+		}
+		mMessageForkCfg->mSaveForkMessageDelay = chrono::duration_cast<chrono::seconds>(
+		    mc->get<ConfigDuration<chrono::seconds>>("message-spill-delay")->read());
+	}
+
+	if (mForkMessageRepository) {
+		mMessageForkCfg->mSaveForkMessageEnabled = true;
+		InjectContext::setMaxRequestRetentionTime(
+		    mc->get<ConfigDuration<chrono::seconds>>("max-request-retention-time")->read());
+		mInjector = make_unique<ScheduleInjector>(this);
 
 		restoreForksFromDatabase();
 	}
-#endif
 
 	if (!mInjector) {
 		mInjector = make_unique<AgentInjector>(this);
 	}
 }
 
-#if ENABLE_SOCI
 void ModuleRouter::restoreForksFromDatabase() {
 	SLOGI << "Fork message to DB is enabled, retrieving previous messages in DB ...";
-	auto allDbMessages = ForkMessageContextSociRepository::getInstance()->findAllForkMessage();
+	auto allDbMessages = mForkMessageRepository->findAllForkMessage();
 	SLOGD << " ... " << allDbMessages.size() << " messages found in DB ...";
 	for (auto& dbMessage : allDbMessages) {
 		mStats.mCountForks->incrStart();
 		auto restoredForkMessage = ForkMessageContextDbProxy::make(shared_from_this(), dbMessage);
 		for (const auto& key : dbMessage.dbKeys) {
-			mForks.emplace(key, restoredForkMessage);
+			mForks.add(key, restoredForkMessage);
 			mAgent->getRegistrarDb().subscribe(Record::Key(key), std::weak_ptr<OnContactRegisteredListener>(mOnContactRegisteredListener));
 		}
 	}
 	SLOGI << " ... " << mForks.size() << " fork message restored from DB.";
 }
-#endif
 
 void ModuleRouter::sendReply(
     shared_ptr<RequestSipEvent>& ev, int code, const char* reason, int warn_code, const char* warning) {
@@ -479,7 +510,7 @@ public:
 		Home home;
 		/*first step, eliminate adjacent contacts, they cannot be factorized*/
 		for (auto it = mAllContacts.begin(); it != mAllContacts.end();) {
-			if ((*it).second->mPath.size() < 2) {
+			if ((*it).second->getPath().size() < 2) {
 				/*this is a "direct" destination, nothing to do*/
 				mDestinations.emplace_back(ForkDestination((*it).first, (*it).second, ""));
 				it = mAllContacts.erase(it);
@@ -495,7 +526,7 @@ public:
 			dest.mSipContact = (*it).first;
 			dest.mExtendedContact = (*it).second;
 			targetUris << "<" << *dest.mExtendedContact->toSofiaUrlClean(home.home()) << ">";
-			url_t* url = url_make(home.home(), (*it).second->mPath.back().c_str());
+			url_t* url = url_make(home.home(), (*it).second->getPath().back().c_str());
 			// remove it and now search for other contacts that have the same route.
 			it = mAllContacts.erase(it);
 			while ((sameDestinationIt = findDestination(url)) != mAllContacts.end()) {
@@ -526,7 +557,7 @@ private:
 		Home home;
 		// LOGD("findDestination(): looking for %s", url_as_string(home.home(), url));
 		for (auto it = mAllContacts.begin(); it != mAllContacts.end(); ++it) {
-			url_t* it_route = url_make(home.home(), (*it).second->mPath.back().c_str());
+			url_t* it_route = url_make(home.home(), (*it).second->getPath().back().c_str());
 			// LOGD("findDestination(): seeing %s", url_as_string(home.home(), it_route));
 			if (url_cmp(it_route, url) == 0) {
 				return it;
@@ -607,24 +638,18 @@ void ModuleRouter::routeRequest(shared_ptr<RequestSipEvent>& ev, const shared_pt
 	           !(sip->sip_content_type &&
 	             strcasecmp(sip->sip_content_type->c_type, "application/im-iscomposing+xml") == 0) &&
 	           !(sip->sip_expires && sip->sip_expires->ex_delta == 0)) {
-// Use the basic fork context for "im-iscomposing+xml" messages to prevent storing useless messages
-#if ENABLE_SOCI
+		// Use the basic fork context for "im-iscomposing+xml" messages to prevent storing useless messages
 		if (mMessageForkCfg->mSaveForkMessageEnabled) {
 			context = ForkMessageContextDbProxy::make(shared_from_this(), ev, msgPriority);
-		} else
-#endif
-		{
+		} else {
 			context = ForkMessageContext::make(shared_from_this(), ev, shared_from_this(), msgPriority);
 		}
 	} else if (sip->sip_request->rq_method == sip_method_refer &&
 	           (sip->sip_refer_to != nullptr && msg_params_find(sip->sip_refer_to->r_params, "text") != nullptr)) {
-// Use the message fork context only for refers that are text to prevent storing useless refers
-#if ENABLE_SOCI
+		// Use the message fork context only for refers that are text to prevent storing useless refers
 		if (mMessageForkCfg->mSaveForkMessageEnabled) {
 			context = ForkMessageContextDbProxy::make(shared_from_this(), ev, msgPriority);
-		} else
-#endif
-		{
+		} else {
 			context = ForkMessageContext::make(shared_from_this(), ev, shared_from_this(), msgPriority);
 		}
 	} else {
@@ -632,7 +657,7 @@ void ModuleRouter::routeRequest(shared_ptr<RequestSipEvent>& ev, const shared_pt
 	}
 	auto key = routingKey<Record::Key>(sipUri);
 	context->addKey(key.asString());
-	mForks.emplace(key.asString(), context);
+	mForks.add(key.asString(), context);
 	SLOGD << "Add fork " << context.get() << " to store with key '" << key << "'";
 	if (context->getConfig()->mForkLate) {
 		mAgent->getRegistrarDb().subscribe(key, std::weak_ptr<OnContactRegisteredListener>(mOnContactRegisteredListener));
@@ -666,7 +691,7 @@ void ModuleRouter::routeRequest(shared_ptr<RequestSipEvent>& ev, const shared_pt
 				}
 				auto aliasKey = routingKey<Record::Key>(temp_ctt->m_url);
 				context->addKey(aliasKey.asString());
-				mForks.emplace(aliasKey.asString(), context);
+				mForks.add(aliasKey.asString(), context);
 				SLOGD << "Add fork " << context.get() << " to store with key '" << aliasKey
 				      << "' because it is an alias";
 				if (context->getConfig()->mForkLate) {
@@ -778,13 +803,31 @@ public:
 	~TargetUriListFetcher() override = default;
 
 	void fetch(bool allowDomainRegistrations, bool recursive) {
-		// Compute the number of asynchronous queries we are going to make, to later know when we are done.
-		mPending = mUriList.size();
-
-		// Start the queries for all uris of the target uri list.
+		// Plain AoRs are fetched all at once, so that a request sent to a large group of recipients (e.g. a chat room
+		// message relayed by the conference server) costs a single query to the registrar. GRUUs and domain
+		// registrations require a query of their own.
+		vector<SipUri> batch{};
+		vector<const SipUri*> singles{};
 		for (const auto& uri : mUriList) {
-			mRegistrarDb.fetch(uri, this->shared_from_this(), allowDomainRegistrations, recursive);
+			if (allowDomainRegistrations || !UriUtils::getParamValue(uri.get()->url_params, "gr").empty()) {
+				singles.push_back(&uri);
+			} else {
+				batch.push_back(uri);
+			}
+		}
+
+		// One more pending query until all of them are sent, as they may be answered synchronously.
+		mPending = singles.size() + 1;
+		for (const auto* uri : singles) {
+			mRegistrarDb.fetch(*uri, this->shared_from_this(), allowDomainRegistrations, recursive);
+		}
+		if (!batch.empty()) {
+			mPending++;
+			SLOGD << "Fetching " << batch.size() << " target URIs at once";
+			mRegistrarDb.fetchList(std::move(batch), make_shared<BatchListener>(this->shared_from_this(), recursive));
 		}
+		--mPending;
+		checkFinished();
 	}
 
 	void onRecordFound(const shared_ptr<Record>& r) override {
@@ -833,6 +876,42 @@ public:
 private:
 	friend class ModuleRouter;
 
+	class BatchListener : public ListContactUpdateListener {
+	public:
+		BatchListener(const shared_ptr<TargetUriListFetcher>& fetcher, bool recursive)
+		    : mFetcher(fetcher), mRecursive(recursive) {
+		}
+
+		void onContactsUpdated() override {
+			auto& fetcher = *mFetcher;
+			for (const auto& record : records) {
+				const auto& contacts = record->getExtendedContacts();
+				const auto needsResolution = mRecursive && any_of(contacts.begin(), contacts.end(), [](const auto& ec) {
+					                             return ec->mAlias || ec->mUsedAsRoute;
+				                             });
+				if (needsResolution) {
+					// Aliases (and contacts used as routes) are only resolved by a recursive fetch of the AoR.
+					fetcher.mPending++;
+					fetcher.mRegistrarDb.fetch(record->getAor(), mFetcher, false, true);
+				} else {
+					fetcher.mRecord->appendContactsFrom(record);
+				}
+			}
+			--fetcher.mPending;
+			fetcher.checkFinished();
+		}
+
+		void onError(const SipStatus&) override {
+			mFetcher->mError = true;
+			--mFetcher->mPending;
+			mFetcher->checkFinished();
+		}
+
+	private:
+		shared_ptr<TargetUriListFetcher> mFetcher;
+		bool mRecursive;
+	};
+
 	int mPending = 0;
 	bool mError = false;
 	vector<SipUri> mUriList;
@@ -951,11 +1030,11 @@ vector<string> ModuleRouter::split(const char* data, const char* delim) {
 
 ModuleRouter::ForkRefList ModuleRouter::getLateForks(const std::string& key) const noexcept {
 	ForkRefList lateForks{};
-	lateForks.reserve(mForks.count(key));
-	auto range = mForks.equal_range(key);
-	for (auto it = range.first; it != range.second; ++it) {
-		const auto& forkCtx = it->second;
-		if (forkCtx->getConfig()->mForkLate) lateForks.emplace_back(it->second);
+	const auto* forks = mForks.find(key);
+	if (forks == nullptr) return lateForks;
+	lateForks.reserve(forks->size());
+	for (const auto& forkCtx : *forks) {
+		if (forkCtx->getConfig()->mForkLate) lateForks.emplace_back(forkCtx);
 	}
 	return lateForks;
 }
@@ -1061,24 +1140,11 @@ void ModuleRouter::onResponse(shared_ptr<ResponseSipEvent>& ev) {
 }
 
 void ModuleRouter::onForkContextFinished(const shared_ptr<ForkContext>& ctx) {
-	const auto& keys = ctx->getKeys();
-	for (const auto& key : keys) {
-		SLOGD << "Looking at fork contexts with key " << key;
-
-		auto range = mForks.equal_range(key);
-		for (auto it = range.first; it != range.second;) {
-			if (it->second == ctx) {
-				SLOGD << "Remove fork " << it->first << " from store";
-				mStats.mCountForks->incrFinish();
-				auto cur_it = it;
-				++it;
-				// for some reason the multimap erase does not return the next iterator !
-				mForks.erase(cur_it);
-				// do not break, because a single fork context might appear several time in the map because of aliases.
-			} else {
-				++it;
-			}
-		}
+	// A single fork context might be stored several times, with different keys, because of aliases.
+	const auto removed = mForks.remove(ctx->getKeys(), ctx);
+	if (removed > 0) SLOGD << "Removed fork " << ctx.get() << " from store (" << removed << " key(s))";
+	for (auto i = 0u; i < removed; i++) {
+		mStats.mCountForks->incrFinish();
 	}
 }
 
@@ -47,6 +47,9 @@ public:
 	virtual void onResponse([[maybe_unused]] shared_ptr<ResponseSipEvent>& ev) {
 		// don't check our responses ;)
 	}
+	SipMethodSet getHandledResponseMethods() const override {
+		return {};
+	}
 
 private:
 	ModuleSanityChecker(Agent* ag, const ModuleInfoBase* moduleInfo) : Module(ag, moduleInfo) {
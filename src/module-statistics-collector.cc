@@ -39,6 +39,9 @@ public:
 	virtual void onLoad(const GenericStruct* root);
 	virtual void onRequest(shared_ptr<RequestSipEvent>& ev);
 	virtual void onResponse(shared_ptr<ResponseSipEvent>& ev);
+	SipMethodSet getHandledResponseMethods() const override {
+		return {};
+	}
 
 private:
 	StatisticsCollector(Agent* ag, const ModuleInfoBase* moduleInfo);
@@ -18,13 +18,21 @@
 
 #include "module-transcode.hh"
 
+#include <algorithm>
 #include <charconv>
+#include <cstring>
 #include <functional>
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 #include "module-toolbox.hh"
 #include "transaction/outgoing-transaction.hh"
 
 using namespace std;
+using namespace std::chrono_literals;
 using namespace flexisip;
 
 ModuleInfo<Transcoder> Transcoder::sInfo(
@@ -62,6 +70,12 @@ ModuleInfo<Transcoder> Transcoder::sInfo(
 	         "usage "
 	         "and server load on reliable networks.",
 	         "false"},
+	        {Integer, "max-ticker-load",
+	         "Average load, in percent of the tick interval, beyond which a transcoding thread does not accept new "
+	         "calls. New calls are given to the least loaded thread, and are not transcoded at all when every thread "
+	         "is beyond this limit.",
+	         "80"},
+	        {Boolean, "pin-tickers", "Pin each transcoding thread to its own CPU core (Linux only).", "true"},
 	        config_item_end};
 	    moduleConfig.addChildrenValues(items);
 	    moduleConfig.createStatPair("count-calls", "Number of transcoded calls.");
@@ -74,6 +88,8 @@ Transcoder::~Transcoder() {
 }
 void Transcoder::onLoad(const GenericStruct*) {
 }
+void Transcoder::onUnload() {
+}
 void Transcoder::onIdle() {
 }
 void Transcoder::onRequest(shared_ptr<RequestSipEvent>&) {
@@ -124,6 +140,71 @@ static list<PayloadType*> makeSupportedAudioPayloadList() {
 	return l;
 }
 
+namespace {
+// Rough load of a transcoded call, in percent of the tick interval, accounted to a ticker for the calls it has just been
+// given, until they show in its load average.
+constexpr auto kJoinLoadEstimate = 2.0f;
+constexpr auto kLoadRefreshPeriod = 2s;
+} // namespace
+
+TickerManager::~TickerManager() {
+	for (const auto& slot : mTickers) {
+		ms_ticker_destroy(slot.ticker);
+	}
+}
+
+void TickerManager::start() {
+	const auto cpuCount = ModuleToolbox::getCpuCount();
+	for (int i = 0; i < cpuCount; ++i) {
+		const auto name = "Transcoder ticker " + to_string(i);
+		MSTickerParams params{};
+		params.prio = MS_TICKER_PRIO_HIGH;
+		params.name = name.c_str();
+		auto* ticker = ms_ticker_new_with_params(&params);
+#ifdef __linux__
+		if (mPinToCores) {
+			cpu_set_t cpuSet;
+			CPU_ZERO(&cpuSet);
+			CPU_SET(i, &cpuSet);
+			if (const auto err = pthread_setaffinity_np(ticker->thread, sizeof(cpuSet), &cpuSet); err != 0) {
+				SLOGW << "Transcoder: could not pin ticker " << i << " to its CPU core: " << strerror(err);
+			}
+		}
+#endif
+		mTickers.push_back({ticker, 0});
+	}
+	mLastRefresh = chrono::steady_clock::now();
+}
+
+MSTicker* TickerManager::chooseOne() {
+	if (mTickers.empty()) start();
+
+	const auto now = chrono::steady_clock::now();
+	if (now - mLastRefresh > kLoadRefreshPeriod) {
+		for (auto& slot : mTickers) {
+			slot.recentJoins = 0;
+		}
+		mLastRefresh = now;
+	}
+
+	const auto estimatedLoad = [](const Slot& slot) {
+		return ms_ticker_get_average_load(slot.ticker) + slot.recentJoins * kJoinLoadEstimate;
+	};
+	auto& best = *min_element(mTickers.begin(), mTickers.end(), [&estimatedLoad](const Slot& a, const Slot& b) {
+		return estimatedLoad(a) < estimatedLoad(b);
+	});
+	best.recentJoins++;
+	return best.ticker;
+}
+
+bool TickerManager::saturated() {
+	if (mTickers.empty()) start();
+
+	return all_of(mTickers.begin(), mTickers.end(), [this](const Slot& slot) {
+		return ms_ticker_get_average_load(slot.ticker) + slot.recentJoins * kJoinLoadEstimate >= mMaxLoad;
+	});
+}
+
 bool Transcoder::hasSupportedCodec(const std::list<PayloadType*>& ioffer) {
 	for (auto e1 = ioffer.cbegin(); e1 != ioffer.cend(); ++e1) {
 		PayloadType* p1 = *e1;
@@ -188,6 +269,15 @@ void Transcoder::onLoad(const GenericStruct* mc) {
 	mRemoveBandwidthsLimits = mc->get<ConfigBoolean>("remove-bw-limits")->read();
 	list<PayloadType*> l = makeSupportedAudioPayloadList();
 	mSupportedAudioPayloads = orderList(mc->get<ConfigStringList>("audio-codecs")->read(), l);
+	mTickerManager.configure(mc->get<ConfigInt>("max-ticker-load")->read(),
+	                         mc->get<ConfigBoolean>("pin-tickers")->read());
+}
+
+void Transcoder::onUnload() {
+	if (mTimer) {
+		getAgent()->stopTimer(mTimer);
+		mTimer = nullptr;
+	}
 }
 
 void Transcoder::onIdle() {
@@ -346,6 +436,12 @@ void Transcoder::onRequest(shared_ptr<RequestSipEvent>& ev) {
 	sip_t* sip = ms->getSip();
 
 	if (sip->sip_request->rq_method == sip_method_invite) {
+		// Only new calls are bypassed: re-INVITEs of transcoded calls must keep going through the transcoder.
+		if (mTickerManager.saturated() &&
+		    (sip->sip_to->a_tag == nullptr || mCalls.find(getAgent(), sip, true) == nullptr)) {
+			LOGW("Transcoder: all tickers are saturated, doing bypass.");
+			return;
+		}
 		ev->createIncomingTransaction();
 		auto ot = ev->createOutgoingTransaction();
 		auto c = make_shared<TranscodedCall>(mFactory, sip, getAgent()->getRtpBindIp());
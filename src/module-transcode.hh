@@ -18,8 +18,7 @@
 
 #pragma once
 
-#include <algorithm>
-#include <functional>
+#include <chrono>
 #include <vector>
 
 #include <flexisip/module.hh>
@@ -39,30 +38,46 @@
 namespace flexisip {
 
 #ifdef ENABLE_TRANSCODER
+/**
+ * Pool of Mediastreamer2 tickers running the transcoding graphs, one per CPU core.
+ * New calls are given to the least loaded ticker, according to the average load reported by Mediastreamer2.
+ */
 class TickerManager {
 public:
-	TickerManager() : mLastTickerIndex(0), mStarted(false) {
-	}
-	MSTicker* chooseOne() {
-		if (!mStarted) {
-			int cpucount = ModuleToolbox::getCpuCount();
-			mLastTickerIndex = 0;
-			for (int i = 0; i < cpucount; ++i) {
-				mTickers.push_back(ms_ticker_new());
-			}
-			mStarted = true;
-		}
-		if (mLastTickerIndex >= mTickers.size()) mLastTickerIndex = 0;
-		return mTickers[mLastTickerIndex++];
-	}
-	~TickerManager() {
-		for_each(mTickers.begin(), mTickers.end(), std::function{ms_ticker_destroy});
+	TickerManager() = default;
+	TickerManager(const TickerManager&) = delete;
+	~TickerManager();
+
+	/**
+	 * @param maxLoad average load, in percent of the tick interval, beyond which a ticker is considered saturated.
+	 * @param pinToCores pin the thread of each ticker to its own CPU core.
+	 */
+	void configure(float maxLoad, bool pinToCores) {
+		mMaxLoad = maxLoad;
+		mPinToCores = pinToCores;
 	}
+	/**
+	 * Return the least loaded ticker, even if it is saturated.
+	 */
+	MSTicker* chooseOne();
+	/**
+	 * Whether all tickers are saturated, meaning that no new call should be transcoded.
+	 */
+	bool saturated();
 
 private:
-	std::vector<MSTicker*> mTickers;
-	unsigned int mLastTickerIndex;
-	bool mStarted;
+	struct Slot {
+		MSTicker* ticker;
+		// Calls given to the ticker since the last refresh of the load average, used to break ties.
+		unsigned int recentJoins;
+	};
+
+	void start();
+
+	std::vector<Slot> mTickers{};
+	std::chrono::steady_clock::time_point mLastRefresh{};
+	float mMaxLoad = 80.0f;
+	bool mPinToCores = false;
 };
 #endif
 
@@ -72,6 +87,7 @@ class Transcoder : public Module {
 public:
 	~Transcoder();
 	virtual void onLoad(const GenericStruct* module_config);
+	virtual void onUnload();
 	virtual void onRequest(std::shared_ptr<RequestSipEvent>& ev);
 	virtual void onResponse(std::shared_ptr<ResponseSipEvent>& ev);
 	virtual void onIdle();
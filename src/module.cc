@@ -102,6 +102,7 @@ void Module::unload() {
 void Module::reload() {
 	onUnload();
 	load();
+	mAgent->buildModuleChains();
 }
 
 void Module::processRequest(shared_ptr<RequestSipEvent>& ev) {
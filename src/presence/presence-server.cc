@@ -32,6 +32,9 @@
 #include "observers/presence-longterm.hh"
 #include "presence/presentity/presentity-manager.hh"
 #include "presence/presentity/presentity-presence-information.hh"
+#if ENABLE_REDIS
+#include "presence/presentity/redis-presentity-manager.hh"
+#endif
 #include "presence/subscription/subscription.hh"
 #include "subscription/body-list-subscription.hh"
 #include "utils/belle-sip-utils.hh"
@@ -86,6 +89,13 @@ auto& defineConfig = ConfigManager::defaultInit().emplace_back([](GenericStruct&
 	     "Example: select login, domain, phone from accounts where phone in (:phones)",
 	     ""},
 	    {Integer, "max-presence-elements", "Maximum number of presence element by identity saved in memory.", "10"},
+	    {String, "presentity-storage",
+	     "Where the state of PUBLISHed presentities is kept:\n"
+	     " * 'memory': in this presence server only\n"
+	     " * 'redis': shared with every presence server using the same Redis server, so that several presence "
+	     "servers can split the subscription load. Redis connection is set up by the 'redis-*' parameters of "
+	     "module::Registrar.",
+	     "memory"},
 
 	    // Hidden parameters
 	    {String, "bypass-condition", "If user agent contains it, can bypass extended notifiy verification.", "false"},
@@ -152,8 +162,24 @@ PresenceServer::PresenceServer(const std::shared_ptr<sofiasip::SuRoot>& root, co
 	mPresenceStats.countPresencePresentity = config->getStatPairPtr("count-presence-presentity");
 	mPresenceStats.countPresenceElement = config->getStatPairPtr("count-presence-element");
 	mPresenceStats.countPresenceElementMap = config->getStatPairPtr("count-presence-element-map");
-	mPresentityManager = std::make_unique<PresentityManager>(mStack, mPresenceStats,
-	                                                         config->get<ConfigInt>("max-presence-elements")->read());
+	const auto maxPresenceElements = config->get<ConfigInt>("max-presence-elements")->read();
+	const auto* presentityStorage = config->get<ConfigString>("presentity-storage");
+	if (presentityStorage->read() == "redis") {
+#if ENABLE_REDIS
+		mPresentityManager = std::make_unique<RedisPresentityManager>(
+		    *mRoot, mStack, mPresenceStats, maxPresenceElements,
+		    redis::async::RedisParameters::fromRegistrarConf(
+		        mConfigManager->getRoot()->get<GenericStruct>("module::Registrar")));
+#else
+		LOGF("'%s' is set to 'redis' but Flexisip has been built without Redis support",
+		     presentityStorage->getCompleteName().c_str());
+#endif
+	} else if (presentityStorage->read() == "memory") {
+		mPresentityManager = std::make_unique<PresentityManager>(mStack, mPresenceStats, maxPresenceElements);
+	} else {
+		LOGF("Invalid value for '%s': '%s'", presentityStorage->getCompleteName().c_str(),
+		     presentityStorage->read().c_str());
+	}
 
 	mProvider = belle_sip_stack_create_provider(mStack, nullptr);
 	mMaxPresenceInfoNotifiedAtATime = config->get<ConfigInt>("notify-limit")->read();
@@ -168,19 +168,7 @@ string PresentityPresenceInformation::setOrUpdate(Xsd::Pidf::Presence::TupleSequ
 	belle_sip_random_token(generatedETag_char, sizeof(generatedETag_char));
 	string generatedETag = generatedETag_char;
 
-	// cb function to invalidate an unrefreshed etag;
-	auto func = [this, generatedETag](unsigned int) {
-		// find information element
-		SLOGD << "eTag [" << generatedETag << "] has expired";
-		this->removeTuplesForEtag(generatedETag);
-		mPresentityManager.invalidateETag(generatedETag);
-		return BELLE_SIP_STOP;
-	};
-	constexpr unsigned int valMax = numeric_limits<unsigned int>::max() / 1000U;
-	unsigned int expiresMs = (static_cast<unsigned int>(expires) > valMax) ? numeric_limits<unsigned int>::max()
-	                                                                       : static_cast<unsigned int>(expires) * 1000U;
-	// create timer
-	auto timer = belle_sip_main_loop_create_cpp_timeout(mBelleSipMainloop, func, expiresMs, "timer for presence Info");
+	auto timer = createEtagExpirationTimer(generatedETag, expires);
 
 	if (etagAlreadyPresent) {
 		mPresentityManager.modifyEtag(*eTag, generatedETag);
@@ -199,6 +187,39 @@ string PresentityPresenceInformation::setOrUpdate(Xsd::Pidf::Presence::TupleSequ
 	return generatedETag;
 }
 
+void PresentityPresenceInformation::putRemoteTuples(Xsd::Pidf::Presence::TupleSequence& tuples,
+                                                    Xsd::DataModel::Person& person,
+                                                    const std::string& eTag,
+                                                    int expires) {
+	if (mInformationElements->isEtagPresent(eTag)) {
+		mInformationElements->removeByEtag(eTag, false);
+	} else {
+		mPresentityManager.addEtag(shared_from_this(), eTag);
+	}
+
+	auto informationElement = make_unique<PresenceInformationElement>(
+	    &tuples, &person, eTag, createEtagExpirationTimer(eTag, expires), mCountPresenceElement);
+	SLOGD << "Remote presence information element [" << informationElement.get() << "] with etag [" << eTag
+	      << "] stored for presentity [" << *this << "]";
+	mInformationElements->emplace(eTag, std::move(informationElement));
+}
+
+BelleSipSourcePtr PresentityPresenceInformation::createEtagExpirationTimer(const std::string& eTag, int expires) {
+	// cb function to invalidate an unrefreshed etag;
+	auto func = [this, eTag](unsigned int) {
+		// find information element
+		SLOGD << "eTag [" << eTag << "] has expired";
+		this->removeTuplesForEtag(eTag);
+		mPresentityManager.invalidateETag(eTag);
+		return BELLE_SIP_STOP;
+	};
+	constexpr unsigned int valMax = numeric_limits<unsigned int>::max() / 1000U;
+	unsigned int expiresMs = (static_cast<unsigned int>(expires) > valMax) ? numeric_limits<unsigned int>::max()
+	                                                                       : static_cast<unsigned int>(expires) * 1000U;
+	// create timer
+	return belle_sip_main_loop_create_cpp_timeout(mBelleSipMainloop, func, expiresMs, "timer for presence Info");
+}
+
 string PresentityPresenceInformation::refreshTuplesForEtag(const string& eTag, int expires) {
 	return setOrUpdate(nullptr, nullptr, eTag, expires);
 }
@@ -76,6 +76,15 @@ public:
 	                         const std::string& eTag,
 	                         int expires);
 
+	/*
+	 * Store tuples published through another presence server sharing its state with this one, keeping the eTag it
+	 * generated. Replace the tuples previously stored for this eTag, if any.
+	 */
+	void putRemoteTuples(Xsd::Pidf::Presence::TupleSequence& tuples,
+	                     Xsd::DataModel::Person& person,
+	                     const std::string& eTag,
+	                     int expires);
+
 	/**
 	 * Refresh a publish
 	 * @return new eTag
@@ -169,6 +178,11 @@ private:
 	                        std::optional<const std::string> eTag,
 	                        int expires);
 
+	/*
+	 * create the timer invalidating an unrefreshed eTag
+	 */
+	BelleSipSourcePtr createEtagExpirationTimer(const std::string& eTag, int expires);
+
 	/*
 	 *Notify all listener
 	 */
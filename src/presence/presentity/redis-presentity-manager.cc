@@ -0,0 +1,326 @@
+/*
+    Flexisip, a flexible SIP proxy server with media capabilities.
+    Copyright (C) 2010-2024 Belledonne Communications SARL, All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "redis-presentity-manager.hh"
+
+#include <chrono>
+#include <sstream>
+#include <vector>
+
+#include <belle-sip/belle-sip.h>
+
+#include "flexisip/logmanager.hh"
+
+#include "libhiredis-wrapper/redis-args-packer.hh"
+#include "presentity-presence-information.hh"
+#include "utils/variant-utils.hh"
+#include "xml/pidf+xml.hh"
+
+using namespace std;
+using namespace std::chrono;
+
+namespace flexisip {
+using namespace redis;
+using namespace redis::async;
+
+namespace {
+constexpr size_t kNodeIdSize = 12;
+
+// Store a publication, remove the one it replaces, and only ever extend the lifetime of the presentity hash so that it
+// expires with its latest publication.
+// KEYS[1]: presentity key, ARGV: eTag, stored value, expires (in seconds), replaced eTag (may be empty)
+constexpr auto kStorePublicationScript = R"lua(
+redis.call('HSET', KEYS[1], ARGV[1], ARGV[2])
+if ARGV[4] ~= '' then
+	redis.call('HDEL', KEYS[1], ARGV[4])
+end
+if redis.call('TTL', KEYS[1]) < tonumber(ARGV[3]) then
+	redis.call('EXPIRE', KEYS[1], ARGV[3])
+end
+)lua";
+
+void logUnexpectedReply(Session&, Reply reply) {
+	if (const auto* error = get_if<reply::Error>(&reply)) {
+		SLOGE << "RedisPresentityManager - Redis command failed: " << *error;
+	}
+}
+} // namespace
+
+RedisPresentityManager::RedisPresentityManager(const sofiasip::SuRoot& root,
+                                               belle_sip_stack_t* stack,
+                                               const PresenceStats& presenceStats,
+                                               size_t maxElementsByEntity,
+                                               const RedisParameters& redisParams)
+    : PresentityManager(stack, presenceStats, maxElementsByEntity) {
+	char nodeId[kNodeIdSize];
+	belle_sip_random_token(nodeId, sizeof(nodeId));
+	mNodeId = nodeId;
+
+	mRedisClient =
+	    make_unique<RedisClient>(root, redisParams, SoftPtr<SessionListener>::fromObjectLivingLongEnough(*this));
+	mRedisClient->connect();
+}
+
+string RedisPresentityManager::toString(const belle_sip_uri_t* uri) {
+	char* uriAsString = belle_sip_uri_to_string(uri);
+	string result{uriAsString};
+	belle_sip_free(uriAsString);
+	return result;
+}
+
+string RedisPresentityManager::handlePublishFor(const belle_sip_uri_t* entityUri,
+                                                const std::string& eTag,
+                                                const std::unique_ptr<Xsd::Pidf::Presence>&& presence,
+                                                int expires) {
+	stringstream pidf{};
+	try {
+		Xsd::XmlSchema::NamespaceInfomap map;
+		map[""].name = "urn:ietf:params:xml:ns:pidf";
+		Xsd::Pidf::serializePresence(pidf, *presence, map);
+	} catch (const Xsd::XmlSchema::Exception& e) {
+		SLOGE << "RedisPresentityManager - cannot serialize publication of [" << entityUri
+		      << "], it will not be shared: " << e;
+	}
+
+	auto newEtag = PresentityManager::handlePublishFor(entityUri, eTag, std::move(presence), expires);
+	if (const auto& document = pidf.str(); !document.empty()) {
+		storePublication(toString(entityUri), newEtag, document, expires, eTag);
+	}
+	return newEtag;
+}
+
+string RedisPresentityManager::handlePublishRefreshedFor(const string& eTag, int expires) {
+	optional<Publication> publication{};
+	if (const auto it = mPublications.find(eTag); it != mPublications.end()) {
+		publication = it->second;
+	}
+
+	// When expires is 0, the eTag is removed through invalidateETag()
+	auto newEtag = PresentityManager::handlePublishRefreshedFor(eTag, expires);
+	if (expires != 0 && publication) {
+		storePublication(publication->entity, newEtag, publication->pidf, expires, eTag);
+	}
+	return newEtag;
+}
+
+void RedisPresentityManager::invalidateETag(const string& eTag) {
+	PresentityManager::invalidateETag(eTag);
+
+	const auto it = mPublications.find(eTag);
+	if (it == mPublications.end()) return;
+	const auto entity = it->second.entity;
+	if (it->second.remote) forgetRemoteEtag(entity, eTag);
+	mPublications.erase(it);
+
+	// Every presence server knowing this publication expires it at the same time, the first one cleans Redis up.
+	const auto* session = mRedisClient->tryGetCmdSession();
+	if (!session) return;
+	session->timedCommand({"HDEL", keyFor(entity), eTag}, logUnexpectedReply);
+	publishChange(entity);
+}
+
+void RedisPresentityManager::addOrUpdateListener(shared_ptr<PresentityPresenceInformationListener>& listener,
+                                                 int expires) {
+	const auto alreadyWatched = hasLocalListeners(listener->getPresentityUri());
+	PresentityManager::addOrUpdateListener(listener, expires);
+	if (!alreadyWatched) fetchPresentity(toString(listener->getPresentityUri()));
+}
+
+void RedisPresentityManager::addOrUpdateListeners(list<shared_ptr<PresentityPresenceInformationListener>>& listeners,
+                                                  int expires) {
+	list<string> entitiesToFetch{};
+	for (const auto& listener : listeners) {
+		if (!hasLocalListeners(listener->getPresentityUri())) {
+			entitiesToFetch.push_back(toString(listener->getPresentityUri()));
+		}
+	}
+	PresentityManager::addOrUpdateListeners(listeners, expires);
+	for (const auto& entity : entitiesToFetch) {
+		fetchPresentity(entity);
+	}
+}
+
+void RedisPresentityManager::storePublication(const string& entity,
+                                              const string& eTag,
+                                              const string& pidf,
+                                              int expires,
+                                              const string& replacedEtag) {
+	if (!replacedEtag.empty()) {
+		if (const auto it = mPublications.find(replacedEtag); it != mPublications.end()) {
+			if (it->second.remote) forgetRemoteEtag(entity, replacedEtag);
+			mPublications.erase(it);
+		}
+	}
+	mPublications[eTag] = Publication{entity, pidf, false};
+
+	const auto* session = mRedisClient->tryGetCmdSession();
+	if (!session) {
+		SLOGW << "RedisPresentityManager - not connected to Redis, publication [" << eTag << "] of [" << entity
+		      << "] is not shared with other presence servers";
+		return;
+	}
+
+	const auto expiresAt = system_clock::to_time_t(system_clock::now()) + expires;
+	const auto storedValue = to_string(expiresAt) + " " + pidf;
+	session->timedCommand(
+	    {"EVAL", kStorePublicationScript, "1", keyFor(entity), eTag, storedValue, to_string(expires), replacedEtag},
+	    logUnexpectedReply);
+	publishChange(entity);
+}
+
+void RedisPresentityManager::publishChange(const string& entity) {
+	const auto* session = mRedisClient->tryGetCmdSession();
+	if (!session) return;
+	session->command({"PUBLISH", string{kChannel}, mNodeId + " " + entity}, logUnexpectedReply);
+}
+
+void RedisPresentityManager::fetchPresentity(const string& entity) {
+	const auto* session = mRedisClient->tryGetCmdSession();
+	if (!session) return;
+	session->timedCommand({"HGETALL", keyFor(entity)}, [this, entity](Session&, Reply reply) {
+		if (const auto* publications = get_if<reply::Array>(&reply)) {
+			onPresentityFetched(entity, *publications);
+		} else if (!holds_alternative<reply::Disconnected>(reply)) {
+			SLOGE << "RedisPresentityManager - unexpected reply while fetching [" << entity << "]: " << StreamableVariant(reply);
+		}
+	});
+}
+
+void RedisPresentityManager::onPresentityFetched(const string& entity, const reply::Array& publications) {
+	bellesip::shared_ptr<belle_sip_uri_t> entityUri{belle_sip_uri_parse(entity.c_str())};
+	const auto presenceInfo = entityUri ? getPresenceInfo(entityUri.get()) : nullptr;
+	if (!presenceInfo) return;
+
+	const auto now = system_clock::to_time_t(system_clock::now());
+	auto& remoteEtags = mRemoteEtagsByEntity[entity];
+	unordered_set<string> storedEtags{};
+	vector<string> expiredEtags{};
+	for (const auto& [field, value] : publications.pairwise()) {
+		try {
+			const auto eTag = string{get<reply::String>(field)};
+			const auto& storedValue = get<reply::String>(value);
+			const auto separator = storedValue.find(' ');
+			if (separator == string_view::npos) continue;
+			const auto expiresAt = stol(string{storedValue.substr(0, separator)});
+			if (expiresAt <= now) {
+				// Left over by a presence server that went away before the publication expired
+				expiredEtags.push_back(eTag);
+				continue;
+			}
+			storedEtags.insert(eTag);
+
+			const auto pidf = string{storedValue.substr(separator + 1)};
+			auto [publication, inserted] = mPublications.try_emplace(eTag, Publication{entity, pidf, true});
+			if (!inserted) {
+				// own publication, or remote publication already known
+				if (!publication->second.remote || publication->second.pidf == pidf) continue;
+				publication->second.pidf = pidf;
+			}
+			remoteEtags.insert(eTag);
+
+			istringstream data{pidf};
+			const auto presence = Xsd::Pidf::parsePresence(data, Xsd::XmlSchema::Flags::dont_validate);
+			presenceInfo->putRemoteTuples(presence->getTuple(), presence->getPerson().get(), eTag,
+			                              static_cast<int>(expiresAt - now));
+		} catch (const bad_variant_access&) {
+			SLOGE << "RedisPresentityManager - unexpected publication format for [" << entity << "]";
+		} catch (const invalid_argument&) {
+			SLOGE << "RedisPresentityManager - invalid publication expiration for [" << entity << "]";
+		} catch (const Xsd::XmlSchema::Exception& e) {
+			SLOGE << "RedisPresentityManager - cannot parse publication of [" << entity << "]: " << e;
+		}
+	}
+
+	// Remote publications missing from Redis were removed or refreshed (under a new eTag) through another server.
+	for (auto it = remoteEtags.begin(); it != remoteEtags.end();) {
+		if (storedEtags.count(*it) != 0) {
+			++it;
+			continue;
+		}
+		const auto eTag = *it;
+		it = remoteEtags.erase(it);
+		mPublications.erase(eTag);
+		presenceInfo->removeTuplesForEtag(eTag);
+		PresentityManager::invalidateETag(eTag);
+	}
+	if (remoteEtags.empty()) mRemoteEtagsByEntity.erase(entity);
+
+	if (expiredEtags.empty()) return;
+	const auto* session = mRedisClient->tryGetCmdSession();
+	if (!session) return;
+	ArgsPacker command{"HDEL", keyFor(entity)};
+	command.addArgs(expiredEtags);
+	session->timedCommand(command, logUnexpectedReply);
+}
+
+void RedisPresentityManager::forgetRemoteEtag(const string& entity, const string& eTag) {
+	const auto it = mRemoteEtagsByEntity.find(entity);
+	if (it == mRemoteEtagsByEntity.end()) return;
+	it->second.erase(eTag);
+	if (it->second.empty()) mRemoteEtagsByEntity.erase(it);
+}
+
+bool RedisPresentityManager::hasLocalListeners(const belle_sip_uri_t* entityUri) const {
+	const auto presenceInfo = getPresenceInfo(entityUri);
+	return presenceInfo && presenceInfo->getNumberOfListeners() > 0;
+}
+
+void RedisPresentityManager::onConnect(int status) {
+	if (status != REDIS_OK) return;
+
+	const auto* ready = mRedisClient->tryGetSubSession();
+	if (!ready) return;
+
+	auto subscription = ready->subscriptions()[kChannel];
+	if (subscription.subscribed()) return;
+
+	SLOGD << "RedisPresentityManager - subscribing to presentity updates of other presence servers";
+	subscription.subscribe([this](auto topic, Reply reply) { handlePresentityUpdatePublish(topic, reply); });
+}
+
+void RedisPresentityManager::handlePresentityUpdatePublish(std::string_view topic, Reply reply) {
+	if (holds_alternative<reply::Disconnected>(reply)) {
+		SLOGD << "RedisPresentityManager - subscription to '" << topic << "' disconnected.";
+		return;
+	}
+	try {
+		const auto& array = get<reply::Array>(reply);
+		const auto messageType = get<reply::String>(array[0]);
+		if (messageType != "message") return;
+
+		const auto payload = get<reply::String>(array[2]);
+		const auto separator = payload.find(' ');
+		if (separator == string_view::npos) return;
+		// Changes made through this presence server are already applied
+		if (payload.substr(0, separator) == mNodeId) return;
+
+		const auto entity = string{payload.substr(separator + 1)};
+		bellesip::shared_ptr<belle_sip_uri_t> entityUri{belle_sip_uri_parse(entity.c_str())};
+		if (entityUri && hasLocalListeners(entityUri.get())) fetchPresentity(entity);
+	} catch (const bad_variant_access&) {
+		SLOGE << "RedisPresentityManager - presentity update from Redis not well formatted";
+	}
+}
+
+void RedisPresentityManager::onDisconnect(int status) {
+	if (status != REDIS_OK) {
+		SLOGE << "RedisPresentityManager - disconnected from Redis. Status: " << status << ". Try reconnect ...";
+	}
+}
+
+} // namespace flexisip
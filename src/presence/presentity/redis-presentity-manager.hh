@@ -0,0 +1,103 @@
+/*
+    Flexisip, a flexible SIP proxy server with media capabilities.
+    Copyright (C) 2010-2024 Belledonne Communications SARL, All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "flexisip/sofia-wrapper/su-root.hh"
+
+#include "libhiredis-wrapper/redis-parameters.hh"
+#include "libhiredis-wrapper/replication/redis-client.hh"
+#include "presence/presentity/presentity-manager.hh"
+
+namespace flexisip {
+
+/**
+ * PresentityManager sharing the state of PUBLISHed presentities with other presence servers through Redis.
+ *
+ * Every publication is stored in a Redis hash per presentity ("presence:<entity>", one field per eTag) and each
+ * change is announced on the "flexisip/presence" channel. Presence servers having local subscribers to the presentity
+ * then reload the hash, so that subscribers are notified whatever the presence server the PUBLISH went through.
+ * Reloaded publications keep their eTag, so they can also be refreshed or modified through any presence server.
+ * The hash expires with its latest publication, and expired fields are removed whenever the hash is reloaded.
+ */
+class RedisPresentityManager : public PresentityManager, public redis::async::SessionListener {
+public:
+	RedisPresentityManager(const sofiasip::SuRoot& root,
+	                       belle_sip_stack_t* stack,
+	                       const PresenceStats& presenceStats,
+	                       size_t maxElementsByEntity,
+	                       const redis::async::RedisParameters& redisParams);
+
+	std::string handlePublishFor(const belle_sip_uri_t* entityUri,
+	                             const std::string& eTag,
+	                             const std::unique_ptr<Xsd::Pidf::Presence>&& presence,
+	                             int expires) override;
+	std::string handlePublishRefreshedFor(const std::string& eTag, int expires) override;
+	void invalidateETag(const std::string& eTag) override;
+
+	void addOrUpdateListener(std::shared_ptr<PresentityPresenceInformationListener>& listener, int expires) override;
+	void addOrUpdateListeners(std::list<std::shared_ptr<PresentityPresenceInformationListener>>& listeners,
+	                          int expires) override;
+
+	/* redis::async::SessionListener */
+	void onConnect(int status) override;
+	void onDisconnect(int status) override;
+
+	static constexpr std::string_view kChannel = "flexisip/presence";
+	// Kept out of the "fs:" namespace, which is scanned as registrar records.
+	static constexpr std::string_view kKeyPrefix = "presence:";
+
+private:
+	// A publication as stored in Redis, either made through this presence server or through another one.
+	struct Publication {
+		std::string entity;
+		std::string pidf;
+		bool remote;
+	};
+
+	static std::string toString(const belle_sip_uri_t* uri);
+	static std::string keyFor(const std::string& entity) {
+		return std::string{kKeyPrefix} + entity;
+	}
+
+	void storePublication(const std::string& entity,
+	                      const std::string& eTag,
+	                      const std::string& pidf,
+	                      int expires,
+	                      const std::string& replacedEtag);
+	void publishChange(const std::string& entity);
+	// Reload state of the presentity from Redis, if it is known locally.
+	void fetchPresentity(const std::string& entity);
+	void onPresentityFetched(const std::string& entity, const redis::reply::Array& publications);
+	void handlePresentityUpdatePublish(std::string_view topic, redis::async::Reply reply);
+	bool hasLocalListeners(const belle_sip_uri_t* entityUri) const;
+	// Remove a remote eTag of the presentity, and the presentity entry when it was its last one.
+	void forgetRemoteEtag(const std::string& entity, const std::string& eTag);
+
+	std::string mNodeId;
+	std::unique_ptr<redis::async::RedisClient> mRedisClient;
+	std::unordered_map<std::string /*eTag*/, Publication> mPublications;
+	std::unordered_map<std::string /*entity*/, std::unordered_set<std::string>> mRemoteEtagsByEntity;
+};
+
+} // namespace flexisip
@@ -57,35 +57,46 @@ ListSubscription::~ListSubscription() {
 	SLOGD << "List subscription [" << this << "] deleted";
 };
 
+const ListSubscription::InstanceBodyPart&
+ListSubscription::updateInstanceBodyPart(const string& entityUri,
+                                         PresentityPresenceInformation& presentityInformation,
+                                         bool extended) {
+	auto& bodyPart = mInstanceBodyParts[entityUri];
+	if (bodyPart.cid.empty()) {
+		// Content-Id only needs to be unique within a NOTIFY, so it can be kept for the whole subscription
+		char cid_rand_part[8];
+		belle_sip_random_token(cid_rand_part, sizeof(cid_rand_part));
+		ostringstream cid;
+		cid << cid_rand_part << "@" << belle_sip_uri_get_host(mName.get());
+		bodyPart.cid = cid.str();
+	}
+	bodyPart.pidf = presentityInformation.getPidf(extended);
+	bodyPart.extended = extended;
+	bodyPart.presentity = presentityInformation.shared_from_this();
+	SLOGI << "Presence info " << (extended ? "(extended)" : "(non-extended)") << " updated in list [" << mName.get()
+	      << " for entity [" << presentityInformation.getEntity() << "]";
+	return bodyPart;
+}
+
 void ListSubscription::addInstanceToResource(Xsd::Rlmi::Resource& resource,
                                              list<belle_sip_body_handler_t*>& multipartList,
-                                             PresentityPresenceInformation& presentityInformation,
-                                             bool extended) {
+                                             const InstanceBodyPart& bodyPart) {
 
 	// we have a resource instance
 	// subscription state is always active until we implement ACL
 	Xsd::Rlmi::Instance instance("1", Xsd::Rlmi::State::active);
-	char cid_rand_part[8];
-	belle_sip_random_token(cid_rand_part, sizeof(cid_rand_part));
-	ostringstream cid;
-	cid << cid_rand_part << "@" << belle_sip_uri_get_host(mName.get());
-	instance.setCid(cid.str());
-	string pidf = presentityInformation.getPidf(extended);
-	belle_sip_memory_body_handler_t* bodyPart =
-	    belle_sip_memory_body_handler_new_copy_from_buffer((void*)pidf.c_str(), pidf.length(), nullptr, nullptr);
-	belle_sip_body_handler_add_header(BELLE_SIP_BODY_HANDLER(bodyPart),
+	instance.setCid(bodyPart.cid);
+	belle_sip_memory_body_handler_t* memoryBodyPart = belle_sip_memory_body_handler_new_copy_from_buffer(
+	    (void*)bodyPart.pidf.c_str(), bodyPart.pidf.length(), nullptr, nullptr);
+	belle_sip_body_handler_add_header(BELLE_SIP_BODY_HANDLER(memoryBodyPart),
 	                                  belle_sip_header_create("Content-Transfer-Encoding", "binary"));
-	ostringstream content_id;
-	content_id << "<" << cid.str() << ">";
-	belle_sip_body_handler_add_header(BELLE_SIP_BODY_HANDLER(bodyPart),
-	                                  belle_sip_header_create("Content-Id", cid.str().c_str()));
+	belle_sip_body_handler_add_header(BELLE_SIP_BODY_HANDLER(memoryBodyPart),
+	                                  belle_sip_header_create("Content-Id", bodyPart.cid.c_str()));
 	belle_sip_body_handler_add_header(
-	    BELLE_SIP_BODY_HANDLER(bodyPart),
+	    BELLE_SIP_BODY_HANDLER(memoryBodyPart),
 	    belle_sip_header_create("Content-Type", "application/pidf+xml;charset=\"UTF-8\""));
-	multipartList.push_back(BELLE_SIP_BODY_HANDLER(bodyPart));
+	multipartList.push_back(BELLE_SIP_BODY_HANDLER(memoryBodyPart));
 	resource.getInstance().push_back(instance);
-	SLOGI << "Presence info " << (extended ? "(extended)" : "(non-extended)") << " added to list [" << mName.get()
-	      << " for entity [" << presentityInformation.getEntity() << "]";
 }
 
 void ListSubscription::notify(bool isFullState) {
@@ -117,42 +128,58 @@ void ListSubscription::notify(bool isFullState) {
 
 		if (isFullState) {
 			SLOGI << "Building full state rlmi for list name [" << mName.get() << "]";
+			size_t instanceCount = 0;
 			for (shared_ptr<PresentityPresenceInformationListener>& resourceListener : mListeners) {
 				char* presentityUri = belle_sip_uri_to_string(resourceListener->getPresentityUri());
-				Xsd::Rlmi::Resource resource(presentityUri);
+				string entityUri{presentityUri};
 				belle_sip_free(presentityUri);
+				Xsd::Rlmi::Resource resource(entityUri);
 				if (!resourceListener->getName().empty()) resource.getName().push_back(resourceListener->getName());
 
-				PendingStateType::iterator it = mPendingStates.find(resourceListener->getPresentityUri());
-				if (it != mPendingStates.end() && it->second.first->isKnown() &&
-				    resourceList.getResource().size() < mMaxPresenceInfoNotifiedAtATime) {
-					PresentityPresenceInformation& presentityInformation = *it->second.first;
-					addInstanceToResource(resource, multipartList, presentityInformation,
-					                      resourceListener->extendedNotifyEnabled());
-					mPendingStates.erase(it); // might be optimized
-				} else {
-					SLOGI << "No presence info yet for uri [" << resourceListener->getPresentityUri() << "]";
+				if (instanceCount < mMaxPresenceInfoNotifiedAtATime) {
+					auto it = mPendingStates.find(entityUri);
+					if (it != mPendingStates.end() && it->second.first->isKnown()) {
+						// presentity changed since last notify, serialize it again
+						addInstanceToResource(resource, multipartList,
+						                      updateInstanceBodyPart(entityUri, *it->second.first,
+						                                             resourceListener->extendedNotifyEnabled()));
+						mPendingStates.erase(it);
+						instanceCount++;
+					} else if (auto cached = mInstanceBodyParts.find(entityUri); cached != mInstanceBodyParts.end()) {
+						const auto extended = resourceListener->extendedNotifyEnabled();
+						auto presentityInformation = cached->second.presentity.lock();
+						if (cached->second.extended == extended) {
+							// unchanged presentity, reuse the body part sent last time
+							addInstanceToResource(resource, multipartList, cached->second);
+							instanceCount++;
+						} else if (presentityInformation && presentityInformation->isKnown()) {
+							// extended notifications were enabled or disabled since, serialize it again
+							addInstanceToResource(resource, multipartList,
+							                      updateInstanceBodyPart(entityUri, *presentityInformation, extended));
+							instanceCount++;
+						} else {
+							SLOGI << "No presence info anymore for uri [" << entityUri << "]";
+						}
+					} else {
+						SLOGI << "No presence info yet for uri [" << entityUri << "]";
+					}
 				}
 				resourceList.getResource().push_back(resource);
 			}
 		} else {
 			SLOGI << "Building partial state rlmi for list name [" << mName.get() << "]";
-			for (PendingStateType::iterator it = mPendingStates.begin();
+			// only presentities changed since last notify are walked, whatever the size of the list
+			for (auto it = mPendingStates.begin();
 			     it != mPendingStates.end() && resourceList.getResource().size() < mMaxPresenceInfoNotifiedAtATime;
 			     /*nop*/) {
-				pair<const belle_sip_uri_t*, pair<shared_ptr<PresentityPresenceInformation>, bool>>
-				    presenceInformationPair = *it;
-				if (presenceInformationPair.second.first->isKnown()) { /* only notify for entity with known state*/
-					shared_ptr<PresentityPresenceInformation> presenceInformation =
-					    presenceInformationPair.second.first;
-					const belle_sip_uri_t* entity = presenceInformation->getEntity();
-					char* presentityUri = belle_sip_uri_to_string(entity);
-					Xsd::Rlmi::Resource resource(presentityUri);
-					belle_sip_free(presentityUri);
+				const auto& [entityUri, pendingState] = *it;
+				const auto& [presenceInformation, extended] = pendingState;
+				if (presenceInformation->isKnown()) { /* only notify for entity with known state*/
+					Xsd::Rlmi::Resource resource(entityUri);
 					if (!presenceInformation->getName().empty())
 						resource.getName().push_back(presenceInformation->getName());
-					addInstanceToResource(resource, multipartList, *presenceInformation,
-					                      presenceInformationPair.second.second);
+					addInstanceToResource(resource, multipartList,
+					                      updateInstanceBodyPart(entityUri, *presenceInformation, extended));
 					resourceList.getResource().push_back(resource);
 				}
 				it = mPendingStates.erase(it); // erase in any case
@@ -189,7 +216,7 @@ void ListSubscription::notify(bool isFullState) {
 			belle_sip_multipart_body_handler_add_part(multiPartBody, additionalPart);
 		}
 
-		Subscription::notify(multiPartBody, "deflate");
+		sendNotify(multiPartBody);
 		mVersion++;
 		mLastNotify = chrono::system_clock::now();
 		if (!mPendingStates.empty() && !mTimer) {
@@ -211,10 +238,16 @@ void ListSubscription::notify(bool isFullState) {
 		                         << "]";
 	}
 }
+void ListSubscription::sendNotify(belle_sip_multipart_body_handler_t* body) {
+	Subscription::notify(body, "deflate");
+}
+
 void ListSubscription::onInformationChanged(PresentityPresenceInformation& presenceInformation, bool extended) {
 	// store state, erase previous one if any
 	if (getState() == State::active) {
-		mPendingStates[presenceInformation.getEntity()] = make_pair(presenceInformation.shared_from_this(), extended);
+		char* entityUri = belle_sip_uri_to_string(presenceInformation.getEntity());
+		mPendingStates[entityUri] = make_pair(presenceInformation.shared_from_this(), extended);
+		belle_sip_free(entityUri);
 
 		if (isTimeToNotify()) {
 			notify(false);
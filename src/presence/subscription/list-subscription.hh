@@ -86,6 +86,8 @@ protected:
 	friend PresentityResourceListener;
 	void onInformationChanged(PresentityPresenceInformation& presenceInformation, bool extended);
 	void finishCreation(belle_sip_server_transaction_t* ist);
+	// send a NOTIFY with the rlmi multipart body built by notify()
+	virtual void sendNotify(belle_sip_multipart_body_handler_t* body);
 
 	std::list<std::shared_ptr<PresentityPresenceInformationListener>> mListeners;
 	/*
@@ -99,16 +101,32 @@ protected:
 	bellesip::shared_ptr<const belle_sip_uri_t> mName{};
 
 private:
+	/*
+	 * Serialized rlmi instance of a presentity, as sent in the last NOTIFY mentioning it.
+	 * Kept so that full state notifications do not have to serialize again presentities that did not change.
+	 */
+	struct InstanceBodyPart {
+		std::string cid;
+		std::string pidf;
+		bool extended;
+		// to serialize it again if the listener switches to or from extended notifications
+		std::weak_ptr<PresentityPresenceInformation> presentity;
+	};
+
 	// return true if a real notify can be sent.
 	bool isTimeToNotify();
+	// serialize presence information of a presentity that changed since last notify and store it in cache
+	const InstanceBodyPart& updateInstanceBodyPart(const std::string& entityUri,
+	                                               PresentityPresenceInformation& presentityInformation,
+	                                               bool extended);
 	void addInstanceToResource(Xsd::Rlmi::Resource& resource,
 	                           std::list<belle_sip_body_handler_t*>& multipartList,
-	                           PresentityPresenceInformation& presentityInformation,
-	                           bool extended);
+	                           const InstanceBodyPart& bodyPart);
 
 	using PendingStateType =
-	    std::unordered_map<const belle_sip_uri_t*, std::pair<std::shared_ptr<PresentityPresenceInformation>, bool>>;
-	PendingStateType mPendingStates; // map of Presentity to be notified by uri
+	    std::unordered_map<std::string, std::pair<std::shared_ptr<PresentityPresenceInformation>, bool>>;
+	PendingStateType mPendingStates; // map of Presentity to be notified (dirty entries) by uri
+	std::unordered_map<std::string, InstanceBodyPart> mInstanceBodyParts; // last notified body part by uri
 	std::chrono::time_point<std::chrono::system_clock> mLastNotify{std::chrono::system_clock::time_point::min()};
 	std::chrono::seconds mMinNotifyInterval{2};
 
@@ -114,14 +114,14 @@ bool RecordSerializerC::serialize(Record* r, string& serialized, bool log) {
 		oss << "#" << ec->getRegisterTime();
 		oss << "#" << ec->callId() << "#" << ec->mCSeq << "#" << (ec->mAlias ? "true" : "false");
 		string pathstr;
-		for (auto pit = ec->mPath.cbegin(); pit != ec->mPath.cend(); ++pit) {
-			if (pit != ec->mPath.cbegin()) pathstr += ",";
+		for (auto pit = ec->getPath().cbegin(); pit != ec->getPath().cend(); ++pit) {
+			if (pit != ec->getPath().cbegin()) pathstr += ",";
 			pathstr += *pit;
 		}
 		oss << "#" << pathstr;
 		string acceptstr;
-		for (auto pit = ec->mAcceptHeader.cbegin(); pit != ec->mAcceptHeader.cend(); ++pit) {
-			if (pit != ec->mAcceptHeader.cbegin()) acceptstr += ",";
+		for (auto pit = ec->getAcceptHeaders().cbegin(); pit != ec->getAcceptHeaders().cend(); ++pit) {
+			if (pit != ec->getAcceptHeaders().cbegin()) acceptstr += ",";
 			acceptstr += *pit;
 		}
 		oss << "#" << acceptstr;
@@ -123,11 +123,11 @@ bool RecordSerializerJson::serialize(Record* r, string& serialized, bool log) {
 		cJSON_AddNumberToObject(c, "alias", ec->mAlias ? 1 : 0);
 		cJSON_AddNumberToObject(c, "update-time", ec->getRegisterTime());
 
-		for (auto pit = ec->mPath.cbegin(); pit != ec->mPath.cend(); ++pit) {
+		for (auto pit = ec->getPath().cbegin(); pit != ec->getPath().cend(); ++pit) {
 			cJSON* pitem = cJSON_CreateString(pit->c_str());
 			cJSON_AddItemToArray(path, pitem);
 		}
-		for (auto pit = ec->mAcceptHeader.cbegin(); pit != ec->mAcceptHeader.cend(); ++pit) {
+		for (auto pit = ec->getAcceptHeaders().cbegin(); pit != ec->getAcceptHeaders().cend(); ++pit) {
 			cJSON* pitem = cJSON_CreateString(pit->c_str());
 			cJSON_AddItemToArray(acceptHeaders, pitem);
 		}
@@ -90,10 +90,10 @@ bool RecordSerializerPb::serialize(Record* r, string& serialized, bool log) {
 		c->set_update_time(ec->getRegisterTime());
 		c->set_call_id(ec->callId());
 		c->set_cseq(ec->mCSeq);
-		for (auto pit = ec->mPath.cbegin(); pit != ec->mPath.cend(); ++pit) {
+		for (auto pit = ec->getPath().cbegin(); pit != ec->getPath().cend(); ++pit) {
 			c->add_path(*pit);
 		}
-		for (auto pit = ec->mAcceptHeader.cbegin(); pit != ec->mAcceptHeader.cend(); ++pit) {
+		for (auto pit = ec->getAcceptHeaders().cbegin(); pit != ec->getAcceptHeaders().cend(); ++pit) {
 			c->add_accept_header(*pit);
 		}
 		c->set_used_as_route(ec->mUsedAsRoute);
@@ -19,6 +19,7 @@
 #include "extended-contact.hh"
 
 #include <chrono>
+#include <utility>
 
 #include <sofia-sip/sip_tag.h>
 
@@ -43,12 +44,13 @@ ostream& ExtendedContact::print(ostream& stream, time_t _now, time_t _offset) co
 
 	stream << "ExtendedContact[" << this << "]( ";
 	stream << urlToString(mSipContact->m_url) << " path=\"";
-	for (auto it = mPath.cbegin(); it != mPath.cend(); ++it) {
-		if (it != mPath.cbegin()) stream << " ";
+	const auto& path = getPath();
+	for (auto it = path.cbegin(); it != path.cend(); ++it) {
+		if (it != path.cbegin()) stream << " ";
 		stream << *it;
 	}
 	stream << "\"";
-	stream << " user-agent=\"" << mUserAgent << "\"";
+	stream << " user-agent=\"" << getUserAgent() << "\"";
 	stream << " alias=" << (mAlias ? "yes" : "no");
 	if (!mAlias) stream << " uid=" << mKey.str();
 	stream << " expire=" << expireAfter << " s (" << buffer << ")";
@@ -104,7 +106,8 @@ sip_contact_t* ExtendedContact::toSofiaContact(su_home_t* home) const {
 sip_route_t* ExtendedContact::toSofiaRoute(su_home_t* home) const {
 	sip_route_t* rbegin = nullptr;
 	sip_route_t* r = nullptr;
-	for (auto it = mPath.begin(); it != mPath.end(); ++it) {
+	const auto& path = getPath();
+	for (auto it = path.begin(); it != path.end(); ++it) {
 		sip_route_t* newr = sip_route_format(home, "<%s>", (*it).c_str());
 		if (!newr) {
 			LOGE("Cannot parse %s into route header", (*it).c_str());
@@ -123,7 +126,8 @@ sip_route_t* ExtendedContact::toSofiaRoute(su_home_t* home) const {
 	return rbegin;
 }
 
-void ExtendedContact::extractInfoFromHeader(const char* urlHeaders) {
+void ExtendedContact::extractInfoFromHeader() const {
+	const auto* urlHeaders = std::exchange(mUrlHeaders, nullptr);
 	if (urlHeaders) {
 		sofiasip::Home home;
 		msg_header_t* headers;
@@ -175,7 +179,7 @@ void ExtendedContact::extractInfoFromHeader(const char* urlHeaders) {
 }
 
 utils::Utf8String ExtendedContact::getDeviceName() const {
-	const string& userAgent = mUserAgent;
+	const string& userAgent = getUserAgent();
 	size_t begin = userAgent.find("(");
 	string deviceName;
 	if (begin != string::npos) {
@@ -221,23 +225,28 @@ string ExtendedContact::serializeAsUrlEncodedParams() {
 	param = string{"usedAsRoute="} + (mUsedAsRoute ? "yes" : "no");
 	url_param_add(home.home(), contact->m_url, param.c_str());
 
-	// Path
-	ostringstream oss_path{};
-	for (auto it = mPath.cbegin(); it != mPath.cend(); ++it) {
-		if (it != mPath.cbegin()) oss_path << ",";
-		oss_path << "<" << *it << ">";
-	}
+	if (mUrlHeaders) {
+		// Never parsed, hence unchanged since they were deserialized
+		contact->m_url->url_headers = mUrlHeaders;
+	} else {
+		// Path
+		ostringstream oss_path{};
+		for (auto it = mPath.cbegin(); it != mPath.cend(); ++it) {
+			if (it != mPath.cbegin()) oss_path << ",";
+			oss_path << "<" << *it << ">";
+		}
 
-	// AcceptHeaders
-	ostringstream oss_accept{};
-	for (auto it = mAcceptHeader.cbegin(); it != mAcceptHeader.cend(); ++it) {
-		if (it != mAcceptHeader.cbegin()) oss_accept << ",";
-		oss_accept << *it;
-	}
+		// AcceptHeaders
+		ostringstream oss_accept{};
+		for (auto it = mAcceptHeader.cbegin(); it != mAcceptHeader.cend(); ++it) {
+			if (it != mAcceptHeader.cbegin()) oss_accept << ",";
+			oss_accept << *it;
+		}
 
-	contact->m_url->url_headers = sip_headers_as_url_query(home.home(), SIPTAG_PATH_STR(oss_path.str().c_str()),
-	                                                       SIPTAG_ACCEPT_STR(oss_accept.str().c_str()),
-	                                                       SIPTAG_USER_AGENT_STR(mUserAgent.c_str()), TAG_END());
+		contact->m_url->url_headers = sip_headers_as_url_query(home.home(), SIPTAG_PATH_STR(oss_path.str().c_str()),
+		                                                       SIPTAG_ACCEPT_STR(oss_accept.str().c_str()),
+		                                                       SIPTAG_USER_AGENT_STR(mUserAgent.c_str()), TAG_END());
+	}
 
 	string contact_string{sip_header_as_string(home.home(), (sip_header_t const*)contact)};
 	return contact_string;
@@ -344,7 +353,8 @@ void ExtendedContact::extractInfoFromUrl(const char* full_url) {
 	// Used as route
 	mUsedAsRoute = extractBoolParam(url, "usedAsRoute");
 
-	extractInfoFromHeader(url->url_headers);
+	// Path, Accept and User-Agent are parsed on demand, see parseHeaders()
+	mUrlHeaders = url->url_headers;
 
 	char transport[20] = {0};
 	url_param(url[0].url_params, "transport", transport, sizeof(transport) - 1);
@@ -24,6 +24,8 @@
 #include <memory>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "submodules/externals/sofia-sip/libsofia-sip-ua/sip/sofia-sip/sip_protos.h"
 
@@ -57,12 +59,9 @@ struct ExtendedContact {
 	std::string mCallId{};
 	ContactKey mKey{}; // If the contact contains an identifier listed in Record::sLineFieldNames, then it is used as
 	                   // key, otherwise a random string
-	std::list<std::string> mPath{}; // list of urls as string (not enclosed with brackets)
-	std::string mUserAgent{};
 	sip_contact_t* mSipContact{nullptr}; // Full contact
 	float mQ{1.0f};
 	uint32_t mCSeq{0};
-	std::list<std::string> mAcceptHeader{};
 	uintptr_t mConnId{0}; // a unique id shared with associate t_port
 	sofiasip::Home mHome{};
 	bool mAlias{false};
@@ -83,14 +82,29 @@ struct ExtendedContact {
 		return urlAsString();
 	}
 	const char* route() const {
-		return (mPath.empty() ? nullptr : mPath.cbegin()->c_str());
+		const auto& path = getPath();
+		return (path.empty() ? nullptr : path.cbegin()->c_str());
 	}
 	const char* userAgent() const {
-		return mUserAgent.c_str();
+		return getUserAgent().c_str();
 	}
 	const std::string& getUserAgent() const {
+		parseHeaders();
 		return mUserAgent;
 	}
+	// List of urls as string (not enclosed with brackets)
+	const std::vector<std::string>& getPath() const {
+		parseHeaders();
+		return mPath;
+	}
+	void addPath(std::string path) {
+		parseHeaders();
+		mPath.push_back(std::move(path));
+	}
+	const std::vector<std::string>& getAcceptHeaders() const {
+		parseHeaders();
+		return mAcceptHeader;
+	}
 	std::time_t getRegisterTime() const {
 		return mRegisterTime;
 	}
@@ -148,7 +162,6 @@ struct ExtendedContact {
 
 	std::string getOrgLinphoneSpecs() const;
 
-	void extractInfoFromHeader(const char* urlHeaders);
 	const std::string getMessageExpires(const msg_param_t* m_params);
 	void init(bool initExpire = true);
 	void extractInfoFromUrl(const char* full_url);
@@ -168,9 +181,9 @@ struct ExtendedContact {
 	                const std::list<std::string>& acceptHeaders,
 	                const std::string& userAgent,
 	                const std::string& messageExpiresName)
-	    : mCallId(common.mCallId), mKey(common.mKey), mPath(common.mPath), mUserAgent(userAgent), mCSeq(cseq),
-	      mAcceptHeader(acceptHeaders), mAlias(alias), mRegisterTime(updateTime),
-	      mMessageExpiresName{messageExpiresName}, mExpires(global_expire) {
+	    : mCallId(common.mCallId), mKey(common.mKey), mCSeq(cseq), mAlias(alias), mRegisterTime(updateTime),
+	      mMessageExpiresName{messageExpiresName}, mExpires(global_expire), mPath(common.mPath.begin(), common.mPath.end()),
+	      mUserAgent(userAgent), mAcceptHeader(acceptHeaders.begin(), acceptHeaders.end()) {
 
 		mSipContact = sip_contact_dup(mHome.home(), sip_contact);
 		mSipContact->m_next = nullptr;
@@ -183,7 +196,7 @@ struct ExtendedContact {
 	 * The new ExtendedConact has the maximum expiration date.
 	 */
 	ExtendedContact(const SipUri& url, const std::string& route, const std::string& messageExpiresName, float q = 1.0)
-	    : mPath({route}), mMessageExpiresName{messageExpiresName}, mExpires(std::chrono::seconds::max()) {
+	    : mMessageExpiresName{messageExpiresName}, mExpires(std::chrono::seconds::max()), mPath({route}) {
 		mSipContact = sip_contact_create(mHome.home(), reinterpret_cast<const url_string_t*>(url.get()), nullptr);
 		q = std::min(1.0f, std::max(0.0f, q)); // force RFC compliance
 		mSipContact->m_q = mHome.sprintf("%.3f", q);
@@ -192,12 +205,14 @@ struct ExtendedContact {
 	}
 
 	ExtendedContact(const ExtendedContact& ec)
-	    : mCallId(ec.mCallId), mKey(ec.mKey), mPath(ec.mPath), mUserAgent(ec.mUserAgent), mSipContact(nullptr),
-	      mQ(ec.mQ), mCSeq(ec.mCSeq), mAcceptHeader(ec.mAcceptHeader), mConnId(ec.mConnId), mHome(), mAlias(ec.mAlias),
-	      mUsedAsRoute(ec.mUsedAsRoute), mIsFallback(ec.mIsFallback), mRegisterTime(ec.mRegisterTime),
-	      mMessageExpiresName(ec.mMessageExpiresName), mExpires(ec.mExpires), mMessageExpires(ec.mMessageExpires) {
+	    : mCallId(ec.mCallId), mKey(ec.mKey), mSipContact(nullptr), mQ(ec.mQ), mCSeq(ec.mCSeq), mConnId(ec.mConnId),
+	      mHome(), mAlias(ec.mAlias), mUsedAsRoute(ec.mUsedAsRoute), mIsFallback(ec.mIsFallback),
+	      mRegisterTime(ec.mRegisterTime), mMessageExpiresName(ec.mMessageExpiresName), mExpires(ec.mExpires),
+	      mMessageExpires(ec.mMessageExpires), mPath(ec.mPath), mUserAgent(ec.mUserAgent),
+	      mAcceptHeader(ec.mAcceptHeader) {
 		mSipContact = sip_contact_dup(mHome.home(), ec.mSipContact);
 		mSipContact->m_next = nullptr;
+		if (ec.mUrlHeaders) mUrlHeaders = su_strdup(mHome.home(), ec.mUrlHeaders);
 	}
 
 	std::ostream& print(std::ostream& stream, time_t _now = getCurrentTime(), time_t offset = 0) const;
@@ -209,10 +224,22 @@ struct ExtendedContact {
 	bool isSame(const ExtendedContact& otherContact) const;
 
 private:
+	/* Path, Accept and User-Agent are not needed to route most requests, so they are only parsed from the headers of
+	 * the serialized contact URL when first accessed. Not thread-safe, like the rest of the class.*/
+	void parseHeaders() const {
+		if (mUrlHeaders) extractInfoFromHeader();
+	}
+	void extractInfoFromHeader() const;
+
 	time_t mRegisterTime{0};
 	std::string mMessageExpiresName;
 	std::chrono::seconds mExpires{0};        // Standard SIP expires= field
 	std::chrono::seconds mMessageExpires{0}; // Custom message-expires= override
+	mutable std::vector<std::string> mPath{};
+	mutable std::string mUserAgent{};
+	mutable std::vector<std::string> mAcceptHeader{};
+	// URL-encoded headers of the serialized contact, allocated in mHome, not parsed yet. Null once parsed.
+	mutable const char* mUrlHeaders{nullptr};
 };
 
 template <typename TraitsT>
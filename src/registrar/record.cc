@@ -98,10 +98,10 @@ time_t Record::latestExpire(std::function<bool(const url_t*)>& predicate) const
 
 	for (auto it = mContacts.begin(); it != mContacts.end(); ++it) {
 		const auto expireTime = (*it)->getExpireTime();
-		if ((*it)->mPath.empty() || expireTime <= latest) continue;
+		if ((*it)->getPath().empty() || expireTime <= latest) continue;
 
 		/* Remove extra parameters */
-		string s = *(*it)->mPath.begin();
+		string s = *(*it)->getPath().begin();
 		string::size_type n = s.find(";");
 		if (n != string::npos) s = s.substr(0, n);
 		url_t* url = url_make(home.home(), s.c_str());
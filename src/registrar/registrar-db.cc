@@ -18,7 +18,9 @@
 
 #include "registrar-db.hh"
 
+#include <algorithm>
 #include <memory>
+#include <unordered_map>
 
 #include "flexisip/configmanager.hh"
 #include "flexisip/registrar/registar-listeners.hh"
@@ -251,11 +253,14 @@ void LocalRegExpire::removeExpiredBefore(time_t before) {
 	}
 }
 
-void LocalRegExpire::getRegisteredAors(std::list<std::string>& aors) const {
+vector<string> LocalRegExpire::getRegisteredAors(const string& after, size_t count) const {
 	unique_lock<mutex> lock(mMutex);
-	for (auto& pair : mRegMap) {
-		aors.push_back(pair.first);
+	vector<string> aors{};
+	for (auto it = after.empty() ? mRegMap.begin() : mRegMap.upper_bound(after);
+	     it != mRegMap.end() && aors.size() < count; ++it) {
+		aors.push_back(it->first);
 	}
+	return aors;
 }
 
 void LocalRegExpire::subscribe(LocalRegExpireListener* listener) {
@@ -319,6 +324,8 @@ private:
 	int mStep = 0;
 	float mOriginalQ = 1.0; // the q parameter. When recursing, we choose to inherit it from the original target.
 	bool mRecursionDone = false;
+	// Records of the original URL and of its aliases, when they have all been fetched at once.
+	shared_ptr<const unordered_map<string, shared_ptr<Record>>> mPrefetched{};
 	static int sMaxStep;
 
 public:
@@ -330,6 +337,37 @@ public:
 	      mRecord(make_shared<Record>(url, mDatabase->getRecordConfig())), mUrl(url), mStep(step) {
 	}
 
+	/**
+	 * Fetch the record of the URL along with the records of all the aliases it leads to in a single request to the
+	 * backend, then resolve the aliases from these records.
+	 */
+	void fetchWithAliases(RegistrarDbBackend& backend) {
+		class AliasesListener : public ListContactUpdateListener {
+		public:
+			explicit AliasesListener(const shared_ptr<RecursiveRegistrarDbListener>& listener) : mListener(listener) {
+			}
+
+			void onContactsUpdated() override {
+				if (records.empty()) {
+					SLOGW << "Error while fetching " << mListener->mUrl << " and its aliases";
+					mListener->mOriginalListener->onError(SipStatus(SIP_500_INTERNAL_SERVER_ERROR));
+					return;
+				}
+				auto prefetched = make_shared<unordered_map<string, shared_ptr<Record>>>();
+				for (const auto& record : records) {
+					prefetched->emplace(record->getKey().asString(), record->isEmpty() ? nullptr : record);
+				}
+				mListener->mPrefetched = std::move(prefetched);
+				mListener->fetch();
+			}
+
+		private:
+			shared_ptr<RecursiveRegistrarDbListener> mListener;
+		};
+
+		backend.doFetchWithAliases(mUrl, mStep, make_shared<AliasesListener>(shared_from_this()));
+	}
+
 	void onRecordFound(const shared_ptr<Record>& r) override {
 		mPendingRequests--;
 		if (r != nullptr) {
@@ -349,7 +387,8 @@ public:
 					vectToRecurseOn.push_back(ec);
 				}
 			}
-			mPendingRequests += vectToRecurseOn.size();
+			// One more pending request until all of them are sent, as they may be answered synchronously.
+			mPendingRequests += vectToRecurseOn.size() + 1;
 			mRecursionDone = true;
 			for (auto itrec : vectToRecurseOn) {
 				try {
@@ -357,12 +396,15 @@ public:
 					auto listener =
 					    make_shared<RecursiveRegistrarDbListener>(mDatabase, this->shared_from_this(), uri, mStep - 1);
 					listener->mOriginalQ = itrec->mQ;
-					mDatabase->fetch(uri, listener, false);
+					listener->mPrefetched = mPrefetched;
+					listener->fetch();
 				} catch (const sofiasip::InvalidUrlError& e) {
 					SLOGE << "Invalid fetched URI while fetching [" << mUrl.str() << "] recusively." << endl
 					      << "The invalid URI is [" << e.getUrl() << "]. Reason: " << e.getReason();
+					mPendingRequests--;
 				}
 			}
+			mPendingRequests--;
 		}
 
 		if (waitPullUpOrFail()) {
@@ -389,6 +431,19 @@ public:
 	}
 
 private:
+	// Fetch the record of the URL, from the prefetched records when it is part of them.
+	void fetch() {
+		if (mPrefetched != nullptr && UriUtils::getParamValue(mUrl.get()->url_params, "gr").empty()) {
+			const auto found =
+			    mPrefetched->find(Record::Key(mUrl, mDatabase->getRecordConfig().useGlobalDomain()).asString());
+			if (found != mPrefetched->end()) {
+				onRecordFound(found->second);
+				return;
+			}
+		}
+		mDatabase->fetch(mUrl, shared_from_this(), false);
+	}
+
 	shared_ptr<ExtendedContact> transformContactUsedAsRoute(const std::string& uri,
 	                                                        const shared_ptr<ExtendedContact>& ec) {
 		/* This function does the following:
@@ -405,7 +460,7 @@ private:
 		    sip_contact_create(newEc->mHome.home(), reinterpret_cast<const url_string_t*>(uri.c_str()), nullptr);
 		ostringstream path;
 		path << *ec->toSofiaUrlClean(newEc->mHome.home());
-		newEc->mPath.push_back(path.str());
+		newEc->addPath(path.str());
 		// LOGD("transformContactUsedAsRoute(): path to %s added for %s", ec->mSipUri.c_str(), uri);
 		newEc->mUsedAsRoute = false;
 		return newEc;
@@ -446,12 +501,23 @@ void RegistrarDb::fetch(const SipUri& url,
 		mBackend->doFetchInstance(url, UriUtils::grToUniqueId(gr),
 		                          recursive ? make_shared<RecursiveRegistrarDbListener>(this, listener, url)
 		                                    : listener);
+	} else if (recursive) {
+		make_shared<RecursiveRegistrarDbListener>(this, listener, url)->fetchWithAliases(*mBackend);
 	} else {
-		mBackend->doFetch(url, recursive ? make_shared<RecursiveRegistrarDbListener>(this, listener, url) : listener);
+		mBackend->doFetch(url, listener);
 	}
 }
 
 void RegistrarDb::fetchList(const vector<SipUri> urls, const shared_ptr<ListContactUpdateListener>& listener) {
+	const auto isInstance = [](const SipUri& url) {
+		return !UriUtils::getParamValue(url.get()->url_params, "gr").empty();
+	};
+	// Plain AoRs are all fetched at once. Only GRUUs require a request of their own.
+	if (none_of(urls.cbegin(), urls.cend(), isInstance)) {
+		mBackend->doFetchMany(urls, listener);
+		return;
+	}
+
 	class InternalContactUpdateListener : public ContactUpdateListener {
 	public:
 		InternalContactUpdateListener(shared_ptr<ListContactUpdateListener> listener, size_t size)
@@ -514,6 +580,13 @@ void RegistrarDb::bind(const MsgSip& sipMsg,
 void RegistrarDb::bind(MsgSip&& sipMsg,
                        const BindingParameters& parameter,
                        const shared_ptr<ContactUpdateListener>& listener) {
+	if (!prepareBind(sipMsg, listener)) return;
+
+	LOGI("RegistrarDb: binding %s", SipUri(sipMsg.getSip()->sip_from->a_url).str().c_str());
+	mBackend->doBind(sipMsg, parameter, listener);
+}
+
+bool RegistrarDb::prepareBind(MsgSip& sipMsg, const shared_ptr<ContactUpdateListener>& listener) {
 	sip_t* sip = sipMsg.getSip();
 
 	bool gruu_assigned = false;
@@ -540,18 +613,35 @@ void RegistrarDb::bind(MsgSip&& sipMsg,
 	if (countSipContacts > maxContacts) {
 		SLOGD << "Too many contacts in register " << Record::Key(sip->sip_from->a_url, mRecordConfig.useGlobalDomain())
 		      << " " << countSipContacts << " > " << maxContacts;
-		listener->onError(SipStatus(SIP_500_INTERNAL_SERVER_ERROR));
-		return;
+		if (listener) listener->onError(SipStatus(SIP_500_INTERNAL_SERVER_ERROR));
+		return false;
 	}
-
-	LOGI("RegistrarDb: binding %s", SipUri(sipMsg.getSip()->sip_from->a_url).str().c_str());
-	mBackend->doBind(sipMsg, parameter, listener);
+	return true;
 }
 
 void RegistrarDb::bind(const SipUri& aor,
                        const sip_contact_t* contact,
                        const BindingParameters& parameter,
                        const shared_ptr<ContactUpdateListener>& listener) {
+	bind(makeRegister(aor, contact, parameter), parameter, listener);
+}
+
+void RegistrarDb::bindMany(const vector<pair<SipUri, const sip_contact_t*>>& bindings,
+                           const BindingParameters& parameter,
+                           const shared_ptr<ContactUpdateListener>& listener) {
+	vector<MsgSip> msgs{};
+	msgs.reserve(bindings.size());
+	for (const auto& [aor, contact] : bindings) {
+		auto msg = makeRegister(aor, contact, parameter);
+		if (!prepareBind(msg, listener)) continue;
+		msgs.emplace_back(std::move(msg));
+	}
+
+	LOGI("RegistrarDb: binding %zu records", msgs.size());
+	mBackend->doBindMany(std::move(msgs), parameter, listener);
+}
+
+MsgSip RegistrarDb::makeRegister(const SipUri& aor, const sip_contact_t* contact, const BindingParameters& parameter) {
 	MsgSip msg{};
 	auto* homeSip = msg.getHome();
 	auto* sip = msg.getSip();
@@ -579,7 +669,7 @@ void RegistrarDb::bind(const SipUri& aor,
 
 	sip->sip_expires = sip_expires_create(homeSip, 0);
 
-	bind(std::move(msg), parameter, listener);
+	return msg;
 }
 
 class AgregatorRegistrarDbListener : public ContactUpdateListener {
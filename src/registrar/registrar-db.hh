@@ -25,7 +25,10 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "registrar/record.hh"
@@ -50,21 +53,59 @@ class SipUri;
 struct BindingParameters;
 struct ExtendedContact;
 
+// A page of AoRs returned by a walk over the registrar database.
+struct AorsPage {
+	std::vector<std::string> aors{};
+	// Cursor of the next page, empty once the whole database has been walked.
+	std::string nextCursor{};
+};
+
 class RegistrarDbBackend {
 public:
 	virtual ~RegistrarDbBackend() = default;
 	virtual void fetchExpiringContacts(time_t startTimestamp,
 	                                   float threshold,
 	                                   std::function<void(std::vector<ExtendedContact>&&)>&& callback) const = 0;
+	/**
+	 * Walk the AoRs of the stored records by pages of about `count` AoRs, without holding the storage for long. Start
+	 * with an empty cursor, then pass the one of the previous page until it is empty again. Records added or removed
+	 * during the walk may be missed and an AoR may be returned more than once.
+	 * The callback receives std::nullopt on error.
+	 */
+	virtual void scanAors(const std::string& cursor,
+	                      size_t count,
+	                      std::function<void(std::optional<AorsPage>&&)>&& callback) const = 0;
 	virtual bool isWritable() const = 0;
 	virtual void doBind(const sofiasip::MsgSip& sip,
 	                    const BindingParameters& parameters,
 	                    const std::shared_ptr<ContactUpdateListener>& listener) = 0;
+	/**
+	 * Same as doBind() for many REGISTER requests sharing the same binding parameters. The listener, if any, is
+	 * notified once per request.
+	 */
+	virtual void doBindMany(std::vector<sofiasip::MsgSip>&& msgs,
+	                        const BindingParameters& parameters,
+	                        const std::shared_ptr<ContactUpdateListener>& listener) = 0;
 	virtual void doClear(const sofiasip::MsgSip& sip, const std::shared_ptr<ContactUpdateListener>& listener) = 0;
 	virtual void doFetch(const SipUri& url, const std::shared_ptr<ContactUpdateListener>& listener) = 0;
 	virtual void doFetchInstance(const SipUri& url,
 	                             const std::string& uniqueId,
 	                             const std::shared_ptr<ContactUpdateListener>& listener) = 0;
+	/**
+	 * Fetch the records of several AoRs at once, in a single pass (or round-trip) over the storage.
+	 * Non-empty records are appended to listener->records, then listener->onContactsUpdated() is called, even if
+	 * an error occurred.
+	 */
+	virtual void doFetchMany(const std::vector<SipUri>& urls,
+	                         const std::shared_ptr<ListContactUpdateListener>& listener) = 0;
+	/**
+	 * Fetch the record of an AoR along with the records of the aliases it leads to, up to maxStep levels of aliases.
+	 * Every record visited, even empty, is appended to listener->records, then listener->onContactsUpdated() is called.
+	 * The records are left empty on error.
+	 */
+	virtual void doFetchWithAliases(const SipUri& url,
+	                                int maxStep,
+	                                const std::shared_ptr<ListContactUpdateListener>& listener) = 0;
 	virtual void subscribe(const Record::Key&) = 0;
 	virtual void unsubscribe(const Record::Key&) = 0;
 	virtual void publish(const Record::Key& topic, const std::string& uid) = 0;
@@ -83,7 +124,8 @@ public:
 		std::lock_guard<std::mutex> lock(mMutex);
 		mRegMap.clear();
 	}
-	void getRegisteredAors(std::list<std::string>& aors) const;
+	// Get at most `count` of the AoRs registered on this instance, in lexicographic order, starting after `after`.
+	std::vector<std::string> getRegisteredAors(const std::string& after, size_t count) const;
 
 	void subscribe(LocalRegExpireListener* listener);
 	void unsubscribe(LocalRegExpireListener* listener);
@@ -121,6 +163,14 @@ public:
 	          const sip_contact_t* contact,
 	          const BindingParameters& parameter,
 	          const std::shared_ptr<ContactUpdateListener>& listener);
+	/**
+	 * Same as bind() for a lot of AoRs at once, e.g. to restore all the bindings of a service at startup. The backend
+	 * processes them by batches, with a bounded number of requests in flight. The listener, if any, is notified once
+	 * per binding.
+	 */
+	void bindMany(const std::vector<std::pair<SipUri, const sip_contact_t*>>& bindings,
+	              const BindingParameters& parameter,
+	              const std::shared_ptr<ContactUpdateListener>& listener);
 	void clear(const sofiasip::MsgSip& sip, const std::shared_ptr<ContactUpdateListener>& listener);
 	void clear(const SipUri& url, const std::string& callId, const std::shared_ptr<ContactUpdateListener>& listener);
 	void fetch(const SipUri& url, const std::shared_ptr<ContactUpdateListener>& listener, bool recursive = false);
@@ -134,6 +184,11 @@ public:
 	                           std::function<void(std::vector<ExtendedContact>&&)>&& callback) const {
 		mBackend->fetchExpiringContacts(startTimestamp, threshold, std::move(callback));
 	}
+	void scanAors(const std::string& cursor,
+	              size_t count,
+	              std::function<void(std::optional<AorsPage>&&)>&& callback) const {
+		mBackend->scanAors(cursor, count, std::move(callback));
+	}
 	void notifyContactListener(const std::shared_ptr<Record>& r /*might be empty record*/, const std::string& uid);
 	void updateRemoteExpireTime(const std::string& key, time_t expireat);
 	unsigned long countLocalActiveRecords() {
@@ -173,11 +228,11 @@ public:
 	 * header.*/
 	url_t* synthesizePubGruu(su_home_t* home, const sofiasip::MsgSip& sipMsg);
 
-	void getLocalRegisteredAors(std::list<std::string>& aors) const {
-		mLocalRegExpire.getRegisteredAors(aors);
+	std::vector<std::string> getLocalRegisteredAors(const std::string& after, size_t count) const {
+		return mLocalRegExpire.getRegisteredAors(after, count);
 	}
 
-	const std::multimap<std::string, std::weak_ptr<const ContactRegisteredListener>>&
+	const std::unordered_multimap<std::string, std::weak_ptr<const ContactRegisteredListener>>&
 	getOnContactRegisteredListeners() const {
 		return castToConst(mContactListenersMap);
 	}
@@ -191,6 +246,13 @@ public:
 	}
 
 private:
+	// Build a REGISTER request equivalent to the binding.
+	static sofiasip::MsgSip makeRegister(const SipUri& aor,
+	                                     const sip_contact_t* contact,
+	                                     const BindingParameters& parameter);
+	// Assign a pub-gruu to the contact of the REGISTER request, then check it can be bound. Notifies the listener and
+	// returns false otherwise.
+	bool prepareBind(sofiasip::MsgSip& sipMsg, const std::shared_ptr<ContactUpdateListener>& listener);
 	void fetchWithDomain(const SipUri& url, const std::shared_ptr<ContactUpdateListener>& listener, bool recursive);
 	void notifyContactListener(const Record::Key& key, std::string_view uid);
 	void notifyStateListener(bool bWritable) const;
@@ -200,7 +262,7 @@ private:
 	LocalRegExpire mLocalRegExpire{};
 	bool mGruuEnabled{};
 	Record::Config mRecordConfig;
-	std::multimap<std::string, std::weak_ptr<ContactRegisteredListener>> mContactListenersMap;
+	std::unordered_multimap<std::string, std::weak_ptr<ContactRegisteredListener>> mContactListenersMap;
 	std::list<std::shared_ptr<RegistrarDbStateListener>> mStateListeners;
 	// Must be last
 	std::unique_ptr<RegistrarDbBackend> mBackend;
@@ -20,8 +20,10 @@
 
 #include <cstdio>
 #include <ctime>
+#include <unordered_set>
 #include <vector>
 
+#include "flexisip/logmanager.hh"
 #include "flexisip/registrar/registar-listeners.hh"
 #include "flexisip/sofia-wrapper/msg-sip.hh"
 
@@ -75,6 +77,14 @@ void RegistrarDbInternal::doBind(const MsgSip& msg,
 	if (listener) listener->onRecordFound(r);
 }
 
+void RegistrarDbInternal::doBindMany(vector<MsgSip>&& msgs,
+                                     const BindingParameters& parameters,
+                                     const shared_ptr<ContactUpdateListener>& listener) {
+	for (const auto& msg : msgs) {
+		doBind(msg, parameters, listener);
+	}
+}
+
 void RegistrarDbInternal::doFetch(const SipUri& url, const shared_ptr<ContactUpdateListener>& listener) {
 	auto it = mRecords.find(Record::Key(url, mRecordConfig.useGlobalDomain()).toString());
 	shared_ptr<Record> r{};
@@ -90,6 +100,61 @@ void RegistrarDbInternal::doFetch(const SipUri& url, const shared_ptr<ContactUpd
 	listener->onRecordFound(r);
 }
 
+void RegistrarDbInternal::doFetchMany(const vector<SipUri>& urls,
+                                      const shared_ptr<ListContactUpdateListener>& listener) {
+	for (const auto& url : urls) {
+		auto it = mRecords.find(Record::Key(url, mRecordConfig.useGlobalDomain()).toString());
+		if (it == mRecords.end()) continue;
+
+		auto& record = it->second;
+		record->clean(nullptr);
+		if (record->isEmpty()) {
+			mRecords.erase(it);
+			continue;
+		}
+		listener->records.push_back(record);
+	}
+
+	listener->onContactsUpdated();
+}
+
+void RegistrarDbInternal::doFetchWithAliases(const SipUri& url,
+                                             int maxStep,
+                                             const shared_ptr<ListContactUpdateListener>& listener) {
+	unordered_set<string> visited{};
+	vector<SipUri> currentLevel{url};
+	for (auto step = maxStep; 0 <= step && !currentLevel.empty(); step--) {
+		vector<SipUri> nextLevel{};
+		for (const auto& aor : currentLevel) {
+			auto key = Record::Key(aor, mRecordConfig.useGlobalDomain()).toString();
+			if (!visited.insert(key).second) continue;
+
+			shared_ptr<Record> record{};
+			auto it = mRecords.find(key);
+			if (it != mRecords.end()) {
+				record = it->second;
+				record->clean(nullptr);
+				if (record->isEmpty()) mRecords.erase(it);
+			}
+			if (record == nullptr) record = make_shared<Record>(aor, mRecordConfig);
+			listener->records.push_back(record);
+			if (step == 0) continue;
+
+			for (const auto& contact : record->getExtendedContacts()) {
+				if (!contact->mAlias) continue;
+				try {
+					nextLevel.emplace_back(contact->mSipContact->m_url);
+				} catch (const sofiasip::InvalidUrlError& e) {
+					SLOGW << "Invalid alias [" << e.getUrl() << "] in record " << key << ": " << e.getReason();
+				}
+			}
+		}
+		currentLevel = std::move(nextLevel);
+	}
+
+	listener->onContactsUpdated();
+}
+
 void RegistrarDbInternal::doFetchInstance(const SipUri& url,
                                           const string& uniqueId,
                                           const shared_ptr<ContactUpdateListener>& listener) {
@@ -143,6 +208,30 @@ void RegistrarDbInternal::fetchExpiringContacts(time_t current_time,
 	callback(std::move(expiringContacts));
 }
 
+void RegistrarDbInternal::scanAors(const string& cursor,
+                                   size_t count,
+                                   function<void(optional<AorsPage>&&)>&& callback) const {
+	// The cursor is the index of the next bucket to walk, much like the Redis SCAN cursor.
+	size_t bucket = 0;
+	try {
+		if (!cursor.empty()) bucket = stoul(cursor);
+	} catch (const exception&) {
+		SLOGE << "RegistrarDbInternal::scanAors(): invalid cursor '" << cursor << "'";
+		callback(nullopt);
+		return;
+	}
+
+	AorsPage page{};
+	const auto bucketCount = mRecords.bucket_count();
+	for (; bucket < bucketCount && page.aors.size() < count; ++bucket) {
+		for (auto it = mRecords.cbegin(bucket); it != mRecords.cend(bucket); ++it) {
+			if (!it->second->isEmpty()) page.aors.push_back(it->first);
+		}
+	}
+	if (bucket < bucketCount) page.nextCursor = to_string(bucket);
+	callback(std::move(page));
+}
+
 void RegistrarDbInternal::doClear(const MsgSip& msg, const shared_ptr<ContactUpdateListener>& listener) {
 	auto* sip = msg.getSip();
 	const auto& key = Record::Key(sip->sip_from->a_url, mRecordConfig.useGlobalDomain()).toString();
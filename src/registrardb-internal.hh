@@ -39,6 +39,9 @@ public:
 	void fetchExpiringContacts(time_t startTimestamp,
 	                           float threshold,
 	                           std::function<void(std::vector<ExtendedContact>&&)>&& callback) const override;
+	void scanAors(const std::string& cursor,
+	              size_t count,
+	              std::function<void(std::optional<AorsPage>&&)>&& callback) const override;
 
 	/**
 	 * Read-only access to the stored records. As of 2023-07-05, only used in tests
@@ -54,11 +57,19 @@ public:
 	void doBind(const sofiasip::MsgSip& msg,
 	            const BindingParameters& parameters,
 	            const std::shared_ptr<ContactUpdateListener>& listener) override;
+	void doBindMany(std::vector<sofiasip::MsgSip>&& msgs,
+	                const BindingParameters& parameters,
+	                const std::shared_ptr<ContactUpdateListener>& listener) override;
 	void doClear(const sofiasip::MsgSip& msg, const std::shared_ptr<ContactUpdateListener>& listener) override;
 	void doFetch(const SipUri& url, const std::shared_ptr<ContactUpdateListener>& listener) override;
 	void doFetchInstance(const SipUri& url,
 	                     const std::string& uniqueId,
 	                     const std::shared_ptr<ContactUpdateListener>& listener) override;
+	void doFetchMany(const std::vector<SipUri>& urls,
+	                 const std::shared_ptr<ListContactUpdateListener>& listener) override;
+	void doFetchWithAliases(const SipUri& url,
+	                        int maxStep,
+	                        const std::shared_ptr<ListContactUpdateListener>& listener) override;
 	void subscribe(const Record::Key&) override{};
 	void unsubscribe(const Record::Key&) override{};
 	void publish(const Record::Key& topic, const std::string& uid) override;
@@ -66,6 +66,41 @@ const Script FETCH_EXPIRING_CONTACTS_SCRIPT{
     , // ❯ sed -n '/R"lua(/,/)lua"/p' fetch-expiring-contacts.lua.hh | sed 's/R"lua(//' | head -n-1 | sha1sum
     "8f26674ebf2a65c4eee45d2ae9b98c121cf6ff43"};
 
+const Script FETCH_MANY_RECORDS_SCRIPT{
+#include "fetch-many-records.lua.hh"
+    , // ❯ sed -n '/R"lua(/,/)lua"/p' fetch-many-records.lua.hh | sed 's/R"lua(//' | head -n-1 | sha1sum
+    "dde22a2e84bfc67b1bc9a30ec3fabce253f9cd80"};
+
+// Bulk binds are processed by batches of that many records, each batch being fetched then updated in one round-trip
+constexpr size_t kBindBatchSize = 100;
+// Maximum number of batches of a bulk bind that are processed at the same time
+constexpr size_t kMaxBindBatchesInFlight = 8;
+
+const Script FETCH_WITH_ALIASES_SCRIPT{
+#include "fetch-with-aliases.lua.hh"
+    , // ❯ sed -n '/R"lua(/,/)lua"/p' fetch-with-aliases.lua.hh | sed 's/R"lua(//' | head -n-1 | sha1sum
+    "a160f0d6e3bd7ece87bcc89c39df7933fcfefbce"};
+
+void insertIfActive(Record& record, unique_ptr<ExtendedContact>&& contact) {
+	if (contact->isExpired()) return;
+
+	try {
+		record.insertOrUpdateBinding(std::move(contact), nullptr);
+	} catch (const InvalidCSeq&) {
+		// There can be a race condition on contact registration. If we get more REGISTERs (without sip instance)
+		// before Redis responded to the first, then we issue multiple insertion commands resulting in duplicated
+		// contacts, potentially with out-of-order CSeq. This situation will be resolved on the next bind (because
+		// all those duplicated contacts will match the new contact, and all be deleted), so in the meantime, let's
+		// just skip the duplicated contacts
+		SLOGW << "Illegal state detected in the RegistrarDb. Skipping contact: "
+		      << (contact ? contact->urlAsString() : "<moved out>");
+	} catch (const sofiasip::InvalidUrlError& e) {
+		SLOGW << "Invalid 'Contact' SIP URI [" << e.getUrl() << "]: " << e.getReason();
+	} catch (const std::exception& e) {
+		SLOGE << "Unexpected exception: " << e.what();
+	}
+}
+
 } // namespace
 
 /******
@@ -81,7 +116,7 @@ RegistrarDbRedisAsync::RegistrarDbRedisAsync(
     std::function<void(bool)> notifyState)
     : mRedisClient{root, params, SoftPtr<SessionListener>::fromObjectLivingLongEnough(*this)}, mRoot{root},
       mRecordConfig{recordConfig}, mLocalRegExpire{localRegExpire}, mNotifyContactListener{std::move(notifyContact)},
-      mNotifyStateListener{std::move(notifyState)} {
+      mNotifyStateListener{std::move(notifyState)}, mSubscriptionsFlushTimer{root, chrono::milliseconds{0}} {
 }
 
 bool RegistrarDbRedisAsync::isConnected() const {
@@ -183,29 +218,47 @@ void RegistrarDbRedisAsync::subscribeToKeyExpiration() {
 }
 
 void RegistrarDbRedisAsync::subscribe(const Record::Key& key) {
-	const auto topic = key.asString();
-	SLOGD << "Sending SUBSCRIBE command to Redis for topic '" << topic << "'";
-	const auto* const subs = mRedisClient.tryGetSubSession();
-	if (!subs) {
-		SLOGE << "RegistrarDbRedisAsync::subscribeTopic(): Subscription session not ready!";
-		return;
-	}
-
-	// Override any previous subscription
-	subs->subscriptions()[topic].subscribe([this](auto topic, Reply reply) { handlePublish(topic, std::move(reply)); });
+	auto topic = key.asString();
+	mPendingUnsubscriptions.erase(topic);
+	mPendingSubscriptions.insert(std::move(topic));
+	if (!mSubscriptionsFlushTimer.isRunning()) mSubscriptionsFlushTimer.set([this] { flushSubscriptions(); });
 }
 
 void RegistrarDbRedisAsync::unsubscribe(const Record::Key& key) {
-	const auto& topic = key.asString();
+	auto topic = key.asString();
 	// No listeners left, unsubscribing
-	auto* ready = mRedisClient.tryGetSubSession();
-	if (!ready) return;
+	mPendingSubscriptions.erase(topic);
+	mPendingUnsubscriptions.insert(std::move(topic));
+	if (!mSubscriptionsFlushTimer.isRunning()) mSubscriptionsFlushTimer.set([this] { flushSubscriptions(); });
+}
+
+void RegistrarDbRedisAsync::flushSubscriptions() {
+	const vector<string> pendingSubscriptions{mPendingSubscriptions.begin(), mPendingSubscriptions.end()};
+	const vector<string> pendingUnsubscriptions{mPendingUnsubscriptions.begin(), mPendingUnsubscriptions.end()};
+	mPendingSubscriptions.clear();
+	mPendingUnsubscriptions.clear();
 
-	auto subscription = ready->subscriptions()[topic];
-	if (!subscription.subscribed()) return;
+	const auto* const subs = mRedisClient.tryGetSubSession();
+	if (!subs) {
+		if (!pendingSubscriptions.empty()) {
+			SLOGE << "RegistrarDbRedisAsync::flushSubscriptions(): Subscription session not ready! "
+			      << pendingSubscriptions.size() << " topic(s) not subscribed";
+		}
+		return;
+	}
 
-	SLOGD << "Sending UNSUBSCRIBE command to Redis for topic '" << topic << "'";
-	subscription.unsubscribe();
+	// Topics are sent by commands of up to SubscriptionSession::kMaxTopicsPerCommand channels.
+	auto subscriptions = subs->subscriptions();
+	if (!pendingSubscriptions.empty()) {
+		SLOGD << "Sending SUBSCRIBE command(s) to Redis for " << pendingSubscriptions.size() << " topic(s)";
+		// Override any previous subscription
+		subscriptions.subscribe(pendingSubscriptions,
+		                        [this](auto topic, Reply reply) { handlePublish(topic, std::move(reply)); });
+	}
+	if (!pendingUnsubscriptions.empty()) {
+		SLOGD << "Sending UNSUBSCRIBE command(s) to Redis for up to " << pendingUnsubscriptions.size() << " topic(s)";
+		subscriptions.unsubscribe(pendingUnsubscriptions);
+	}
 }
 
 void RegistrarDbRedisAsync::publish(const Record::Key& key, const string& uid) {
@@ -229,13 +282,20 @@ void RegistrarDbRedisAsync::serializeAndSendToRedis(RedisRegisterContext& contex
 		return;
 	}
 
+	/* Start a REDIS transaction */
+	cmdSession->command({"MULTI"}, {});
+
+	serializeChangeSet(*cmdSession, context);
+
+	/* Execute the transaction */
+	cmdSession->timedCommand({"EXEC"}, std::move(forwardedCb));
+}
+
+void RegistrarDbRedisAsync::serializeChangeSet(const Session::Ready& cmdSession, const RedisRegisterContext& context) {
 	int setCount = 0;
 	int delCount = 0;
 	string key = "fs:" + context.mRecord->getKey().asString();
 
-	/* Start a REDIS transaction */
-	cmdSession->command({"MULTI"}, {});
-
 	/* First delete contacts that need to be deleted */
 	if (!context.mChangeSet.mDelete.empty()) {
 		redis::ArgsPacker hDelArgs("HDEL", key);
@@ -243,7 +303,7 @@ void RegistrarDbRedisAsync::serializeAndSendToRedis(RedisRegisterContext& contex
 			hDelArgs.addFieldName(ec->mKey);
 			delCount++;
 		}
-		cmdSession->timedCommand(hDelArgs, logErrorReply(hDelArgs));
+		cmdSession.timedCommand(hDelArgs, logErrorReply(hDelArgs));
 		SLOGD << hDelArgs;
 	}
 
@@ -254,7 +314,7 @@ void RegistrarDbRedisAsync::serializeAndSendToRedis(RedisRegisterContext& contex
 			hSetArgs.addPair(ec->mKey, ec->serializeAsUrlEncodedParams());
 			setCount++;
 		}
-		cmdSession->timedCommand(hSetArgs, logErrorReply(hSetArgs));
+		cmdSession.timedCommand(hSetArgs, logErrorReply(hSetArgs));
 		SLOGD << hSetArgs;
 	}
 
@@ -262,10 +322,7 @@ void RegistrarDbRedisAsync::serializeAndSendToRedis(RedisRegisterContext& contex
 
 	/* Set global expiration for the Record */
 	redis::ArgsPacker expireAtCmd{"EXPIREAT", key, to_string(context.mRecord->latestExpire())};
-	cmdSession->timedCommand(expireAtCmd, logErrorReply(expireAtCmd));
-
-	/* Execute the transaction */
-	cmdSession->timedCommand({"EXEC"}, std::move(forwardedCb));
+	cmdSession.timedCommand(expireAtCmd, logErrorReply(expireAtCmd));
 }
 
 /* Methods called by the callbacks */
@@ -338,37 +395,11 @@ void RegistrarDbRedisAsync::doBind(const MsgSip& msg,
 			return;
 		}
 
-		auto& contacts = context->mRecord->getExtendedContacts();
-		auto& changeset = context->mChangeSet;
-		// Parse the fetched reply into the Record object (context->mRecord)
-		for (auto&& maybeExpired :
-		     parseContacts(array->pairwise(), context->mRecord->getConfig().messageExpiresName())) {
-			if (maybeExpired->isExpired()) {
-				changeset.mDelete.emplace_back(std::move(maybeExpired));
-			} else {
-				contacts.emplace(std::move(maybeExpired));
-			}
-		}
-
-		/* Now update the existing Record with new SIP REGISTER and binding parameters
-		 * insertOrUpdateBinding() will do the job of contact comparison and invoke the onContactUpdated listener*/
-		SLOGD << "Updating Record content for key [fs:" << context->mRecord->getKey() << "] with new contact(s).";
-		try {
-			changeset +=
-			    context->mRecord->update(context->mMsg.getSip(), context->mBindingParameters, context->listener);
-		} catch (const InvalidRequestError& e) {
-			if (context->listener) context->listener->onInvalid(e.getSipStatus());
-			return;
-		} catch (const std::exception& e) {
-			SLOGE << "Unexpected exception when updating record: " << e.what();
-			if (context->listener) context->listener->onError(SipStatus(SIP_500_INTERNAL_SERVER_ERROR));
-			return;
-		}
-
-		changeset += context->mRecord->applyMaxAor();
+		if (!updateRecordForBind(*array, *context)) return;
 
 		/* now submit the changes triggered by the update operation to REDIS */
-		SLOGD << "Sending updated content to REDIS for key [fs:" << context->mRecord->getKey() << "]: " << changeset;
+		SLOGD << "Sending updated content to REDIS for key [fs:" << context->mRecord->getKey()
+		      << "]: " << context->mChangeSet;
 		auto& ctxRef = *context;
 		serializeAndSendToRedis(ctxRef, [this, context = std::move(context)](Session&, Reply reply) mutable {
 			handleBind(reply, std::move(context));
@@ -376,6 +407,116 @@ void RegistrarDbRedisAsync::doBind(const MsgSip& msg,
 	});
 }
 
+bool RegistrarDbRedisAsync::updateRecordForBind(const reply::Array& currentContent, RedisRegisterContext& context) {
+	auto& contacts = context.mRecord->getExtendedContacts();
+	auto& changeset = context.mChangeSet;
+	// Parse the fetched reply into the Record object (context.mRecord)
+	for (auto&& maybeExpired :
+	     parseContacts(currentContent.pairwise(), context.mRecord->getConfig().messageExpiresName())) {
+		if (maybeExpired->isExpired()) {
+			changeset.mDelete.emplace_back(std::move(maybeExpired));
+		} else {
+			contacts.emplace(std::move(maybeExpired));
+		}
+	}
+
+	/* Now update the existing Record with new SIP REGISTER and binding parameters
+	 * insertOrUpdateBinding() will do the job of contact comparison and invoke the onContactUpdated listener*/
+	SLOGD << "Updating Record content for key [fs:" << context.mRecord->getKey() << "] with new contact(s).";
+	try {
+		changeset += context.mRecord->update(context.mMsg.getSip(), context.mBindingParameters, context.listener);
+	} catch (const InvalidRequestError& e) {
+		if (context.listener) context.listener->onInvalid(e.getSipStatus());
+		return false;
+	} catch (const std::exception& e) {
+		SLOGE << "Unexpected exception when updating record: " << e.what();
+		if (context.listener) context.listener->onError(SipStatus(SIP_500_INTERNAL_SERVER_ERROR));
+		return false;
+	}
+
+	changeset += context.mRecord->applyMaxAor();
+	return true;
+}
+
+void RegistrarDbRedisAsync::doBindMany(vector<MsgSip>&& msgs,
+                                       const BindingParameters& parameters,
+                                       const shared_ptr<ContactUpdateListener>& listener) {
+	// Same as doBind() but by batches: the records of a whole batch are fetched at once, then updated in a single
+	// transaction. Only a few batches are in flight at the same time, so that Redis (and the command timeouts) is not
+	// flooded when binding a lot of records.
+	auto bulk = make_shared<BulkBind>(BulkBind{std::move(msgs), parameters, listener});
+	for (size_t i = 0; i < kMaxBindBatchesInFlight; i++) {
+		sendNextBindBatch(bulk);
+	}
+}
+
+void RegistrarDbRedisAsync::sendNextBindBatch(const shared_ptr<BulkBind>& bulk) {
+	const auto end = min(bulk->next + kBindBatchSize, bulk->msgs.size());
+	if (bulk->next == end) return;
+
+	const Session::Ready* cmdSession;
+	if (!(cmdSession = mRedisClient.tryGetCmdSession())) {
+		SLOGE << "Redis session not ready. Aborting bulk bind of " << bulk->msgs.size() - bulk->next << " records";
+		for (; bulk->next < bulk->msgs.size(); bulk->next++) {
+			if (bulk->listener) bulk->listener->onError(SipStatus(SIP_500_INTERNAL_SERVER_ERROR));
+		}
+		return;
+	}
+
+	vector<unique_ptr<RedisRegisterContext>> contexts{};
+	vector<string> keys{};
+	contexts.reserve(end - bulk->next);
+	keys.reserve(end - bulk->next);
+	for (; bulk->next < end; bulk->next++) {
+		const auto& context = contexts.emplace_back(make_unique<RedisRegisterContext>(
+		    this, bulk->msgs[bulk->next], bulk->parameters, bulk->listener, mRecordConfig));
+		mLocalRegExpire.update(context->mRecord);
+		keys.emplace_back(context->mRecord->getKey().toRedisKey());
+	}
+
+	SLOGD << "Binding a batch of " << contexts.size() << " records";
+	FETCH_MANY_RECORDS_SCRIPT.call(*cmdSession, keys, [this, bulk, contexts = std::move(contexts)](
+	                                                      Session& session, Reply reply) mutable {
+		const auto* array = std::get_if<reply::Array>(&reply);
+		const Session::Ready* cmdSession = std::get_if<Session::Ready>(&session.getState());
+		if (array == nullptr || array->size() != contexts.size() || cmdSession == nullptr) {
+			SLOGE << "Unexpected reply on Redis pre-bind fetch of a batch: " << StreamableVariant(reply);
+			for (const auto& context : contexts) {
+				if (context->listener) context->listener->onError(SipStatus(SIP_500_INTERNAL_SERVER_ERROR));
+			}
+			sendNextBindBatch(bulk);
+			return;
+		}
+
+		/* Start a REDIS transaction for the whole batch */
+		cmdSession->command({"MULTI"}, {});
+		for (size_t i = 0; i < contexts.size(); i++) {
+			const auto element = (*array)[i];
+			const auto* currentContent = std::get_if<reply::Array>(&element);
+			if (currentContent == nullptr) {
+				SLOGE << "Unexpected reply on Redis pre-bind fetch of [fs:" << contexts[i]->mRecord->getKey() << "]: "
+				      << StreamableVariant(element);
+				if (contexts[i]->listener) contexts[i]->listener->onError(SipStatus(SIP_500_INTERNAL_SERVER_ERROR));
+				contexts[i].reset();
+				continue;
+			}
+			// On failure, the listener has already been notified
+			if (!updateRecordForBind(*currentContent, *contexts[i])) {
+				contexts[i].reset();
+				continue;
+			}
+			serializeChangeSet(*cmdSession, *contexts[i]);
+		}
+		cmdSession->timedCommand({"EXEC"}, [this, bulk, contexts = std::move(contexts)](Session&, Reply reply) mutable {
+			// On failure, every binding of the batch is retried on its own
+			for (auto& context : contexts) {
+				if (context) handleBind(reply, std::move(context));
+			}
+			sendNextBindBatch(bulk);
+		});
+	});
+}
+
 void RegistrarDbRedisAsync::handleClear(Reply reply, const RedisRegisterContext& context) {
 	const auto recordName = context.mRecord->getKey().toRedisKey() + " [" + std::to_string(context.token) + "]";
 	if (const auto* keysDeleted = std::get_if<reply::Integer>(&reply)) {
@@ -455,35 +596,15 @@ void RegistrarDbRedisAsync::doClear(const MsgSip& msg, const shared_ptr<ContactU
 void RegistrarDbRedisAsync::handleFetch(redis::async::Reply reply, const RedisRegisterContext& context) {
 	const auto& record = context.mRecord;
 	const auto recordName = record->getKey().toRedisKey() + " [" + std::to_string(context.token) + "]";
-	const auto insertIfActive = [&record = *record](auto&& contact) {
-		if (contact->isExpired()) return;
-
-		try {
-			record.insertOrUpdateBinding(std::move(contact), nullptr);
-		} catch (const InvalidCSeq&) {
-			// There can be a race condition on contact registration. If we get more REGISTERs (without sip instance)
-			// before Redis responded to the first, then we issue multiple insertion commands resulting in duplicated
-			// contacts, potentially with out-of-order CSeq. This situation will be resolved on the next bind (because
-			// all those duplicated contacts will match the new contact, and all be deleted), so in the meantime, let's
-			// just skip the duplicated contacts
-			SLOGW << "Illegal state detected in the RegistrarDb. Skipping contact: "
-			      << (contact ? contact->urlAsString() : "<moved out>");
-		} catch (const sofiasip::InvalidUrlError& e) {
-			SLOGW << "Invalid 'Contact' SIP URI [" << e.getUrl() << "]: " << e.getReason();
-		} catch (const std::exception& e) {
-			SLOGE << "Unexpected exception: " << e.what();
-		}
-	};
-
 	auto* listener = context.listener.get();
 	Match(reply).against(
-	    [&recordName, &insertIfActive, listener, &record, &context](const reply::Array& array) {
+	    [&recordName, listener, &record, &context](const reply::Array& array) {
 		    // This is the most common scenario: we want all contacts inside the record
 		    const auto contacts = array.pairwise();
 		    SLOGD << "GOT " << recordName << " --> " << contacts.size() << " contacts";
 		    if (0 < contacts.size()) {
 			    for (auto&& maybeExpired : parseContacts(contacts, context.mRecord->getConfig().messageExpiresName())) {
-				    insertIfActive(maybeExpired);
+				    insertIfActive(*record, std::move(maybeExpired));
 			    }
 			    if (listener) listener->onRecordFound(record);
 		    } else {
@@ -494,13 +615,13 @@ void RegistrarDbRedisAsync::handleFetch(redis::async::Reply reply, const RedisRe
 			    if (listener) listener->onRecordFound(context.mBindingParameters.globalExpire == 0 ? record : nullptr);
 		    }
 	    },
-	    [&context, &recordName, &insertIfActive, listener, &record](const reply::String& contact) {
+	    [&context, &recordName, listener, &record](const reply::String& contact) {
 		    // This is only when we want a contact matching a given gruu
 		    const char* gruu = context.mUniqueIdToFetch.c_str();
 		    if (!contact.empty()) {
 			    SLOGD << "GOT " << recordName << " for gruu " << gruu << " --> " << contact;
-			    insertIfActive(
-			        make_unique<ExtendedContact>(gruu, contact.data(), record->getConfig().messageExpiresName()));
+			    insertIfActive(*record, make_unique<ExtendedContact>(gruu, contact.data(),
+			                                                         record->getConfig().messageExpiresName()));
 			    if (listener) listener->onRecordFound(record);
 		    } else {
 			    SLOGD << "Contact matching gruu " << gruu << " in record " << recordName << " not found";
@@ -550,6 +671,104 @@ void RegistrarDbRedisAsync::doFetchInstance(const SipUri& url,
 	    [context = std::move(context), this](Session&, Reply reply) { handleFetch(reply, *context); });
 }
 
+void RegistrarDbRedisAsync::doFetchMany(const vector<SipUri>& urls,
+                                        const shared_ptr<ListContactUpdateListener>& listener) {
+	// fetch all the records at once (one HGETALL per record, run by a single script call)
+	if (urls.empty()) {
+		listener->onContactsUpdated();
+		return;
+	}
+	const Session::Ready* cmdSession;
+	if (!(cmdSession = mRedisClient.tryGetCmdSession())) {
+		listener->onError(SipStatus(SIP_500_INTERNAL_SERVER_ERROR));
+		return;
+	}
+
+	vector<shared_ptr<Record>> records{};
+	vector<string> keys{};
+	records.reserve(urls.size());
+	keys.reserve(urls.size());
+	for (const auto& url : urls) {
+		const auto& record = records.emplace_back(make_shared<Record>(url, mRecordConfig));
+		keys.emplace_back(record->getKey().toRedisKey());
+	}
+
+	SLOGD << "Fetching " << keys.size() << " records";
+	FETCH_MANY_RECORDS_SCRIPT.call(
+	    *cmdSession, keys, [records = std::move(records), listener](Session&, Reply reply) {
+		    if (const auto* array = std::get_if<reply::Array>(&reply)) {
+			    for (size_t i = 0; i < array->size() && i < records.size(); ++i) {
+				    const auto element = (*array)[i];
+				    const auto* contacts = std::get_if<reply::Array>(&element);
+				    if (contacts == nullptr || contacts->size() == 0) continue;
+
+				    const auto& record = records[i];
+				    for (auto&& maybeExpired :
+				         parseContacts(contacts->pairwise(), record->getConfig().messageExpiresName())) {
+					    insertIfActive(*record, std::move(maybeExpired));
+				    }
+				    if (!record->isEmpty()) listener->records.push_back(record);
+			    }
+		    } else {
+			    SLOGE << "Fetch many records script returned unexpected reply: " << StreamableVariant(reply);
+			    listener->onError(SipStatus(SIP_500_INTERNAL_SERVER_ERROR));
+			    return;
+		    }
+		    listener->onContactsUpdated();
+	    });
+}
+
+void RegistrarDbRedisAsync::doFetchWithAliases(const SipUri& url,
+                                               int maxStep,
+                                               const shared_ptr<ListContactUpdateListener>& listener) {
+	// walk through the aliases on the Redis side, so that they are all resolved in a single round-trip
+	const Session::Ready* cmdSession;
+	if (!(cmdSession = mRedisClient.tryGetCmdSession())) {
+		listener->onContactsUpdated();
+		return;
+	}
+
+	const auto key = Record::Key(url, mRecordConfig.useGlobalDomain());
+	SLOGD << "Fetching " << key.toRedisKey() << " and its aliases (up to " << maxStep << " steps)";
+	FETCH_WITH_ALIASES_SCRIPT.call(
+	    *cmdSession,
+	    {
+	        key.toRedisKey(),
+	        std::to_string(maxStep),
+	        mRecordConfig.useGlobalDomain() ? "yes" : "no",
+	        std::to_string(getCurrentTime()),
+	    },
+	    [listener, this](Session&, Reply reply) {
+		    if (const auto* array = std::get_if<reply::Array>(&reply)) {
+			    for (const auto entry : *array) {
+				    const auto* pair = std::get_if<reply::Array>(&entry);
+				    if (pair == nullptr || pair->size() != 2) continue;
+				    const auto redisKey = (*pair)[0];
+				    const auto fields = (*pair)[1];
+				    const auto* recordKey = std::get_if<reply::String>(&redisKey);
+				    const auto* contacts = std::get_if<reply::Array>(&fields);
+				    if (recordKey == nullptr || contacts == nullptr) continue;
+
+				    try {
+					    auto record =
+					        make_shared<Record>(Record::Key(recordKey->substr(string_view{"fs:"}.size())).toSipUri(),
+					                            mRecordConfig);
+					    for (auto&& maybeExpired :
+					         parseContacts(contacts->pairwise(), mRecordConfig.messageExpiresName())) {
+						    insertIfActive(*record, std::move(maybeExpired));
+					    }
+					    listener->records.push_back(std::move(record));
+				    } catch (const sofiasip::InvalidUrlError& e) {
+					    SLOGW << "Invalid Record key [" << e.getUrl() << "] while fetching aliases: " << e.getReason();
+				    }
+			    }
+		    } else {
+			    SLOGE << "Fetch with aliases script returned unexpected reply: " << StreamableVariant(reply);
+		    }
+		    listener->onContactsUpdated();
+	    });
+}
+
 void RegistrarDbRedisAsync::fetchExpiringContacts(
     time_t startTimestamp, float threshold, std::function<void(std::vector<ExtendedContact>&&)>&& callback) const {
 	const Session::Ready* cmdSession;
@@ -579,6 +798,45 @@ void RegistrarDbRedisAsync::fetchExpiringContacts(
 	    });
 }
 
+void RegistrarDbRedisAsync::scanAors(const string& cursor,
+                                     size_t count,
+                                     function<void(optional<AorsPage>&&)>&& callback) const {
+	const Session::Ready* cmdSession;
+	if (!(cmdSession = mRedisClient.tryGetCmdSession())) {
+		SLOGW << "Redis session not ready to send commands. Cancelling scanAors operation";
+		callback(nullopt);
+		return;
+	}
+
+	// Unlike KEYS, each SCAN call only walks a few slots of the keyspace and leaves Redis available in between.
+	cmdSession->command(
+	    {"SCAN", cursor.empty() ? "0"s : cursor, "MATCH", "fs:*", "COUNT", to_string(count)},
+	    [callback = std::move(callback)](Session&, Reply reply) {
+		    if (const auto* array = std::get_if<reply::Array>(&reply); array && array->size() == 2) {
+			    const auto nextCursor = (*array)[0];
+			    const auto keys = (*array)[1];
+			    const auto* cursorString = std::get_if<reply::String>(&nextCursor);
+			    const auto* keyArray = std::get_if<reply::Array>(&keys);
+			    if (cursorString && keyArray) {
+				    AorsPage page{};
+				    page.aors.reserve(keyArray->size());
+				    for (const auto key : *keyArray) {
+					    // Strip the "fs:" prefix of the record keys
+					    if (const auto* keyString = std::get_if<reply::String>(&key)) {
+						    page.aors.emplace_back(keyString->substr(3));
+					    }
+				    }
+				    if (*cursorString != "0") page.nextCursor = *cursorString;
+				    callback(std::move(page));
+				    return;
+			    }
+		    }
+
+		    SLOGE << "Redis SCAN returned unexpected reply: " << StreamableVariant(reply);
+		    callback(nullopt);
+	    });
+}
+
 void RegistrarDbRedisAsync::forceDisconnectForTest(RegistrarDbRedisAsync& thiz) {
 	thiz.setWritable(false);
 	RedisClient::forceDisconnectForTest(thiz.mRedisClient);
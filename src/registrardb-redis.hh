@@ -20,6 +20,7 @@
 
 #include <chrono>
 #include <string>
+#include <unordered_set>
 #include <variant>
 #include <vector>
 
@@ -31,6 +32,7 @@
 
 #include "flexisip/sofia-wrapper/msg-sip.hh"
 #include "flexisip/sofia-wrapper/su-root.hh"
+#include "flexisip/sofia-wrapper/timer.hh"
 
 #include "libhiredis-wrapper/redis-async-session.hh"
 #include "libhiredis-wrapper/redis-reply.hh"
@@ -105,6 +107,9 @@ public:
 	void fetchExpiringContacts(time_t startTimestamp,
 	                           float threshold,
 	                           std::function<void(std::vector<ExtendedContact>&&)>&& callback) const override;
+	void scanAors(const std::string& cursor,
+	              size_t count,
+	              std::function<void(std::optional<AorsPage>&&)>&& callback) const override;
 
 	std::optional<std::tuple<const redis::async::Session::Ready&, const redis::async::SubscriptionSession::Ready&>>
 	connect();
@@ -125,22 +130,45 @@ public:
 	void doBind(const MsgSip& msg,
 	            const BindingParameters& parameters,
 	            const std::shared_ptr<ContactUpdateListener>& listener) override;
+	void doBindMany(std::vector<MsgSip>&& msgs,
+	                const BindingParameters& parameters,
+	                const std::shared_ptr<ContactUpdateListener>& listener) override;
 	void doClear(const MsgSip& msg, const std::shared_ptr<ContactUpdateListener>& listener) override;
 	void doFetch(const SipUri& url, const std::shared_ptr<ContactUpdateListener>& listener) override;
 	void doFetchInstance(const SipUri& url,
 	                     const std::string& uniqueId,
 	                     const std::shared_ptr<ContactUpdateListener>& listener) override;
+	void doFetchMany(const std::vector<SipUri>& urls,
+	                 const std::shared_ptr<ListContactUpdateListener>& listener) override;
+	void doFetchWithAliases(const SipUri& url,
+	                        int maxStep,
+	                        const std::shared_ptr<ListContactUpdateListener>& listener) override;
 	void subscribe(const Record::Key& topic) override;
 	void unsubscribe(const Record::Key& topic) override;
 	void publish(const Record::Key& topic, const std::string& uid) override;
 
 private:
+	// State of a bulk bind, shared by its batches
+	struct BulkBind {
+		std::vector<MsgSip> msgs;
+		BindingParameters parameters;
+		std::shared_ptr<ContactUpdateListener> listener;
+		size_t next = 0; // Index of the first message that is not part of a batch yet
+	};
+
 	static void sBindRetry(void* ud) noexcept;
 	void setWritable(bool value);
 
 	void serializeAndSendToRedis(RedisRegisterContext&, redis::async::Session::CommandCallback&&);
+	// Queue the commands applying the change set of the context, within a transaction that has already been started
+	void serializeChangeSet(const redis::async::Session::Ready&, const RedisRegisterContext&);
+	// Load the current content of the record, then update it with the REGISTER of the context. Notifies the listener
+	// and returns false on failure.
+	bool updateRecordForBind(const redis::reply::Array& currentContent, RedisRegisterContext&);
+	void sendNextBindBatch(const std::shared_ptr<BulkBind>&);
 	void subscribe(std::string_view topic);
 	void subscribeToKeyExpiration();
+	void flushSubscriptions();
 	static std::vector<std::unique_ptr<ExtendedContact>> parseContacts(const redis::reply::ArrayOfPairs&,
 	                                                                   const std::string& messageExpiresName);
 
@@ -161,6 +189,10 @@ private:
 	std::function<void(const Record::Key&, std::optional<std::string_view>)> mNotifyContactListener;
 	std::function<void(bool)> mNotifyStateListener;
 	bool mWritable{};
+	// SUBSCRIBE and UNSUBSCRIBE commands are batched until the next iteration of the main loop.
+	sofiasip::Timer mSubscriptionsFlushTimer;
+	std::unordered_set<std::string> mPendingSubscriptions{};
+	std::unordered_set<std::string> mPendingUnsubscriptions{};
 };
 
 } // namespace flexisip
@@ -16,6 +16,7 @@
     along with this program. If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
 #include <exception>
 #include <iostream>
 #include <sstream>
@@ -85,15 +86,32 @@ void Client::onNotifyReceived(const std::shared_ptr<const linphone::Content>& bo
 
 	unique_ptr<Reginfo> ri(parseReginfo(data, Xsd::XmlSchema::Flags::dont_validate));
 
+	const bool partial = ri->getState() == State::Value::partial;
+	if (partial && mVersion && ri->getVersion() <= *mVersion) {
+		SLOGW << "RegistrationEvent::Client - Ignoring outdated partial state (version " << ri->getVersion()
+		      << " <= " << *mVersion << ")";
+		return;
+	}
+	mVersion = ri->getVersion();
+
 	for (const auto& registration : ri->getRegistration()) {
 		if (registration.getState() == Registration::StateType::terminated) {
+			mDevices.clear();
 			if (mListener) mListener->onNotifyReceived({}); // Notifying that 0 devices are registered.
 			continue;
 		}
 
-		list<shared_ptr<ParticipantDeviceIdentity>> participantDevices;
+		// A full state replaces the known devices, a partial one only carries the contacts that changed.
+		auto devices = partial ? mDevices : decltype(mDevices){};
 		size_t refreshed = 0;
 		for (const auto& contact : registration.getContact()) {
+			const auto known = find_if(devices.begin(), devices.end(),
+			                           [&contact](const auto& device) { return device.first == contact.getUri(); });
+			if (contact.getState() == Contact::StateType::terminated) {
+				if (known != devices.end()) devices.erase(known);
+				continue;
+			}
+
 			auto partDeviceAddr = Factory::get()->createAddress(contact.getUri());
 			Contact::UnknownParamSequence ups = contact.getUnknownParam();
 			string displayName = contact.getDisplayName() ? contact.getDisplayName()->c_str() : string("");
@@ -108,12 +126,19 @@ void Client::onNotifyReceived(const std::shared_ptr<const linphone::Content>& bo
 					if (mListener) mListener->onRefreshed(identity);
 					refreshed++;
 				}
-				participantDevices.push_back(identity);
+				if (known != devices.end()) known->second = identity;
+				else devices.emplace_back(contact.getUri(), identity);
 				break;
 			}
 		}
 
-		if (refreshed < participantDevices.size()) {
+		const auto changed = partial ? refreshed < registration.getContact().size() : refreshed < devices.size();
+		mDevices = std::move(devices);
+		if (changed) {
+			list<shared_ptr<ParticipantDeviceIdentity>> participantDevices;
+			for (const auto& [_, identity] : mDevices) {
+				participantDevices.push_back(identity);
+			}
 			if (mListener) mListener->onNotifyReceived(participantDevices);
 		} /* else: Everything is refreshed, notifying a reception would be redundant */
 	}
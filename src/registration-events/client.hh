@@ -19,6 +19,10 @@
 #pragma once
 
 #include <iostream>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include <linphone++/linphone.hh>
 
@@ -80,6 +84,9 @@ friend class ClientFactory;
 		void onSubscriptionStateChanged(linphone::SubscriptionState state);
 		std::shared_ptr<linphone::Event> mSubscribeEvent;
 		ClientListener *mListener = nullptr;
+		// Devices of the last notified state, in the order they have been registered, indexed by contact URI.
+		std::vector<std::pair<std::string, std::shared_ptr<linphone::ParticipantDeviceIdentity>>> mDevices;
+		std::optional<unsigned long long> mVersion;
 		std::shared_ptr<ClientFactory> mFactory;
 		std::shared_ptr<linphone::Address> mTo;
 		static constexpr const char *eventKey = "Regevent::Client";
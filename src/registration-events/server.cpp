@@ -18,6 +18,7 @@
 
 #include "server.hh"
 
+#include <algorithm>
 #include <memory>
 
 #include "linphone++/enums.hh"
@@ -40,6 +41,41 @@ namespace RegistrationEvent {
 
 static constexpr const char* CONTENT_TYPE = "application/reginfo+xml";
 
+namespace {
+
+shared_ptr<Content> makeContent(const Reginfo& reginfo) {
+	stringstream xmlBody;
+	serializeReginfo(xmlBody, reginfo);
+	string body = xmlBody.str();
+
+	auto content = Factory::get()->createContent();
+	content->setBuffer((uint8_t*)body.data(), body.length());
+	content->setType("application");
+	content->setSubtype("reginfo+xml");
+	return content;
+}
+
+template <typename NotifiedContact>
+Contact makeContact(const NotifiedContact& notified, Contact::StateType state, Contact::EventType event) {
+	Contact contact{notified.uri, state, event, notified.uri};
+	if (notified.expires) contact.setExpires(*notified.expires);
+	for (const auto& [name, value] : notified.params) {
+		auto unknownParam = UnknownParam(name);
+		if (value) unknownParam.append(*value);
+		contact.getUnknownParam().push_back(unknownParam);
+	}
+	contact.setDisplayName(notified.displayName);
+	return contact;
+}
+
+} // namespace
+
+bool Server::Subscriptions::NotifiedContact::operator==(const NotifiedContact& other) const {
+	return uri == other.uri && uniqueId == other.uniqueId && registerTime == other.registerTime &&
+	       expireTime == other.expireTime && expires == other.expires && params == other.params &&
+	       displayName == other.displayName;
+}
+
 void Server::Subscriptions::onSubscribeReceived(const shared_ptr<Core>& core,
                                                 const shared_ptr<linphone::Event>& lev,
                                                 const string&,
@@ -65,21 +101,21 @@ void Server::Subscriptions::onSubscribeReceived(const shared_ptr<Core>& core,
 		return;
 	}
 
-	const auto result = mEvents.emplace(Record::Key(url, mRegistrarDb->useGlobalDomain()).toString(), lev);
-	if (!result.second) {
-		SLOGE << "Regevent server: There is already a subscription for: " << result.first->first;
-		lev->denySubscription(Reason::Busy);
-		return;
+	Record::Key key{url, mRegistrarDb->useGlobalDomain()};
+	auto& watchers = mWatchers[key.asString()];
+	if (!watchers) {
+		watchers = make_shared<Watchers>();
+		watchers->aor = lev->getTo()->asString();
+		watchers->id = key.asString();
+		// Subscribe takes a weak_ptr. Passing it the watchers lets us unsubscribe automatically when the last
+		// subscription to this AoR is terminated.
+		mRegistrarDb->subscribe(key, shared_ptr<ContactRegisteredListener>{watchers, this});
 	}
+	watchers->pending.push_back(lev);
 
 	// Accept the sub to be able to notify it
 	lev->acceptSubscription();
-	// We need the core to send the NOTIFY (and it holds `this`). So we pass it as the callback to make sure it lives
-	// long enough
-	mRegistrarDb->fetch(url, {core, this}, true);
-	// Subscribe takes a weak_ptr. Passing it the event itself lets us unsubscribe automatically by deleting the event.
-	mRegistrarDb->subscribe(Record::Key(url, mRegistrarDb->useGlobalDomain()),
-	                        std::shared_ptr<ContactRegisteredListener>{lev, this});
+	mRegistrarDb->fetch(url, make_shared<InitialStateListener>(core, *this, key.asString(), lev), true);
 }
 
 void Server::Subscriptions::onSubscriptionStateChanged(const std::shared_ptr<linphone::Core>&,
@@ -95,95 +131,186 @@ void Server::Subscriptions::onSubscriptionStateChanged(const std::shared_ptr<lin
 				return;
 			}
 
-			mEvents.erase(Record::Key(url, mRegistrarDb->useGlobalDomain()).toString());
+			const auto watchers = mWatchers.find(Record::Key(url, mRegistrarDb->useGlobalDomain()).toString());
+			if (watchers == mWatchers.end()) return;
+			auto& events = watchers->second->events;
+			auto& pending = watchers->second->pending;
+			events.erase(remove(events.begin(), events.end(), lev), events.end());
+			pending.erase(remove(pending.begin(), pending.end(), lev), pending.end());
+			if (events.empty() && pending.empty()) mWatchers.erase(watchers);
 		} break;
 		default:
 			break;
 	}
 }
 
-void Server::Subscriptions::onRecordFound(const shared_ptr<Record>& r) {
-	processRecord(r, "");
+void Server::Subscriptions::InitialStateListener::onRecordFound(const shared_ptr<Record>& record) {
+	mSubscriptions.sendInitialState(mKey, mEvent, record);
 }
 
-void Server::Subscriptions::onContactRegistered(const shared_ptr<Record>& r, const string& uidOfFreshlyRegistered) {
-	processRecord(r, uidOfFreshlyRegistered);
+void Server::Subscriptions::InitialStateListener::onError(const SipStatus&) {
+	SLOGW << "RegistrationEvent::Server - Failed to fetch the registration of " << mKey
+	      << ", notifying an empty state.";
+	mSubscriptions.sendInitialState(mKey, mEvent, nullptr);
+}
+
+void Server::Subscriptions::InitialStateListener::onInvalid(const SipStatus& status) {
+	onError(status);
 }
 
-void Server::Subscriptions::processRecord(const shared_ptr<Record>& r, const std::string& uidOfFreshlyRegistered) {
+void Server::Subscriptions::onContactRegistered(const shared_ptr<Record>& r, const string& uidOfFreshlyRegistered) {
 	if (!r) {
 		SLOGW << "RegistrationEvent::Server - Ignoring registration notification with null record.";
 		return;
 	}
 
 	const auto& aor = r->getKey().asString();
-	const auto maybeEvent = mEvents.find(aor);
-	if (maybeEvent == mEvents.end()) {
+	const auto watchers = mWatchers.find(aor);
+	if (watchers == mWatchers.end()) {
 		SLOGW << "RegistrationEvent::Server - Ignoring registration of a contact no one is subscribed to. "
 		         "(aor: "
 		      << aor << ")";
 		return;
 	}
-	auto& event = *maybeEvent->second;
 
-	Reginfo ri{0, State::Value::full};
-	Registration re{Uri(event.getTo()->asString().c_str()), aor.c_str(), Registration::StateType::active};
-	sofiasip::Home home{};
+	update(*watchers->second, r, uidOfFreshlyRegistered);
+}
 
-	for (const auto& ec : r->getExtendedContacts()) {
-		auto addr = r->getPubGruu(ec, home.home());
+void Server::Subscriptions::sendInitialState(const string& key,
+                                             const shared_ptr<linphone::Event>& event,
+                                             const shared_ptr<Record>& record) {
+	const auto maybeWatchers = mWatchers.find(key);
+	if (maybeWatchers == mWatchers.end()) return;
+	// Keep the watchers alive: notifying may terminate the subscriptions.
+	const auto watchers = maybeWatchers->second;
+	auto& pending = watchers->pending;
+	const auto it = find(pending.begin(), pending.end(), event);
+	if (it == pending.end()) return; // Terminated in the meantime.
+	pending.erase(it);
+
+	// Bring the already notified watchers up to date so that they share the state (and version) sent to the new one.
+	update(*watchers, record, "");
+	if (!watchers->fullState) watchers->fullState = makeFullState(*watchers, *watchers->contacts);
+
+	watchers->events.push_back(event);
+	event->notify(watchers->fullState);
+}
+
+void Server::Subscriptions::update(Watchers& watchers,
+                                   const shared_ptr<Record>& record,
+                                   const string& uidOfFreshlyRegistered) {
+	auto contacts = makeContacts(record);
+	if (!watchers.contacts || watchers.events.empty()) {
+		// No one has been notified of the previous state yet, nothing to compare the new one with.
+		if (watchers.contacts && *watchers.contacts == contacts) return;
+		watchers.contacts = std::move(contacts);
+		watchers.fullState = nullptr;
+		return;
+	}
+
+	const auto& previous = *watchers.contacts;
+	shared_ptr<Content> notifyContent{};
+	if (mPartialNotifications) {
+		Registration re{Uri(watchers.aor.c_str()), watchers.id.c_str(), Registration::StateType::active};
+		for (const auto& contact : contacts) {
+			const auto old = find_if(previous.begin(), previous.end(),
+			                         [&contact](const auto& notified) { return notified.uri == contact.uri; });
+			if (old != previous.end() && *old == contact && contact.uniqueId != uidOfFreshlyRegistered) continue;
+			// Same event mapping as in full states.
+			re.getContact().push_back(makeContact(contact, Contact::StateType::active,
+			                                      contact.uniqueId == uidOfFreshlyRegistered
+			                                          ? Contact::EventType::refreshed
+			                                          : Contact::EventType::registered));
+		}
+		const auto now = getCurrentTime();
+		for (const auto& old : previous) {
+			if (find_if(contacts.begin(), contacts.end(), [&old](const auto& contact) {
+				    return contact.uri == old.uri;
+			    }) != contacts.end())
+				continue;
+			re.getContact().push_back(makeContact(old, Contact::StateType::terminated,
+			                                      old.expireTime <= now ? Contact::EventType::expired
+			                                                            : Contact::EventType::unregistered));
+		}
+		if (re.getContact().empty()) return; // Nothing changed from the watchers' point of view.
+
+		re.setState(contacts.empty() ? Registration::StateType::terminated : Registration::StateType::active);
+		Reginfo ri{++watchers.version, State::Value::partial};
+		ri.getRegistration().push_back(re);
+		notifyContent = makeContent(ri);
+		watchers.fullState = nullptr;
+	} else {
+		++watchers.version;
+		notifyContent = makeFullState(watchers, contacts, uidOfFreshlyRegistered);
+		// The full state sent to new subscriptions must not flag the freshly registered contact.
+		watchers.fullState = uidOfFreshlyRegistered.empty() ? notifyContent : nullptr;
+	}
+	watchers.contacts = std::move(contacts);
+
+	// Notifying may terminate a subscription, and thus alter the list.
+	const auto events = watchers.events;
+	for (const auto& event : events) {
+		event->notify(notifyContent);
+	}
+}
+
+vector<Server::Subscriptions::NotifiedContact> Server::Subscriptions::makeContacts(const shared_ptr<Record>& record) {
+	vector<NotifiedContact> contacts{};
+	if (!record) return contacts;
+
+	const auto& aor = record->getKey().asString();
+	sofiasip::Home home{};
+	contacts.reserve(record->getExtendedContacts().size());
+	for (const auto& ec : record->getExtendedContacts()) {
+		auto addr = record->getPubGruu(ec, home.home());
 		if (!addr) {
 			SLOGE << "RegistrationEvent::Server - Contact has no GRUU, skipping. (contact: " << ec->urlAsString()
 			      << ", aor: " << aor << ")";
 			continue;
 		}
-		bool justRegistered = (ec->mKey == uidOfFreshlyRegistered);
 
-		Contact contact(url_as_string(home.home(), addr), Contact::StateType::active,
-		                justRegistered ? Contact::EventType::refreshed : Contact::EventType::registered,
-		                url_as_string(home.home(), addr));
+		auto& contact = contacts.emplace_back();
+		contact.uri = url_as_string(home.home(), addr);
+		contact.uniqueId = ec->mKey.str();
+		contact.registerTime = ec->getRegisterTime();
+		contact.expireTime = ec->getExpireTime();
 
 		// expires
 		if (ec->mSipContact->m_expires) {
-			contact.setExpires(atoi(ec->mSipContact->m_expires));
+			contact.expires = strtoul(ec->mSipContact->m_expires, nullptr, 10);
 		}
 
 		// unknown-params
 		if (ec->mSipContact->m_params) {
-			size_t i;
-
-			for (i = 0; ec->mSipContact->m_params[i]; i++) {
+			for (size_t i = 0; ec->mSipContact->m_params[i]; i++) {
 				auto param = StringUtils::split(std::string_view{ec->mSipContact->m_params[i]}, "=");
-
-				auto unknownParam = UnknownParam(std::string(param.front()));
+				auto& unknownParam = contact.params.emplace_back(std::string(param.front()), nullopt);
 				if (param.size() == 2) {
-					unknownParam.append(StringUtils::unquote(std::string(param.back())));
+					unknownParam.second = StringUtils::unquote(std::string(param.back()));
 				}
-
-				contact.getUnknownParam().push_back(unknownParam);
 			}
 		}
 
-		contact.setDisplayName(ec->getDeviceName().asString());
-		re.getContact().push_back(contact);
+		contact.displayName = ec->getDeviceName().asString();
 	}
+	return contacts;
+}
 
-	re.setState(r->getExtendedContacts().size() == 0 ? Registration::StateType::terminated
-	                                                 : Registration::StateType::active);
-
+shared_ptr<Content> Server::Subscriptions::makeFullState(const Watchers& watchers,
+                                                         const vector<NotifiedContact>& contacts,
+                                                         const string& uidOfFreshlyRegistered) {
+	Reginfo ri{watchers.version, State::Value::full};
+	Registration re{Uri(watchers.aor.c_str()), watchers.id.c_str(),
+	                contacts.empty() ? Registration::StateType::terminated : Registration::StateType::active};
+	for (const auto& contact : contacts) {
+		re.getContact().push_back(makeContact(contact, Contact::StateType::active,
+		                                      contact.uniqueId == uidOfFreshlyRegistered
+		                                          ? Contact::EventType::refreshed
+		                                          : Contact::EventType::registered));
+	}
 	ri.getRegistration().push_back(re);
-
-	stringstream xmlBody;
-	serializeReginfo(xmlBody, ri);
-	string body = xmlBody.str();
-
-	auto notifyContent = Factory::get()->createContent();
-	notifyContent->setBuffer((uint8_t*)body.data(), body.length());
-	notifyContent->setType("application");
-	notifyContent->setSubtype("reginfo+xml");
-
-	event.notify(notifyContent);
-};
+	return makeContent(ri);
+}
 
 void Server::_init() {
 	mCore = Factory::get()->createCore("", "", nullptr);
@@ -205,7 +332,8 @@ void Server::_init() {
 	}
 
 	mCore->setTransports(regEventTransport);
-	mCore->addListener(make_shared<Subscriptions>(mRegistrarDb));
+	mCore->addListener(
+	    make_shared<Subscriptions>(mRegistrarDb, config->get<ConfigBoolean>("partial-notifications")->read()));
 	mCore->start();
 }
 
@@ -223,6 +351,11 @@ namespace {
 auto& defineConfig = ConfigManager::defaultInit().emplace_back([](GenericStruct& root) {
 	ConfigItemDescriptor items[] = {{String, "transport", "SIP uri on which the RegEvent server is listening on.",
 	                                 "sip:127.0.0.1:6065;transport=tcp"},
+	                                {Boolean, "partial-notifications",
+	                                 "Once a watcher has received the full state of a registration, only notify it of the "
+	                                 "contacts that have changed (RFC3680 partial state). Only enable it if all the "
+	                                 "watchers support partial states: conference servers older than this one do not.",
+	                                 "false"},
 	                                config_item_end};
 
 	auto uS = make_unique<GenericStruct>(
@@ -18,9 +18,13 @@
 
 #pragma once
 
+#include <ctime>
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <linphone++/linphone.hh>
 
@@ -34,14 +38,73 @@ namespace RegistrationEvent {
 
 class Server : public ServiceServer {
 public:
-	class Subscriptions : public linphone::CoreListener,
-	                      public ContactRegisteredListener,
-	                      public ContactUpdateListener {
+	/**
+	 * Answers the 'reg' SUBSCRIBEs and notifies the watchers of the changes of the registrations they watch.
+	 *
+	 * All the watchers of an AoR share the same state: the first NOTIFY of a subscription carries the full state of
+	 * the registration and, if partial notifications are enabled, the following ones only carry the contacts that have
+	 * changed (RFC 3680 section 5.3). Documents are versioned per AoR and serialized once for all its watchers.
+	 */
+	class Subscriptions : public linphone::CoreListener, public ContactRegisteredListener {
 	public:
-		Subscriptions(const std::shared_ptr<RegistrarDb>& registrarDb) : mRegistrarDb{registrarDb} {
+		explicit Subscriptions(const std::shared_ptr<RegistrarDb>& registrarDb, bool partialNotifications = false)
+		    : mRegistrarDb{registrarDb}, mPartialNotifications{partialNotifications} {
 		}
 
 	private:
+		// What has last been notified about a contact of the registration.
+		struct NotifiedContact {
+			std::string uri{};
+			std::string uniqueId{};
+			std::time_t registerTime{};
+			std::time_t expireTime{};
+			std::optional<unsigned long> expires{};
+			std::vector<std::pair<std::string, std::optional<std::string>>> params{};
+			std::string displayName{};
+
+			bool operator==(const NotifiedContact& other) const;
+		};
+
+		// The subscriptions to the registration of an AoR.
+		struct Watchers {
+			// Address of the registration, as found in the To header of the first subscription.
+			std::string aor{};
+			// Key of the record in the registrar database.
+			std::string id{};
+			// Subscriptions that have already received the full state.
+			std::vector<std::shared_ptr<linphone::Event>> events{};
+			// Subscriptions waiting for the registrar to answer before receiving the full state.
+			std::vector<std::shared_ptr<linphone::Event>> pending{};
+			// Last notified state, unset until the registrar answered once.
+			std::optional<std::vector<NotifiedContact>> contacts{};
+			unsigned int version = 0;
+			// Full-state document of the current version, built on demand for new subscriptions.
+			std::shared_ptr<linphone::Content> fullState{};
+		};
+
+		class InitialStateListener : public ContactUpdateListener {
+		public:
+			InitialStateListener(const std::shared_ptr<linphone::Core>& core,
+			                     Subscriptions& subscriptions,
+			                     const std::string& key,
+			                     const std::shared_ptr<linphone::Event>& event)
+			    : mCore{core}, mSubscriptions{subscriptions}, mKey{key}, mEvent{event} {
+			}
+
+			void onRecordFound(const std::shared_ptr<Record>& record) override;
+			void onError(const SipStatus&) override;
+			void onInvalid(const SipStatus&) override;
+			void onContactUpdated(const std::shared_ptr<ExtendedContact>&) override {
+			}
+
+		private:
+			// We need the core to send the NOTIFY (and it holds the subscriptions), make sure it lives long enough.
+			std::shared_ptr<linphone::Core> mCore;
+			Subscriptions& mSubscriptions;
+			std::string mKey;
+			std::shared_ptr<linphone::Event> mEvent;
+		};
+
 		void onSubscribeReceived(const std::shared_ptr<linphone::Core>&,
 		                         const std::shared_ptr<linphone::Event>&,
 		                         const std::string&,
@@ -50,20 +113,25 @@ public:
 		                                const std::shared_ptr<linphone::Event>& linphoneEvent,
 		                                linphone::SubscriptionState state) override;
 
-		void onRecordFound(const std::shared_ptr<Record>& r) override;
-		void onError(const SipStatus&) override {
-		}
-		void onInvalid(const SipStatus&) override {
-		}
-		void onContactUpdated(const std::shared_ptr<ExtendedContact>&) override {
-		}
-
 		void onContactRegistered(const std::shared_ptr<Record>&, const std::string& uidOfFreshlyRegistered) override;
 
-		void processRecord(const std::shared_ptr<Record>&, const std::string& uidOfFreshlyRegistered);
-
-		std::unordered_map<std::string, std::shared_ptr<linphone::Event>> mEvents{};
+		void sendInitialState(const std::string& key,
+		                      const std::shared_ptr<linphone::Event>& event,
+		                      const std::shared_ptr<Record>& record);
+		/**
+		 * Compare the record to the last notified state and notify the changes to all the watchers that already
+		 * received the full state.
+		 */
+		void update(Watchers& watchers, const std::shared_ptr<Record>& record, const std::string& uidOfFreshlyRegistered);
+
+		static std::vector<NotifiedContact> makeContacts(const std::shared_ptr<Record>& record);
+		static std::shared_ptr<linphone::Content> makeFullState(const Watchers& watchers,
+		                                                        const std::vector<NotifiedContact>& contacts,
+		                                                        const std::string& uidOfFreshlyRegistered = "");
+
+		std::unordered_map<std::string, std::shared_ptr<Watchers>> mWatchers{};
 		std::shared_ptr<RegistrarDb> mRegistrarDb;
+		bool mPartialNotifications;
 	};
 
 	static const std::string CONTENT_TYPE;
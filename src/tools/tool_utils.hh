@@ -78,7 +78,7 @@ bool compare(const ExtendedContact& ec1,
 	check("alias", ec1.mAlias, alias);
 	check("callid", ec1.mCallId, common.mCallId);
 	check("line", ec1.mKey.str(), common.mKey);
-	check("path", ec1.mPath, common.mPath);
+	check("path", std::list<std::string>(ec1.getPath().begin(), ec1.getPath().end()), common.mPath);
 	check("cseq", ec1.mCSeq, cseq);
 	check("mExpires", ec1.getSipExpires().count(), expires.count());
 	check("mQ", ec1.mQ, q);
@@ -89,7 +89,7 @@ bool compare(const ExtendedContact& ec1,
 }
 
 bool compare(const ExtendedContact& ec1, const ExtendedContact& ec2) {
-	ExtendedContactCommon ecc(ec2.mPath, ec2.mCallId, ec2.mKey);
+	ExtendedContactCommon ecc({ec2.getPath().begin(), ec2.getPath().end()}, ec2.mCallId, ec2.mKey);
 	return compare(ec1, ec2.mAlias, ecc, ec2.mCSeq, ec2.getSipExpires(), ec2.mQ,
 	               ExtendedContact::urlToString(ec2.mSipContact->m_url), ec2.getRegisterTime());
 }
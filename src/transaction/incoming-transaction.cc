@@ -23,6 +23,7 @@
 #include "flexisip/logmanager.hh"
 
 #include "agent.hh"
+#include "utils/pool-allocator.hh"
 
 using namespace flexisip;
 using namespace std;
@@ -105,9 +106,9 @@ int IncomingTransaction::_callback(nta_incoming_magic_t* magic, nta_incoming_t*,
 	IncomingTransaction* it = reinterpret_cast<IncomingTransaction*>(magic);
 	LOGD("IncomingTransaction callback %p", it);
 	if (sip != nullptr) {
-		auto ev = make_shared<RequestSipEvent>(
+		auto ev = makePooled<RequestSipEvent>(
 		    it->shared_from_this(),
-		    make_shared<MsgSip>(ownership::owned(nta_incoming_getrequest_ackcancel(it->mIncoming))));
+		    makePooled<MsgSip>(ownership::owned(nta_incoming_getrequest_ackcancel(it->mIncoming))));
 		it->mAgent.lock()->sendRequestEvent(ev);
 	} else {
 		it->destroy();
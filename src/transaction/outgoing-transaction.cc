@@ -25,6 +25,7 @@
 #include "flexisip/logmanager.hh"
 
 #include "agent.hh"
+#include "utils/pool-allocator.hh"
 
 using namespace flexisip;
 using namespace std;
@@ -144,9 +145,9 @@ int OutgoingTransaction::_callback(nta_outgoing_magic_t* magic, nta_outgoing_t*,
 	LOGD("OutgoingTransaction[%p] : _callback", otr);
 	if (sip != nullptr) {
 		auto outgoingAgent = dynamic_pointer_cast<OutgoingAgent>(otr->shared_from_this());
-		auto msgSip = make_shared<MsgSip>(ownership::owned(nta_outgoing_getresponse(otr->mOutgoing.borrow())));
-		auto sipEvent = make_shared<ResponseSipEvent>(outgoingAgent, msgSip,
-		                                              otr->mAgent.lock()->getIncomingTport(msgSip->getMsg()));
+		auto msgSip = makePooled<MsgSip>(ownership::owned(nta_outgoing_getresponse(otr->mOutgoing.borrow())));
+		auto sipEvent = makePooled<ResponseSipEvent>(outgoingAgent, msgSip,
+		                                             otr->mAgent.lock()->getIncomingTport(msgSip->getMsg()));
 
 		otr->mAgent.lock()->sendResponseEvent(sipEvent);
 
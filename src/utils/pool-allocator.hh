@@ -0,0 +1,147 @@
+/*
+    Flexisip, a flexible SIP proxy server with media capabilities.
+    Copyright (C) 2010-2024 Belledonne Communications SARL, All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace flexisip {
+
+/**
+ * @class FreeList
+ * @brief Per-thread cache of memory blocks of a given size.
+ *
+ * Released blocks are kept, up to kMaxBlocks, and handed back on the next allocation of the same size instead of going
+ * through the system allocator. A block may be released by another thread than the one which has allocated it: it
+ * simply joins the cache of the releasing thread.
+ */
+template <std::size_t Size, std::size_t Alignment>
+class FreeList {
+public:
+	static constexpr std::size_t kMaxBlocks = 1024;
+
+	static void* allocate() {
+		auto* list = get();
+		if (list == nullptr || list->mHead == nullptr) return ::operator new(kBlockSize);
+		auto* block = list->mHead;
+		list->mHead = block->next;
+		list->mCount--;
+		return block;
+	}
+
+	static void release(void* ptr) noexcept {
+		auto* list = get();
+		if (list == nullptr || list->mCount >= kMaxBlocks) {
+			::operator delete(ptr);
+			return;
+		}
+		auto* block = static_cast<Block*>(ptr);
+		block->next = list->mHead;
+		list->mHead = block;
+		list->mCount++;
+	}
+
+	/**
+	 * Number of blocks currently cached by the calling thread.
+	 */
+	static std::size_t cachedBlocks() noexcept {
+		auto* list = get();
+		return list ? list->mCount : 0;
+	}
+
+	FreeList(const FreeList&) = delete;
+	~FreeList() {
+		sDestroyed = true;
+		while (mHead) {
+			auto* block = mHead;
+			mHead = block->next;
+			::operator delete(block);
+		}
+	}
+
+private:
+	struct Block {
+		Block* next;
+	};
+	static_assert(Alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "over-aligned types are not supported");
+	static constexpr std::size_t kBlockSize = std::max(Size, sizeof(Block));
+
+	FreeList() = default;
+
+	// Blocks may be released while the thread is exiting, after its free list has been destroyed.
+	static FreeList* get() noexcept {
+		if (sDestroyed) return nullptr;
+		thread_local FreeList list{};
+		return &list;
+	}
+
+	static inline thread_local bool sDestroyed = false;
+
+	Block* mHead = nullptr;
+	std::size_t mCount = 0;
+};
+
+/**
+ * @class PoolAllocator
+ * @brief Standard allocator recycling single object allocations through a FreeList.
+ *
+ * Meant for short-lived objects that are created at a high rate on the main loop, e.g. SIP events. Use it with
+ * std::allocate_shared() (see makePooled()) so that the object and its control block share one recycled block.
+ */
+template <typename T>
+class PoolAllocator {
+public:
+	using value_type = T;
+
+	PoolAllocator() noexcept = default;
+	template <typename U>
+	PoolAllocator(const PoolAllocator<U>&) noexcept {
+	}
+
+	T* allocate(std::size_t n) {
+		if (n != 1) return std::allocator<T>{}.allocate(n);
+		return static_cast<T*>(FreeList<sizeof(T), alignof(T)>::allocate());
+	}
+	void deallocate(T* ptr, std::size_t n) noexcept {
+		if (n != 1) return std::allocator<T>{}.deallocate(ptr, n);
+		FreeList<sizeof(T), alignof(T)>::release(ptr);
+	}
+
+	template <typename U>
+	bool operator==(const PoolAllocator<U>&) const noexcept {
+		return true;
+	}
+	template <typename U>
+	bool operator!=(const PoolAllocator<U>&) const noexcept {
+		return false;
+	}
+};
+
+/**
+ * Same as std::make_shared() but the memory block is taken from, and given back to, a FreeList.
+ */
+template <typename T, typename... Args>
+std::shared_ptr<T> makePooled(Args&&... args) {
+	return std::allocate_shared<T>(PoolAllocator<T>{}, std::forward<Args>(args)...);
+}
+
+} // namespace flexisip
@@ -0,0 +1,113 @@
+/*
+    Flexisip, a flexible SIP proxy server with media capabilities.
+    Copyright (C) 2010-2024 Belledonne Communications SARL, All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace flexisip {
+
+/**
+ * @class RendezvousHash
+ * @brief Weighted rendezvous (highest random weight) hashing over a set of nodes.
+ *
+ * Each key is assigned to the node that gets the highest score for it. Scores only depend on the key and on the node
+ * identifier, so adding or removing a node (or skipping it because it is unavailable) only moves the keys that were,
+ * or will be, assigned to this node. The share of keys assigned to a node is proportional to its weight.
+ *
+ * @tparam Node The type of the nodes.
+ */
+template <typename Node>
+class RendezvousHash {
+public:
+	/**
+	 * @param node the node to add.
+	 * @param id an identifier of the node, which must be stable across restarts (e.g. a hash of its address).
+	 * @param weight relative weight of the node, must be strictly positive.
+	 */
+	void add(Node node, std::uint64_t id, double weight = 1.0) {
+		mNodes.push_back({std::move(node), mix(id), weight});
+	}
+
+	/**
+	 * Pick the node with the highest score for the given key among the nodes that match the predicate.
+	 * @return nullptr if no node matches the predicate.
+	 */
+	template <typename Predicate>
+	const Node* pick(std::uint64_t key, Predicate&& isEligible) const {
+		const Node* best = nullptr;
+		auto bestScore = 0.0;
+		for (const auto& entry : mNodes) {
+			if (!isEligible(entry.node)) continue;
+			const auto score = computeScore(key, entry);
+			if (best == nullptr || score > bestScore) {
+				best = &entry.node;
+				bestScore = score;
+			}
+		}
+		return best;
+	}
+	const Node* pick(std::uint64_t key) const {
+		return pick(key, [](const Node&) { return true; });
+	}
+
+	void clear() noexcept {
+		mNodes.clear();
+	}
+
+	std::size_t size() const noexcept {
+		return mNodes.size();
+	}
+	bool empty() const noexcept {
+		return mNodes.empty();
+	}
+	auto begin() const noexcept {
+		return mNodes.cbegin();
+	}
+	auto end() const noexcept {
+		return mNodes.cend();
+	}
+
+	struct Entry {
+		Node node;
+		std::uint64_t id;
+		double weight;
+	};
+
+private:
+	// SplitMix64 finalizer: cheap and good enough to spread Call-ID hashes over the whole 64 bits range.
+	static std::uint64_t mix(std::uint64_t value) noexcept {
+		value += 0x9e3779b97f4a7c15ULL;
+		value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+		return value ^ (value >> 31);
+	}
+
+	// Logarithmic method: the score is -weight / ln(h) where h is uniformly distributed in ]0, 1[.
+	static double computeScore(std::uint64_t key, const Entry& entry) noexcept {
+		const auto hash = mix(key ^ entry.id);
+		const auto uniform = (static_cast<double>(hash >> 11) + 0.5) * 0x1.0p-53;
+		return -entry.weight / std::log(uniform);
+	}
+
+	std::vector<Entry> mNodes{};
+};
+
+} // namespace flexisip
@@ -101,6 +101,19 @@ Url Url::replaceUser(const std::string& newUser) const {
 	}
 }
 
+Url Url::replacePort(const std::string& newPort) const {
+	try {
+		if (empty()) throw UrlModificationError("empty Url");
+		url_t newUrl = *_url;
+		newUrl.url_port = newPort.empty() ? nullptr : newPort.c_str();
+		return Url(&newUrl);
+	} catch (const InvalidUrlError& e) {
+		ostringstream msg;
+		msg << "replacing port part of '" << str() << "' by '" << newPort << "'";
+		throw UrlModificationError(msg.str());
+	}
+}
+
 std::string Url::getParam(const string& paramName) const {
 	if (hasParam(paramName)) {
 		char tmp[256] = {0};
@@ -39,104 +39,49 @@ AutoThreadPool::AutoThreadPool(unsigned int maxThreadNumber, unsigned int maxQue
     : BaseThreadPool(maxQueueSize, maxThreadNumber) {
 	SLOGD << "AutoThreadPool [" << this << "]: init with " << maxThreadNumber << " threads and queue size "
 	      << maxQueueSize;
-
-	// Run the thread that will start every other thread
-	mainThread = make_unique<thread>(&AutoThreadPool::_run, this);
 }
 
 AutoThreadPool::~AutoThreadPool() {
 	if (mState != Stopped) stop();
 }
 
-void AutoThreadPool::stop() {
-	SLOGD << "AutoThreadPool [" << this << "]: shutdown";
-	// Scope based locking.
-	{
-		// Put unique lock on task mutex.
-		unique_lock<mutex> lock(mTasksMutex);
-
-		// Set termination flag to true.
-		mState = Shutdown;
+void AutoThreadPool::onAllWorkersBusy() {
+	lock_guard<mutex> lock(mIdleMutex);
+	if (mState != Running) return;
+	// A thread has become idle in the meantime, it will take the task.
+	if (mIdleWorkers > 0) {
+		mIdleCondition.notify_one();
+		return;
+	}
+	if (mCurrentThreadNumber >= mMaxThreadNumber) {
+		SLOGT << "AutoThreadPool::onAllWorkersBusy : max thread number is reached.";
+		return;
 	}
 
-	// Wake up main thread.
-	mCondition.notify_one();
-
-	// Join all threads.
-	mainThread->join();
-
-	// Indicate that the pool has been shut down.
-	mState = Stopped;
-}
-
-void AutoThreadPool::_run() {
-	Task task;
-	while (true) {
-		{ // Scope based locking.
-			// Put unique lock on task mutex.
-			unique_lock<mutex> lock(mTasksMutex);
-
-			// Wait until queue is not empty or termination signal is sent, respecting max thread count.
-			mCondition.wait(lock, [this]() {
-				if (mCurrentThreadNumber == mMaxThreadNumber) {
-					SLOGT << "AutoThreadPool::_run : notified but max thread number is reached.";
-				}
-				return (!mTasks.empty() && mCurrentThreadNumber < mMaxThreadNumber) ||
-				       (mCurrentThreadNumber < mMaxThreadNumber && mState == Shutdown);
-			});
-
-			// If termination signal received and queue is empty then exit else continue clearing the queue.
-			if (mTasks.empty() && mState == Shutdown) {
-				SLOGD << "AutoThreadPool [" << this << "]: terminate threads";
-				mCondition.wait(lock, [this]() { return mCurrentThreadNumber == 0; });
-				return;
-			}
-
-			// Get next task in the queue.
-			task = mTasks.front();
-
-			try {
-				// launch the task on a new thread
-				thread taskRunner{&AutoThreadPool::_subThreadRun, this, task};
-				taskRunner.detach();
-				mCurrentThreadNumber++;
-
-				// Remove task from the queue.
-				mTasks.pop();
-			} catch (const system_error& e) {
-				SLOGE << "AutoThreadPool[" << this << "] - error while creating a new thread (n°"
-				      << mCurrentThreadNumber << "), with error :\n"
-				      << e.what();
-				lock.unlock();
-
-				// Hard wait to allow task thread to run before new task thread creation
-				this_thread::sleep_for(1s);
-			}
-		} // End of scope based locking.
-
-		// Keep this to trigger task destructor out of locked scope
-		task = nullptr;
+	for (unsigned int slot = 0; slot < mWorkers.size(); slot++) {
+		auto& worker = *mWorkers[slot];
+		if (worker.active) continue;
+
+		try {
+			// The previous thread of this slot has exited on idle timeout.
+			if (worker.thread.joinable()) worker.thread.join();
+			worker.thread = thread{&AutoThreadPool::work, this, slot, kIdleTimeout};
+			worker.active = true;
+			mCurrentThreadNumber++;
+		} catch (const system_error& e) {
+			// The task stays queued until a thread of the pool is available.
+			SLOGE << "AutoThreadPool[" << this << "] - error while creating a new thread (n°" << mCurrentThreadNumber
+			      << "), with error :\n"
+			      << e.what();
+		}
+		return;
 	}
 }
 
-void AutoThreadPool::_subThreadRun(Task initialTask) {
-	initialTask();
-	while (true) {
-		Task moreTask;
-		{ // Scope based locking.
-			lock_guard<mutex> lock{mTasksMutex};
-			if (mTasks.empty()) {
-				break;
-			}
-			moreTask = mTasks.front();
-			mTasks.pop();
-		} // End of scope based locking.
-		moreTask();
-		// Keep this to trigger task destructor out of locked scope
-		moreTask = nullptr;
-	}
+bool AutoThreadPool::onIdleTimeout(unsigned int slot) {
+	mWorkers[slot]->active = false;
 	mCurrentThreadNumber--;
-	mCondition.notify_one();
+	return true;
 }
 
 } // namespace flexisip
@@ -19,12 +19,8 @@
 #pragma once
 
 #include <atomic>
-#include <condition_variable>
+#include <chrono>
 #include <memory>
-#include <mutex>
-#include <queue>
-#include <thread>
-#include <vector>
 
 #include "base-thread-pool.hh"
 
@@ -32,30 +28,27 @@ namespace flexisip {
 
 /**
  * Provide a pool of threads for executing custom tasks.
- * This implementation only create one main thread at start, this thread is in charge of creating new threads to handle
- * tasks.
+ * This implementation starts a new thread, up to maxThreadNumber, when a task is queued while every thread is busy.
+ * A thread terminates after being idle for kIdleTimeout, so that bursts of tasks do not create and destroy a thread
+ * for each of them.
  */
 class AutoThreadPool : public BaseThreadPool {
 public:
+	static constexpr std::chrono::seconds kIdleTimeout{10};
+
 	AutoThreadPool(unsigned int maxThreadNumber, unsigned int maxQueueSize);
 	~AutoThreadPool() override;
 
-	void stop() final;
-
 	static std::unique_ptr<AutoThreadPool>& getDbThreadPool(unsigned int maxThreadNumber);
 
-private:
-	/**
-	 * This method is called by the main thread.
-	 */
-	void _run();
+	unsigned int getThreadCount() const {
+		return mCurrentThreadNumber;
+	}
 
-	/**
-	 * This method is called by sub threads.
-	 */
-	void _subThreadRun(Task initialTask);
+private:
+	void onAllWorkersBusy() override;
+	bool onIdleTimeout(unsigned int slot) override;
 
-	std::unique_ptr<std::thread> mainThread{};
 	std::atomic_uint mCurrentThreadNumber{0};
 
 	static std::unique_ptr<AutoThreadPool> sDbThreadPool;
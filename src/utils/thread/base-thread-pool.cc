@@ -21,29 +21,201 @@
 #include "base-thread-pool.hh"
 
 using namespace std;
+using namespace std::chrono;
 
 namespace flexisip {
 
-bool BaseThreadPool::run(Task t) {
-	bool enqueued = false;
+namespace {
+
+// Worker slot of the pool the calling thread belongs to, if any.
+struct CurrentWorker {
+	const BaseThreadPool* pool = nullptr;
+	unsigned int slot = 0;
+};
+thread_local CurrentWorker sCurrentWorker{};
+
+void updateMax(atomic_int64_t& max, int64_t value) {
+	auto current = max.load(memory_order_relaxed);
+	while (current < value && !max.compare_exchange_weak(current, value, memory_order_relaxed)) {
+	}
+}
+
+} // namespace
+
+BaseThreadPool::BaseThreadPool(unsigned int maxQueueSize, unsigned int maxThreadNumber)
+    : mMaxQueueSize(maxQueueSize), mMaxThreadNumber(maxThreadNumber) {
+	// Keep at least one queue so that tasks can be accepted whatever the configuration.
+	const auto slotCount = max(maxThreadNumber, 1u);
+	mWorkers.reserve(slotCount);
+	for (unsigned int i = 0; i < slotCount; i++) {
+		mWorkers.emplace_back(make_unique<Worker>());
+	}
+}
+
+bool BaseThreadPool::run(Task t, Priority priority) {
+	if (mState != Running) {
+		mRejectedTasks.fetch_add(1, memory_order_relaxed);
+		return false;
+	}
+
+	// Reserve a place in the queue.
+	if (mMaxQueueSize == 0) {
+		mQueuedTasks++;
+	} else {
+		auto queuedTasks = mQueuedTasks.load();
+		do {
+			if (queuedTasks >= mMaxQueueSize) {
+				mRejectedTasks.fetch_add(1, memory_order_relaxed);
+				return false;
+			}
+		} while (!mQueuedTasks.compare_exchange_weak(queuedTasks, queuedTasks + 1));
+	}
+
+	// Tasks submitted by a running task stay on its worker, which is likely to be the next one to be available.
+	const auto lane = static_cast<size_t>(priority);
+	const auto slot = sCurrentWorker.pool == this ? sCurrentWorker.slot : mNextSlot++ % mWorkers.size();
+	auto& worker = *mWorkers[slot];
+	{
+		lock_guard<mutex> lock(worker.mutex);
+		worker.tasks[lane].push_back({std::move(t), steady_clock::now()});
+		worker.taskCounts[lane]++;
+		mAvailableTasks[lane]++;
+	}
+
+	// Wake up one thread if one is waiting for a task. The mutex is taken so that a thread which has just found no task
+	// cannot miss the notification.
+	if (mIdleWorkers > 0) {
+		lock_guard<mutex> lock(mIdleMutex);
+		mIdleCondition.notify_one();
+	} else {
+		onAllWorkersBusy();
+	}
+
+	return true;
+}
+
+void BaseThreadPool::stop() {
+	SLOGD << "ThreadPool [" << this << "]: shutdown";
 	// Scope based locking.
 	{
-		// Put unique lock on task mutex.
-		unique_lock<mutex> lock(mTasksMutex);
+		lock_guard<mutex> lock(mIdleMutex);
+		mState = Shutdown;
+	}
+
+	// Wake up all threads, they terminate once every queued task is done.
+	mIdleCondition.notify_all();
 
-		// Push task into queue.
-		if (mMaxQueueSize == 0 || mTasks.size() < mMaxQueueSize) {
-			mTasks.push(t);
-			enqueued = true;
+	// Join all threads.
+	for (auto& worker : mWorkers) {
+		if (worker->thread.joinable()) worker->thread.join();
+	}
+
+	// Indicate that the pool has been shut down.
+	mState = Stopped;
+
+	const auto stats = getStats();
+	if (stats.executedTasks != 0) {
+		SLOGD << "ThreadPool [" << this << "]: " << stats.executedTasks << " tasks executed (" << stats.stolenTasks
+		      << " stolen), " << stats.rejectedTasks << " rejected, queue time avg "
+		      << duration_cast<microseconds>(stats.totalQueueTime / stats.executedTasks).count() << "us max "
+		      << duration_cast<microseconds>(stats.maxQueueTime).count() << "us, run time avg "
+		      << duration_cast<microseconds>(stats.totalRunTime / stats.executedTasks).count() << "us max "
+		      << duration_cast<microseconds>(stats.maxRunTime).count() << "us";
+	}
+}
+
+BaseThreadPool::Stats BaseThreadPool::getStats() const {
+	Stats stats{};
+	stats.executedTasks = mExecutedTasks.load(memory_order_relaxed);
+	stats.rejectedTasks = mRejectedTasks.load(memory_order_relaxed);
+	stats.stolenTasks = mStolenTasks.load(memory_order_relaxed);
+	stats.totalQueueTime = nanoseconds{mTotalQueueTime.load(memory_order_relaxed)};
+	stats.maxQueueTime = nanoseconds{mMaxQueueTime.load(memory_order_relaxed)};
+	stats.totalRunTime = nanoseconds{mTotalRunTime.load(memory_order_relaxed)};
+	stats.maxRunTime = nanoseconds{mMaxRunTime.load(memory_order_relaxed)};
+	return stats;
+}
+
+unsigned int BaseThreadPool::getQueuedTaskCount() const {
+	return mQueuedTasks;
+}
+
+void BaseThreadPool::work(unsigned int slot, steady_clock::duration idleTimeout) {
+	sCurrentWorker = {this, slot};
+	QueuedTask task{};
+	auto stolen = false;
+	while (true) {
+		if (popTask(slot, task, stolen)) {
+			execute(task, stolen);
+			continue;
+		}
+
+		unique_lock<mutex> lock(mIdleMutex);
+		const auto wakeUp = [this]() { return hasAvailableTask() || mState != Running; };
+		auto notified = true;
+		mIdleWorkers++;
+		if (idleTimeout == steady_clock::duration::zero()) {
+			mIdleCondition.wait(lock, wakeUp);
+		} else {
+			notified = mIdleCondition.wait_for(lock, idleTimeout, wakeUp);
+		}
+		mIdleWorkers--;
+
+		// Queued tasks are executed even once the pool is shutting down.
+		if (hasAvailableTask()) continue;
+		if (mState != Running) break;
+		if (!notified && onIdleTimeout(slot)) break;
+	}
+	sCurrentWorker = {};
+	SLOGD << "ThreadPool [" << this << "]: terminate thread";
+}
+
+bool BaseThreadPool::popTask(unsigned int slot, QueuedTask& task, bool& stolen) {
+	const auto workerCount = mWorkers.size();
+	for (size_t lane = 0; lane < kPriorityCount; lane++) {
+		if (mAvailableTasks[lane] == 0) continue;
+		// Own queue first, then the ones of the other workers.
+		for (size_t i = 0; i < workerCount; i++) {
+			auto& worker = *mWorkers[(slot + i) % workerCount];
+			if (worker.taskCounts[lane] == 0) continue;
+
+			lock_guard<mutex> lock(worker.mutex);
+			auto& tasks = worker.tasks[lane];
+			if (tasks.empty()) continue;
+			task = std::move(tasks.front());
+			tasks.pop_front();
+			worker.taskCounts[lane]--;
+			mAvailableTasks[lane]--;
+			mQueuedTasks--;
+			stolen = i != 0;
+			return true;
 		}
 	}
+	return false;
+}
 
-	// Wake up one thread if the task was successfully queued
-	if (enqueued) {
-		mCondition.notify_one();
+bool BaseThreadPool::hasAvailableTask() const {
+	for (const auto& availableTasks : mAvailableTasks) {
+		if (availableTasks > 0) return true;
 	}
+	return false;
+}
+
+void BaseThreadPool::execute(QueuedTask& task, bool stolen) {
+	const auto start = steady_clock::now();
+	task.task();
+	const auto end = steady_clock::now();
+	// Keep this to trigger task destructor before waiting for the next one
+	task.task = nullptr;
 
-	return enqueued;
+	const auto queueTime = duration_cast<nanoseconds>(start - task.queuedAt).count();
+	const auto runTime = duration_cast<nanoseconds>(end - start).count();
+	mExecutedTasks.fetch_add(1, memory_order_relaxed);
+	if (stolen) mStolenTasks.fetch_add(1, memory_order_relaxed);
+	mTotalQueueTime.fetch_add(queueTime, memory_order_relaxed);
+	updateMax(mMaxQueueTime, queueTime);
+	mTotalRunTime.fetch_add(runTime, memory_order_relaxed);
+	updateMax(mMaxRunTime, runTime);
 }
 
 } // namespace flexisip
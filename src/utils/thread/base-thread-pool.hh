@@ -18,9 +18,14 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
 #include <vector>
 
@@ -29,25 +34,109 @@
 namespace flexisip {
 
 /**
- * This abstract class contains common method and attribute shared by AutoThreadPool and BasicThreadPool
+ * This abstract class contains common method and attribute shared by AutoThreadPool and BasicThreadPool.
+ *
+ * Each worker slot owns a queue of tasks, one lane per priority. Tasks submitted from outside the pool are spread over
+ * the slots in a round-robin fashion and tasks submitted by a task running in the pool go to the queue of its own
+ * worker. A worker takes the oldest task of the highest non-empty priority, from its own queue first then from the
+ * queues of the other workers (work stealing), so that submitters and workers do not all contend on a single lock.
  */
 class BaseThreadPool : public ThreadPool {
 public:
-	BaseThreadPool(unsigned int maxQueueSize, unsigned int maxThreadNumber)
-	    : mMaxQueueSize(maxQueueSize), mMaxThreadNumber(maxThreadNumber){};
+	/**
+	 * Execution statistics since the creation of the pool.
+	 * Queue time is the time spent by a task between its submission and the beginning of its execution.
+	 */
+	struct Stats {
+		std::uint64_t executedTasks;
+		std::uint64_t rejectedTasks;
+		std::uint64_t stolenTasks;
+		std::chrono::nanoseconds totalQueueTime;
+		std::chrono::nanoseconds maxQueueTime;
+		std::chrono::nanoseconds totalRunTime;
+		std::chrono::nanoseconds maxRunTime;
+	};
 
-	bool run(Task t) override;
+	BaseThreadPool(unsigned int maxQueueSize, unsigned int maxThreadNumber);
+
+	using ThreadPool::run;
+	bool run(Task t, Priority priority) override;
+	void stop() override;
+
+	Stats getStats() const;
+	/**
+	 * Number of tasks waiting for a thread.
+	 */
+	unsigned int getQueuedTaskCount() const;
 
 protected:
 	enum State { Running, Shutdown, Stopped };
 
-	std::vector<std::thread> mThreadPool{};
-	std::mutex mTasksMutex{};
-	std::queue<Task> mTasks{};
-	std::condition_variable mCondition{};
+	static constexpr std::size_t kPriorityCount = 3;
+
+	struct QueuedTask {
+		Task task;
+		std::chrono::steady_clock::time_point queuedAt;
+	};
+
+	struct Worker {
+		std::mutex mutex{};
+		std::array<std::deque<QueuedTask>, kPriorityCount> tasks{};
+		// Size of each lane, readable without locking the mutex.
+		std::array<std::atomic_size_t, kPriorityCount> taskCounts{};
+		std::thread thread{};
+		// Whether a thread is running for this slot, guarded by mIdleMutex.
+		bool active = false;
+	};
+
+	/**
+	 * Main loop of the thread of the given worker slot. Execute the tasks until the pool is shut down and every queued
+	 * task has been executed.
+	 * @param[in] slot the index of the worker in mWorkers.
+	 * @param[in] idleTimeout if not zero, onIdleTimeout() is called when no task was available for this duration.
+	 */
+	void work(unsigned int slot, std::chrono::steady_clock::duration idleTimeout);
+
+	/**
+	 * Called after a task has been queued while no thread was waiting for a task.
+	 */
+	virtual void onAllWorkersBusy() {
+	}
+	/**
+	 * Called, with mIdleMutex locked, when no task was available for the idle timeout given to work().
+	 * @return true if the thread of the slot must terminate.
+	 */
+	virtual bool onIdleTimeout([[maybe_unused]] unsigned int slot) {
+		return false;
+	}
+
+	std::vector<std::unique_ptr<Worker>> mWorkers{};
+	// Guards the transitions of mState and the idle state of the workers.
+	std::mutex mIdleMutex{};
+	std::condition_variable mIdleCondition{};
+	std::atomic_uint mIdleWorkers{0};
 	unsigned mMaxQueueSize = 0;
 	unsigned mMaxThreadNumber = 1;
-	State mState = Running;
+	std::atomic<State> mState{Running};
+
+private:
+	bool popTask(unsigned int slot, QueuedTask& task, bool& stolen);
+	bool hasAvailableTask() const;
+	void execute(QueuedTask& task, bool stolen);
+
+	// Tasks accepted by run() and not yet taken by a worker, used to enforce mMaxQueueSize.
+	std::atomic_uint mQueuedTasks{0};
+	// Tasks pushed in the queues of the workers, for each priority.
+	std::array<std::atomic_size_t, kPriorityCount> mAvailableTasks{};
+	std::atomic_uint mNextSlot{0};
+
+	std::atomic_uint64_t mExecutedTasks{0};
+	std::atomic_uint64_t mRejectedTasks{0};
+	std::atomic_uint64_t mStolenTasks{0};
+	std::atomic_int64_t mTotalQueueTime{0};
+	std::atomic_int64_t mMaxQueueTime{0};
+	std::atomic_int64_t mTotalRunTime{0};
+	std::atomic_int64_t mMaxRunTime{0};
 };
 
 } // namespace flexisip
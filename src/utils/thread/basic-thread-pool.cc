@@ -29,9 +29,10 @@ BasicThreadPool::BasicThreadPool(unsigned int maxThreadNumber, unsigned int maxQ
 	SLOGD << "BasicThreadPool [" << this << "]: init with " << maxThreadNumber << " threads and queue size "
 	      << maxQueueSize;
 
-	// Create number of required threads and add them to the thread pool vector.
+	// Create number of required threads, one per worker slot.
 	for (unsigned int i = 0; i < mMaxThreadNumber; i++) {
-		mThreadPool.emplace_back(&BasicThreadPool::_run, this);
+		mWorkers[i]->active = true;
+		mWorkers[i]->thread = thread{&BasicThreadPool::work, this, i, chrono::steady_clock::duration::zero()};
 	}
 }
 
@@ -39,59 +40,4 @@ BasicThreadPool::~BasicThreadPool() {
 	if (mState != Stopped) stop();
 }
 
-void BasicThreadPool::stop() {
-	SLOGD << "BasicThreadPool [" << this << "]: shutdown";
-	// Scope based locking.
-	{
-		// Put unique lock on task mutex.
-		unique_lock<mutex> lock(mTasksMutex);
-
-		// Set termination flag to true.
-		mState = Shutdown;
-	}
-
-	// Wake up all threads.
-	mCondition.notify_all();
-
-	// Join all threads.
-	for (auto& thread : mThreadPool) {
-		thread.join();
-	}
-
-	// Empty workers vector.
-	mThreadPool.clear();
-
-	// Indicate that the pool has been shut down.
-	mState = Stopped;
-}
-
-void BasicThreadPool::_run() {
-	Task task;
-	while (true) {
-		// Scope based locking.
-		{
-			// Put unique lock on task mutex.
-			unique_lock<mutex> lock(mTasksMutex);
-
-			// Wait until queue is not empty or termination signal is sent.
-			mCondition.wait(lock, [this]() { return !mTasks.empty() || mState == Shutdown; });
-			// If termination signal received and queue is empty then exit else continue clearing the queue.
-			if (mState == Shutdown && mTasks.empty()) {
-				SLOGD << "ThreadPool [" << this << "]: terminate thread";
-				return;
-			}
-
-			// Get next task in the queue.
-			task = mTasks.front();
-
-			// Remove it from the queue.
-			mTasks.pop();
-		}
-		// Execute the task.
-		task();
-		// Keep this to trigger task destructor out of locked scope
-		task = nullptr;
-	}
-}
-
 } // namespace flexisip
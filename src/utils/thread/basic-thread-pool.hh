@@ -18,12 +18,6 @@
 
 #pragma once
 
-#include <condition_variable>
-#include <mutex>
-#include <queue>
-#include <thread>
-#include <vector>
-
 #include "base-thread-pool.hh"
 
 namespace flexisip {
@@ -36,14 +30,6 @@ class BasicThreadPool : public BaseThreadPool {
 public:
 	BasicThreadPool(unsigned int maxThreadNumber, unsigned int maxQueueSize);
 	~BasicThreadPool() override;
-
-	void stop() final;
-
-private:
-	/**
-	 * This method is called by each thread.
-	 */
-	void _run();
 };
 
 } // namespace flexisip
@@ -19,6 +19,7 @@
 #pragma once
 
 #include <functional>
+#include <utility>
 
 namespace flexisip {
 
@@ -29,6 +30,11 @@ class ThreadPool {
 public:
 	using Task = std::function<void()>;
 
+	/**
+	 * Queued tasks of a higher priority are executed before queued tasks of a lower priority.
+	 */
+	enum class Priority { High, Normal, Low };
+
 	virtual ~ThreadPool() = default;
 
 	/**
@@ -38,7 +44,14 @@ public:
 	 * @param[in] t the task to run.
 	 * @return True on success or false when the queue is full.
 	 */
-	virtual bool run(Task t) = 0;
+	bool run(Task t) {
+		return run(std::move(t), Priority::Normal);
+	}
+
+	/**
+	 * Same as run(Task) but the task is queued with the given priority.
+	 */
+	virtual bool run(Task t, Priority priority) = 0;
 
 	/**
 	 * Stop all the threads.
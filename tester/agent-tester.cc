@@ -17,6 +17,8 @@
  */
 
 #include <memory>
+#include <sstream>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -32,6 +34,9 @@
 #include "sofia-wrapper/nta-agent.hh"
 #include "sofia-wrapper/sip-header-private.hh"
 #include "tester.hh"
+#include "utils/core-assert.hh"
+#include "utils/server/injected-module-info.hh"
+#include "utils/server/proxy-server.hh"
 #include "utils/string-utils.hh"
 #include "utils/test-patterns/agent-test.hh"
 #include "utils/test-patterns/test.hh"
@@ -451,6 +456,63 @@ const std::string ReplyToOptionRequestTest::kProxyURI =
     "sip:"s + kDomain + ":" + kProxyPort + ";maddr=127.0.0.1;transport=tcp";
 
 namespace {
+
+/*
+ * Modules only receive the requests whose method they declared to handle: other requests skip them, while the
+ * modules in charge of these requests still process them.
+ */
+void modulesOnlyReceiveHandledMethods() {
+	vector<string> receivedMethods{};
+	InjectedHooks hooks{
+	    .injectAfterModule = "GarbageIn",
+	    .onRequest =
+	        [&receivedMethods](shared_ptr<RequestSipEvent>& ev) {
+		        receivedMethods.emplace_back(ev->getMsgSip()->getSip()->sip_request->rq_method_name);
+	        },
+	    .requestMethods = {sip_method_register, sip_method_message},
+	    .responseMethods = {},
+	};
+	Server proxy{
+	    {
+	        {"global/transports", "sip:127.0.0.1:0;transport=tcp"},
+	        {"global/aliases", "localhost sip.example.org"},
+	        {"module::Registrar/enabled", "true"},
+	        {"module::Registrar/reg-domains", "sip.example.org"},
+	        {"module::Capabilities/enabled", "true"},
+	    },
+	    &hooks,
+	};
+	proxy.start();
+	const string proxyUri{"sip:127.0.0.1:"s + proxy.getFirstPort() + ";transport=tcp"};
+	NtaAgent client{proxy.getRoot(), "sip:127.0.0.1:0;transport=tcp"};
+	CoreAssert asserter{proxy};
+
+	const auto sendRequest = [&](const string& method, const string& requestUri, const string& extraHeaders = "") {
+		ostringstream request{};
+		request << method << " " << requestUri << " SIP/2.0\r\n"
+		        << "From: <sip:user@sip.example.org>;tag=stub-tag\r\n"
+		        << "To: <sip:user@sip.example.org>\r\n"
+		        << "CSeq: 20 " << method << "\r\n"
+		        << "Call-ID: stub-call-id-" << method << "\r\n"
+		        << extraHeaders << "Content-Length: 0\r\n\r\n";
+		const auto transaction = client.createOutgoingTransaction(make_unique<MsgSip>(0, request.str()), proxyUri);
+		asserter.wait([&transaction] { return transaction->isCompleted(); }).hard_assert_passed();
+		return transaction->getStatus();
+	};
+
+	// Capabilities still answers the OPTIONS request which skipped the injected module.
+	BC_ASSERT_CPP_EQUAL(sendRequest("OPTIONS", "sip:sip.example.org"), 200);
+	BC_ASSERT_CPP_EQUAL(receivedMethods.size(), 0);
+
+	BC_ASSERT_CPP_EQUAL(sendRequest("REGISTER", "sip:sip.example.org",
+	                         "Contact: <sip:user@127.0.0.1:1234;transport=tcp>\r\nExpires: 60\r\n"),
+	                    200);
+	sendRequest("MESSAGE", "sip:unknown@sip.example.org");
+	sendRequest("INFO", "sip:unknown@sip.example.org");
+
+	BC_ASSERT_CPP_EQUAL(StringUtils::join(receivedMethods, 0, ","), "REGISTER,MESSAGE");
+}
+
 using TCP = TcpConfig;
 using NewTLS = NewTlsConfig;
 using LegacyTLS = LegacyTlsConfig;
@@ -459,6 +521,7 @@ using InternalTransport = InternalTransportConfig;
 TestSuite _{"Agent unit tests",
             {
                 CLASSY_TEST(CSeqIsCheckedOnRegisterWithoutInstanceId),
+                CLASSY_TEST(modulesOnlyReceiveHandledMethods),
 #if !__APPLE__
                 TEST_NO_TAG("Transports loading from conf and isUs method testing", run<TransportsAndIsUsTest>),
 #endif
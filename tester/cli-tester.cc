@@ -16,12 +16,16 @@
     along with this program. If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
 #include <cerrno>
 #include <chrono>
 #include <future>
 #include <memory>
+#include <set>
+#include <sstream>
 #include <string>
 
+#include <poll.h>
 #include <sysexits.h>
 
 #include <json/json.h>
@@ -33,6 +37,7 @@
 
 #include "flexisip-tester-config.hh"
 #include "utils/asserts.hh"
+#include "utils/contact-inserter.hh"
 #include "utils/server/proxy-server.hh"
 #include "utils/successful-bind-listener.hh"
 #include "utils/test-patterns/registrardb-test.hh"
@@ -332,6 +337,41 @@ void flexisip_cli_dot_py() {
 		BC_ASSERT_STRING_EQUAL(returned_contact["unique-id"].asCString(), "embedded");
 	}
 
+	{ // Dump the whole registrar database, one JSON object per line
+		std::istringstream lines{callScript("REGISTRAR_DUMP all", EX_OK)};
+		std::set<std::string> aors{};
+		for (std::string line; std::getline(lines, line);) {
+			if (!line.empty()) aors.insert(deserialize(line)["aor"].asString());
+		}
+		BC_ASSERT_CPP_EQUAL(aors.count("test@sip.example.org"), 1);
+		BC_ASSERT_CPP_EQUAL(aors.count("test3@sip.example.org"), 1);
+		BC_ASSERT_CPP_EQUAL(aors.count("test2@sip.example.org"), 0);
+	}
+
+	{ // Dump the AoRs registered on this instance, the default scope
+		ContactInserter inserter{proxyServer.getAgent()->getRegistrarDb(), std::make_shared<AcceptUpdatesListener>()};
+		// Contacts registered through this instance have a path pointing to it.
+		inserter.setAor("sip:local@sip.example.org")
+		    .setPath({"sip:127.0.0.1:"s + proxyServer.getFirstPort()})
+		    .setExpire(1min)
+		    .insert({.contact = "sip:local@127.0.0.1:5460"});
+		BC_HARD_ASSERT_TRUE(asserter.iterateUpTo(7, [&inserter] { return inserter.finished(); }));
+
+		std::istringstream lines{callScript("REGISTRAR_DUMP", EX_OK)};
+		std::set<std::string> aors{};
+		for (std::string line; std::getline(lines, line);) {
+			if (!line.empty()) aors.insert(deserialize(line)["aor"].asString());
+		}
+		BC_ASSERT_CPP_EQUAL(aors.size(), 1);
+		BC_ASSERT_CPP_EQUAL(aors.count("local@sip.example.org"), 1);
+		BC_ASSERT_CPP_EQUAL(callScript("REGISTRAR_DUMP local", EX_OK), callScript("REGISTRAR_DUMP", EX_OK));
+	}
+
+	{ // REGISTRAR_DUMP invalid scope
+		const auto result = callSocket("REGISTRAR_DUMP everything");
+		BC_ASSERT_TRUE(StringUtils::startsWith(result, "Error: REGISTRAR_DUMP expects 'local'"));
+	}
+
 	{ // Get Unknown Record (CLI)
 		const auto result = callScript("REGISTRAR_GET sip:unknown@sip.example.org", EX_USAGE);
 		BC_ASSERT_STRING_EQUAL(result.c_str(),
@@ -440,6 +480,67 @@ void flexisip_cli_dot_py() {
 	}
 }
 
+/*
+ * REGISTRAR_DUMP only produces the next page once the client read the previous one, and gives up on clients that stop
+ * reading instead of buffering the whole registrar for them.
+ */
+void registrarDumpPacedByReader() {
+	Server proxyServer{{{"module::Registrar/db-implementation", "internal"}}};
+	ProxyCommandLineInterface cli(proxyServer.getConfigManager(), proxyServer.getAgent());
+	const auto cliReady = cli.start();
+	BcAssert asserter{[&root = *proxyServer.getRoot()] { root.step(1ms); }};
+	BC_HARD_ASSERT_TRUE(cliReady.wait_for(1s) == std::future_status::ready);
+
+	// Enough AoRs for the dump to be much larger than the socket buffers.
+	constexpr auto aorCount = 5000;
+	const auto padding = std::string(300, 'x');
+	ContactInserter inserter{proxyServer.getAgent()->getRegistrarDb(), std::make_shared<AcceptUpdatesListener>()};
+	inserter.setExpire(1min);
+	for (auto i = 0; i < aorCount; ++i) {
+		inserter.setAor("sip:user-" + std::to_string(i) + "-" + padding + "@sip.example.org").insert();
+	}
+	BC_HARD_ASSERT_TRUE(asserter.iterateUpTo(7, [&inserter] { return inserter.finished(); }));
+
+	sockaddr_un address{};
+	address.sun_family = AF_UNIX;
+	strcpy(address.sun_path, ("/tmp/flexisip-proxy-"s + std::to_string(getpid())).c_str());
+	const auto countDumpedAors = [](SocketClientHandle& handle) {
+		auto count = 0;
+		for (auto chunk = handle.recv(0xFFFF); !chunk.empty(); chunk = handle.recv(0xFFFF)) {
+			count += std::count(chunk.begin(), chunk.end(), '\n');
+		}
+		return count;
+	};
+
+	{ // A client reading continuously gets the whole dump
+		std::future<int> fut{};
+		SocketClientHandle handle{};
+		fut = std::async(std::launch::async, [&handle, &address, &countDumpedAors] {
+			BC_HARD_ASSERT_TRUE(handle.connect(address) == 0);
+			BC_HARD_ASSERT_TRUE(0 < handle.send("REGISTRAR_DUMP all"));
+			return countDumpedAors(handle);
+		});
+
+		BC_HARD_ASSERT_TRUE(
+		    asserter.waitUntil(10s, [&fut] { return fut.wait_for(0s) == std::future_status::ready; }));
+		BC_ASSERT_CPP_EQUAL(fut.get(), aorCount);
+	}
+
+	{ // A client that stops reading is dropped
+		SocketClientHandle handle{};
+		BC_HARD_ASSERT_TRUE(handle.connect(address) == 0);
+		BC_HARD_ASSERT_TRUE(0 < handle.send("REGISTRAR_DUMP all"));
+
+		BC_HARD_ASSERT_TRUE(asserter.waitUntil(5s, [&handle] {
+			pollfd pfd{.fd = handle.getHandle(), .events = POLLIN, .revents = 0};
+			return poll(&pfd, 1, 0) == 1 && (pfd.revents & POLLHUP);
+		}));
+		const auto dumped = countDumpedAors(handle);
+		BC_ASSERT(0 < dumped);
+		BC_ASSERT(dumped < aorCount);
+	}
+}
+
 namespace {
 using namespace DbImplementation;
 TestSuite _("CLI",
@@ -447,6 +548,7 @@ TestSuite _("CLI",
                 CLASSY_TEST(handler_registration_and_dispatch),
                 CLASSY_TEST(flexisip_cli_dot_py<Internal>),
                 CLASSY_TEST(flexisip_cli_dot_py<Redis>),
+                CLASSY_TEST(registrarDumpPacedByReader),
             });
 } // namespace
 } // namespace cli_tests
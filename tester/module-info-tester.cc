@@ -117,11 +117,34 @@ static void moduleReplacement() noexcept {
 	}
 }
 
+/**
+ * Check the set of methods modules use to declare which requests and responses they act on.
+ */
+static void sipMethodSet() noexcept {
+	const SipMethodSet registerOnly{sip_method_register};
+	BC_ASSERT_TRUE(registerOnly.contains(sip_method_register));
+	BC_ASSERT_FALSE(registerOnly.contains(sip_method_invite));
+	BC_ASSERT_FALSE(registerOnly.contains(sip_method_unknown));
+	BC_ASSERT_FALSE(registerOnly.empty());
+
+	// Extension methods are all mapped to sip_method_unknown.
+	const SipMethodSet unknown{sip_method_unknown};
+	BC_ASSERT_TRUE(unknown.contains(sip_method_unknown));
+	BC_ASSERT_TRUE(unknown.contains(sip_method_invalid));
+	BC_ASSERT_FALSE(unknown.contains(sip_method_ack));
+
+	BC_ASSERT_TRUE(SipMethodSet{}.empty());
+	for (int method = sip_method_unknown; method <= sip_method_publish; ++method) {
+		BC_ASSERT_TRUE(SipMethodSet::all().contains(static_cast<sip_method_t>(method)));
+	}
+}
+
 namespace {
 TestSuite _("ModuleInfo",
             {
                 TEST_NO_TAG("Module sorting", moduleSorting),
                 TEST_NO_TAG("Module replacement", moduleReplacement),
+                TEST_NO_TAG("SIP method set", sipMethodSet),
             });
 }
 } // namespace tester
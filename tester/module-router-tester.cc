@@ -16,8 +16,10 @@
     along with this program. If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
+#include <optional>
 #include <string>
 #include <unistd.h>
 
@@ -25,11 +27,14 @@
 
 #include "flexisip/logmanager.hh"
 #include "flexisip/module-router.hh"
+#include "registrar/registrar-db.hh"
+#include "registrardb-redis.hh"
 #include "sofia-wrapper/nta-agent.hh"
 
 #include "utils/asserts.hh"
 #include "utils/bellesip-utils.hh"
 #include "utils/server/proxy-server.hh"
+#include "utils/server/redis-server.hh"
 #include "utils/string-utils.hh"
 #include "utils/test-patterns/registrardb-test.hh"
 #include "utils/test-patterns/test.hh"
@@ -426,7 +431,8 @@ struct RoutingWithStaticTargets {
 	          .injectAfterModule = {"Router"},
 	          .onRequest =
 	              [this](const shared_ptr<RequestSipEvent>& ev) {
-		              if (ev->getMsgSip()->getSipMethod() != sip_method_invite) return;
+		              const auto method = ev->getMsgSip()->getSipMethod();
+		              if (method != sip_method_invite && method != sip_method_message) return;
 		              mActualTargets.emplace_back(url_as_string(ev->getHome(), ev->getSip()->sip_request->rq_url));
 	              },
 	      }),
@@ -538,6 +544,98 @@ void requestIsRoutedToXTargetUrisAndStaticTargets() {
 	}
 }
 
+/*
+ * Test that a MESSAGE sent to a large list of recipients through the "X-Target-Uris" header is routed to the devices of
+ * all of them, including the ones reached through an alias.
+ */
+void messageIsRoutedToManyXTargetUris() {
+	vector<Contact> recipients{};
+	for (auto i = 0; i < 50; ++i) {
+		const auto user = "recipient-"s + to_string(i);
+		recipients.push_back({"sip:" + user + "@localhost", "sip:" + user + "@127.0.0.1:0"});
+	}
+	const auto aliasTarget = Contact{"sip:alias-target@localhost", "sip:alias-target@127.0.0.1:0"};
+	RoutingWithStaticTargets helper{recipients, {}};
+	ContactInserter inserter(helper.mProxy.getAgent()->getRegistrarDb());
+	inserter.setAor("sip:alias@localhost").setAlias(true).setExpire(1min).insert({aliasTarget.aor});
+	inserter.setAor(aliasTarget.aor).setAlias(false).setExpire(1min).insert({aliasTarget.uri});
+	BC_HARD_ASSERT_TRUE(helper.mAsserter.iterateUpTo(
+	    5, [&inserter] { return inserter.finished(); }, 2s));
+
+	vector<string> expectedTargets{aliasTarget.uri};
+	ostringstream targetUris{};
+	targetUris << "<sip:alias@localhost>";
+	for (const auto& recipient : recipients) {
+		expectedTargets.push_back(recipient.uri);
+		targetUris << ",<" << recipient.aor << ">";
+	}
+
+	ostringstream request;
+	request << "MESSAGE sip:chatroom@localhost SIP/2.0\r\n"
+	        << "Via: SIP/2.0/TCP 127.0.0.1\r\n"
+	        << "From: <" << helper.mCaller.aor << ">;tag=stub-tag\r\n"
+	        << "To: <sip:chatroom@localhost>\r\n"
+	        << "X-Target-Uris: " << targetUris.str() << "\r\n"
+	        << "Call-ID: stub-id\r\n"
+	        << "CSeq: 20 MESSAGE\r\n"
+	        << "Content-Type: text/plain\r\n";
+
+	const auto routeUri = "sip:127.0.0.1:"s + helper.mProxy.getFirstPort();
+	const auto transaction = helper.mClient.createOutgoingTransaction(request.str(), routeUri);
+	BC_ASSERT(helper.mAsserter.iterateUpTo(
+	              5, [&helper, count = expectedTargets.size()]() { return helper.mActualTargets.size() >= count; },
+	              2s) == true);
+
+	sort(expectedTargets.begin(), expectedTargets.end());
+	sort(helper.mActualTargets.begin(), helper.mActualTargets.end());
+	BC_ASSERT_TRUE(helper.mActualTargets == expectedTargets);
+}
+
+/*
+ * Test that a MESSAGE sent to a list of recipients through the "X-Target-Uris" header is answered with an error when
+ * the registrar database cannot be reached, instead of being routed as if none of them was registered.
+ */
+void xTargetUrisFetchErrorIsReported() {
+	optional<RedisServer> redis{std::in_place};
+	Server proxy{{
+	    {"global/aliases", "localhost"},
+	    {"global/transports", "sip:127.0.0.1:0"},
+	    {"module::NatHelper/enabled", "false"},
+	    {"module::DoSProtection/enabled", "false"},
+	    {"module::Registrar/reg-domains", "localhost"},
+	    {"module::Registrar/db-implementation", "redis"},
+	    {"module::Registrar/redis-server-domain", "localhost"},
+	    {"module::Registrar/redis-server-port", to_string(redis->port())},
+	}};
+	proxy.start();
+	NtaAgent client{proxy.getRoot(), "sip:127.0.0.1:0"};
+	BcAssert asserter{};
+	asserter.addCustomIterate([&root = *proxy.getRoot()] { root.step(1ms); });
+	const auto* backend =
+	    dynamic_cast<const RegistrarDbRedisAsync*>(&proxy.getAgent()->getRegistrarDb().getRegistrarBackend());
+	BC_HARD_ASSERT(backend != nullptr);
+	BC_HARD_ASSERT(asserter.iterateUpTo(10, [&backend] { return backend->isConnected(); }, 1s));
+
+	// Make Redis unreachable.
+	redis.reset();
+	BC_HARD_ASSERT(asserter.iterateUpTo(10, [&backend] { return !backend->isConnected(); }, 1s));
+
+	ostringstream request;
+	request << "MESSAGE sip:chatroom@localhost SIP/2.0\r\n"
+	        << "Via: SIP/2.0/TCP 127.0.0.1\r\n"
+	        << "From: <sip:caller@localhost>;tag=stub-tag\r\n"
+	        << "To: <sip:chatroom@localhost>\r\n"
+	        << "X-Target-Uris: <sip:recipient-1@localhost>,<sip:recipient-2@localhost>\r\n"
+	        << "Call-ID: stub-id\r\n"
+	        << "CSeq: 20 MESSAGE\r\n"
+	        << "Content-Type: text/plain\r\n";
+	const auto transaction =
+	    client.createOutgoingTransaction(request.str(), "sip:127.0.0.1:"s + proxy.getFirstPort());
+	BC_ASSERT(asserter.iterateUpTo(
+	              5, [&transaction]() { return transaction->isCompleted(); }, 2s) == true);
+	BC_ASSERT_CPP_EQUAL(transaction->getStatus(), 500);
+}
+
 } // namespace
 
 namespace {
@@ -552,6 +650,8 @@ TestSuite
           TEST_NO_TAG("Check that module router don't remove route to others", run<OtherRouteHeaderNotRemovedTest>),
           CLASSY_TEST(requestIsAlsoRoutedToStaticTargets),
           CLASSY_TEST(requestIsRoutedToXTargetUrisAndStaticTargets),
+          CLASSY_TEST(messageIsRoutedToManyXTargetUris),
+          CLASSY_TEST(xTargetUrisFetchErrorIsReported),
       });
 } // namespace
 } // namespace tester
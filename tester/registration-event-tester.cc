@@ -23,7 +23,9 @@
 #include <bctoolbox/logging.h>
 
 #include <memory>
+#include <sstream>
 #include <string>
+#include <vector>
 
 #include "flexisip/utils/sip-uri.hh"
 #include "linphone/misc.h"
@@ -45,6 +47,7 @@
 #include "utils/server/test-conference-server.hh"
 #include "utils/test-patterns/test.hh"
 #include "utils/test-suite.hh"
+#include "xml/reginfo.hh"
 
 using namespace std;
 using namespace linphone;
@@ -64,6 +67,7 @@ public:
 	}
 };
 
+template <bool partialNotifications>
 void basicSubscription() {
 	// Agent initialisation
 	const string confFactoryUri = "sip:conference-factory@sip.example.org";
@@ -92,7 +96,8 @@ void basicSubscription() {
 		transports->setTcpPort(LC_SIP_TRANSPORT_RANDOM);
 		regEventCore->setTransports(transports);
 	}
-	regEventCore->addListener(make_shared<flexisip::RegistrationEvent::Server::Subscriptions>(proxy.getRegistrarDb()));
+	regEventCore->addListener(make_shared<flexisip::RegistrationEvent::Server::Subscriptions>(proxy.getRegistrarDb(),
+	                                                                                        partialNotifications));
 	regEventCore->start();
 	auto* configRoot = proxy.getConfigManager()->getRoot();
 	configRoot->get<GenericStruct>("module::RegEvent")
@@ -215,9 +220,172 @@ void basicSubscription() {
 }
 
 namespace {
+
+/*
+ * Watcher of a registration, keeping the reginfo documents it is notified with.
+ */
+class ReginfoCollector : public CoreListener {
+public:
+	void onNotifyReceived(const shared_ptr<Core>&,
+	                      const shared_ptr<linphone::Event>&,
+	                      const string&,
+	                      const shared_ptr<const Content>& body) override {
+		istringstream data{body->getUtf8Text()};
+		mNotified.push_back(reginfo::parseReginfo(data, Xsd::XmlSchema::Flags::dont_validate));
+	}
+
+	vector<unique_ptr<reginfo::Reginfo>> mNotified{};
+};
+
+/*
+ * A RegEvent server with partial notifications enabled and one subscription to sip:participant@127.0.0.1. The
+ * subscriber is notified of the full state, with one registered device, before the test starts.
+ */
+class PartialNotificationsTest : public Test {
+public:
+	void operator()() override {
+		mProxy.start();
+		mInserter.withGruu(true).setExpire(1000s).setAor(kAor).insert({.uniqueId = "first-device"});
+
+		const auto regEventPort = to_string(mRegEventCore->getTransportsUsed()->getTcpPort());
+		const auto subscription = mWatcherCore->createSubscribe(
+		    Factory::get()->createAddress("sip:participant@127.0.0.1:" + regEventPort + ";transport=tcp"), "reg", 600);
+		subscription->addCustomHeader("Accept", "application/reginfo+xml");
+		subscription->sendSubscribe(nullptr);
+
+		const auto& notified = mCollector->mNotified;
+		mAsserter.wait([&notified] { return !notified.empty(); }).hard_assert_passed();
+		BC_HARD_ASSERT_CPP_EQUAL(notified.size(), 1);
+		const auto& fullState = *notified.front();
+		BC_ASSERT(fullState.getState() == reginfo::State::Value::full);
+		BC_HARD_ASSERT_CPP_EQUAL(fullState.getRegistration().size(), 1);
+		const auto& contacts = fullState.getRegistration().front().getContact();
+		BC_HARD_ASSERT_CPP_EQUAL(contacts.size(), 1);
+		BC_ASSERT(isDevice(contacts.front(), "first-device"));
+		BC_ASSERT(contacts.front().getEvent() == reginfo::Event::registered);
+
+		testExec();
+
+		subscription->terminate();
+	}
+
+protected:
+	static constexpr auto kAor = "sip:participant@127.0.0.1";
+
+	virtual void testExec() = 0;
+
+	static bool isDevice(const reginfo::Contact& contact, const string& uniqueId) {
+		return string{contact.getUri()}.find("gr=" + uniqueId) != string::npos;
+	}
+
+	// Publish a change of the registration and wait for the resulting partial state.
+	const reginfo::Reginfo& publishAndWaitPartialState(const string& uidOfFreshlyRegistered) {
+		const auto& notified = mCollector->mNotified;
+		const auto notifiedCount = notified.size();
+		mProxy.getRegistrarDb()->publish(Record::Key{SipUri(kAor), false}, uidOfFreshlyRegistered);
+		mAsserter.wait([&notified, notifiedCount] { return notified.size() > notifiedCount; }).hard_assert_passed();
+		BC_HARD_ASSERT_CPP_EQUAL(notified.size(), notifiedCount + 1);
+
+		const auto& partialState = *notified.back();
+		BC_ASSERT(partialState.getState() == reginfo::State::Value::partial);
+		BC_ASSERT_CPP_EQUAL(partialState.getVersion(), notified[notifiedCount - 1]->getVersion() + 1);
+		BC_HARD_ASSERT_CPP_EQUAL(partialState.getRegistration().size(), 1);
+		return partialState;
+	}
+
+	Server mProxy{{
+	    {"global/transports", "sip:127.0.0.1:0;transport=tcp"},
+	    {"module::Registrar/reg-domains", "127.0.0.1"},
+	    {"module::Registrar/enable-gruu", "true"},
+	}};
+	shared_ptr<Core> mRegEventCore = makeCore(make_shared<RegistrationEvent::Server::Subscriptions>(
+	    mProxy.getRegistrarDb(), true));
+	shared_ptr<ReginfoCollector> mCollector = make_shared<ReginfoCollector>();
+	shared_ptr<Core> mWatcherCore = makeCore(mCollector);
+	ContactInserter mInserter{*mProxy.getRegistrarDb(), make_shared<AcceptUpdatesListener>()};
+	CoreAssert<> mAsserter{mRegEventCore, mWatcherCore, mProxy};
+
+private:
+	static shared_ptr<Core> makeCore(const shared_ptr<CoreListener>& listener) {
+		const auto core = tester::minimalCore(*Factory::get());
+		const auto& transports = core->getTransports();
+		transports->setTcpPort(LC_SIP_TRANSPORT_RANDOM);
+		core->setTransports(transports);
+		core->addListener(listener);
+		core->start();
+		return core;
+	}
+};
+
+/*
+ * Once the full state has been notified, a new device is notified alone, as freshly registered (refreshed).
+ */
+class PartialStateOfNewDevice : public PartialNotificationsTest {
+	void testExec() override {
+		mInserter.insert({.uniqueId = "second-device"});
+
+		const auto& partialState = publishAndWaitPartialState(R"("<second-device>")");
+
+		const auto& contacts = partialState.getRegistration().front().getContact();
+		BC_HARD_ASSERT_CPP_EQUAL(contacts.size(), 1);
+		BC_ASSERT(isDevice(contacts.front(), "second-device"));
+		BC_ASSERT(contacts.front().getState() == reginfo::Contact::StateType::active);
+		BC_ASSERT(contacts.front().getEvent() == reginfo::Event::refreshed);
+	}
+};
+
+/*
+ * Partial states map the events of the contacts the same way as full states: only the freshly registered device is
+ * flagged as refreshed, even when it was already notified, the other changed devices are flagged as registered.
+ */
+class PartialStateOfFreshlyRegistered : public PartialNotificationsTest {
+	void testExec() override {
+		mInserter.insert({.uniqueId = "second-device"});
+		const auto& addedState = publishAndWaitPartialState("");
+		const auto& added = addedState.getRegistration().front().getContact();
+		BC_HARD_ASSERT_CPP_EQUAL(added.size(), 1);
+		BC_ASSERT(isDevice(added.front(), "second-device"));
+		BC_ASSERT(added.front().getEvent() == reginfo::Event::registered);
+
+		// An already notified device registers again.
+		mInserter.insert({.uniqueId = "first-device"});
+		const auto& refreshedState = publishAndWaitPartialState(R"("<first-device>")");
+		const auto& refreshed = refreshedState.getRegistration().front().getContact();
+		BC_HARD_ASSERT_CPP_EQUAL(refreshed.size(), 1);
+		BC_ASSERT(isDevice(refreshed.front(), "first-device"));
+		BC_ASSERT(refreshed.front().getState() == reginfo::Contact::StateType::active);
+		BC_ASSERT(refreshed.front().getEvent() == reginfo::Event::refreshed);
+	}
+};
+
+/*
+ * A removed device is notified alone, as terminated.
+ */
+class PartialStateOfRemovedDevice : public PartialNotificationsTest {
+	void testExec() override {
+		mInserter.insert({.uniqueId = "second-device"});
+		publishAndWaitPartialState("");
+
+		mInserter.setExpire(0s).insert({.uniqueId = "second-device"});
+		const auto& partialState = publishAndWaitPartialState("");
+
+		const auto& registration = partialState.getRegistration().front();
+		BC_ASSERT(registration.getState() == reginfo::Registration::StateType::active);
+		const auto& contacts = registration.getContact();
+		BC_HARD_ASSERT_CPP_EQUAL(contacts.size(), 1);
+		BC_ASSERT(isDevice(contacts.front(), "second-device"));
+		BC_ASSERT(contacts.front().getState() == reginfo::Contact::StateType::terminated);
+		BC_ASSERT(contacts.front().getEvent() == reginfo::Event::unregistered);
+	}
+};
+
 TestSuite _("Registration Event",
             {
-                CLASSY_TEST(basicSubscription),
+                CLASSY_TEST(basicSubscription<false>),
+                CLASSY_TEST(basicSubscription<true>),
+                CLASSY_TEST(PartialStateOfNewDevice),
+                CLASSY_TEST(PartialStateOfFreshlyRegistered),
+                CLASSY_TEST(PartialStateOfRemovedDevice),
             });
 }
 } // namespace tester
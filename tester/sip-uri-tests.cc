@@ -208,10 +208,39 @@ void url__rfc3261Compare() {
 	}
 }
 
+void url__replacePort() {
+	{ // No port yet
+		const auto url = Url("sip:127.0.0.1;transport=tcp").replacePort("5061");
+		BC_ASSERT_CPP_EQUAL(url.str(), "sip:127.0.0.1:5061;transport=tcp");
+		BC_ASSERT_CPP_EQUAL(url.getPort(), "5061");
+	}
+
+	{ // IPv6 host: the port goes after the brackets
+		const auto url = Url("sip:[2001:db8::1]:5060;transport=tcp").replacePort("5062");
+		BC_ASSERT_CPP_EQUAL(url.str(), "sip:[2001:db8::1]:5062;transport=tcp");
+		BC_ASSERT_CPP_EQUAL(url.getHost(), "[2001:db8::1]");
+	}
+
+	{ // URL parameters and headers are kept as they are
+		const auto url = Url("sips:user@sip.example.org:5061;transport=tcp;maddr=192.0.2.1?Subject=test")
+		                     .replacePort("5063");
+		BC_ASSERT_CPP_EQUAL(url.str(), "sips:user@sip.example.org:5063;transport=tcp;maddr=192.0.2.1?Subject=test");
+		BC_ASSERT_CPP_EQUAL(url.getParam("maddr"), "192.0.2.1");
+	}
+
+	{ // An empty port removes it
+		const auto url = Url("sip:sip.example.org:5060;transport=udp").replacePort("");
+		BC_ASSERT_CPP_EQUAL(url.str(), "sip:sip.example.org;transport=udp");
+	}
+
+	BC_ASSERT_THROWN(Url().replacePort("5060"), UrlModificationError);
+}
+
 namespace {
 TestSuite _("sip-uri-tests",
             {
                 CLASSY_TEST(url__rfc3261Compare),
+                CLASSY_TEST(url__replacePort),
             });
 }
 } // namespace tester
@@ -107,12 +107,7 @@ static const char none[] = R"SQL(
 	UNION SELECT "domain-stand-in", "authid-stand-in";
 )SQL";
 
-template <typename Backend, const char request[]>
-void customPasswordRequestParamInjection() {
-	Backend backend{};
-	const auto injectedPassword = tester::randomString(0x10);
-	std::string empty{};
-	RootConfigStruct configRoot{"flexisip-tester", "Fake configuration for testing purposes", {}, empty};
+void declareConfig(RootConfigStruct& configRoot) {
 	for (const auto& init : ConfigManager::defaultInit()) {
 		init(configRoot);
 	}
@@ -124,6 +119,15 @@ void customPasswordRequestParamInjection() {
 			moduleInfo->declareConfig(configRoot);
 		}
 	}
+}
+
+template <typename Backend, const char request[]>
+void customPasswordRequestParamInjection() {
+	Backend backend{};
+	const auto injectedPassword = tester::randomString(0x10);
+	std::string empty{};
+	RootConfigStruct configRoot{"flexisip-tester", "Fake configuration for testing purposes", {}, empty};
+	declareConfig(configRoot);
 	const auto& authModuleConfig = *configRoot.get<GenericStruct>("module::Authentication");
 	authModuleConfig.get<ConfigInt>("soci-poolsize")->set("1");
 	authModuleConfig.get<ConfigString>("soci-password-request")->set(request);
@@ -154,6 +158,105 @@ void customPasswordRequestParamInjection() {
 	}
 }
 
+/*
+ * Concurrent lookups of the same credentials share a single query, and lookups waiting for a connection are fetched
+ * with 'soci-password-batch-request'. Whichever path each lookup takes, every listener must get the passwords of its
+ * own user.
+ */
+void concurrentPasswordLookups() {
+	SqliteBackend backend{};
+	std::string empty{};
+	RootConfigStruct configRoot{"flexisip-tester", "Fake configuration for testing purposes", {}, empty};
+	declareConfig(configRoot);
+	const auto& authModuleConfig = *configRoot.get<GenericStruct>("module::Authentication");
+	authModuleConfig.get<ConfigInt>("soci-poolsize")->set("1");
+	authModuleConfig.get<ConfigString>("soci-password-request")
+	    ->set("SELECT 'password-of-' || :id, 'SHA-DDOCK' WHERE :id IN ('user-a', 'user-b')");
+	authModuleConfig.get<ConfigString>("soci-password-batch-request")
+	    ->set("SELECT 'password-of-' || id, 'SHA-DDOCK', id FROM (SELECT 'user-a' AS id UNION SELECT 'user-b') "
+	          "WHERE id IN (:ids)");
+	backend.setConfig(authModuleConfig);
+	SociAuthDB authDb{configRoot};
+
+	const std::vector<std::string> users{"user-a", "user-b", "user-a", "unknown-user", "user-b"};
+	std::vector<PasswordRequestListener> listeners(users.size());
+	for (std::size_t i = 0; i < users.size(); ++i) {
+		authDb.getPasswordFromBackend(users[i], "domain-stand-in", users[i], &listeners[i]);
+	}
+
+	for (std::size_t i = 0; i < users.size(); ++i) {
+		auto future = listeners[i].getFuture();
+		BC_HARD_ASSERT_TRUE(future.wait_for(1s) == std::future_status::ready);
+		const auto [result, passwords] = future.get();
+		if (users[i] == "unknown-user") {
+			BC_ASSERT_CPP_EQUAL(result, AuthDbResult::PASSWORD_NOT_FOUND);
+			continue;
+		}
+		BC_ASSERT_CPP_EQUAL(result, AuthDbResult::PASSWORD_FOUND);
+		BC_HARD_ASSERT_CPP_EQUAL(passwords.size(), 1);
+		BC_ASSERT_CPP_EQUAL(passwords[0].pass, "password-of-" + users[i]);
+	}
+}
+
+/*
+ * Lookups waiting for a database connection are fetched with 'soci-password-batch-request':
+ * - user ids are bound as parameters of the request, they cannot alter it;
+ * - users authenticating with another username than their own are still looked up with 'soci-password-request';
+ * - users returned by the database with another case (case-insensitive collation) are found.
+ */
+void batchedPasswordLookups() {
+	SqliteBackend backend{};
+	std::string empty{};
+	RootConfigStruct configRoot{"flexisip-tester", "Fake configuration for testing purposes", {}, empty};
+	declareConfig(configRoot);
+	const auto& authModuleConfig = *configRoot.get<GenericStruct>("module::Authentication");
+	authModuleConfig.get<ConfigInt>("soci-poolsize")->set("1");
+	// Slow enough for the following lookups to be queued while the first one runs.
+	authModuleConfig.get<ConfigString>("soci-password-request")
+	    ->set("WITH RECURSIVE counter(n) AS (SELECT 1 UNION ALL SELECT n + 1 FROM counter WHERE n < 300000) "
+	          "SELECT 'single-password-of-' || :id, 'SHA-DDOCK' FROM (SELECT max(n) FROM counter) "
+	          "WHERE :id COLLATE NOCASE IN ('first-user', 'user-a', 'user-b', 'user-c')");
+	authModuleConfig.get<ConfigString>("soci-password-batch-request")
+	    ->set("SELECT 'batch-password-of-' || id, 'SHA-DDOCK', id FROM (SELECT 'user-a' AS id UNION SELECT 'user-b' "
+	          "UNION SELECT 'user-c') WHERE id COLLATE NOCASE IN (:ids)");
+	backend.setConfig(authModuleConfig);
+	SociAuthDB authDb{configRoot};
+
+	struct Lookup {
+		std::string id;
+		std::string authid;
+		std::optional<std::string> expectedPassword;
+	};
+	const std::vector<Lookup> lookups{
+	    // Not batchable (authid differs from id), this one is always looked up alone.
+	    {"first-user", "first-user-authid", "single-password-of-first-user"},
+	    {"user-a", "user-a", "batch-password-of-user-a"},
+	    {"user-b", "user-b", "batch-password-of-user-b"},
+	    {"User-C", "User-C", "single-password-of-user-c"},
+	    {"user-a') OR ('1'='1", "user-a') OR ('1'='1", std::nullopt},
+	    {R"(user-a\' OR 1=1 -- )", R"(user-a\' OR 1=1 -- )", std::nullopt},
+	    {"unknown-user", "unknown-user", std::nullopt},
+	    {"user-b", "another-user", "single-password-of-user-b"},
+	};
+	std::vector<PasswordRequestListener> listeners(lookups.size());
+	for (std::size_t i = 0; i < lookups.size(); ++i) {
+		authDb.getPasswordFromBackend(lookups[i].id, "domain-stand-in", lookups[i].authid, &listeners[i]);
+	}
+
+	for (std::size_t i = 0; i < lookups.size(); ++i) {
+		auto future = listeners[i].getFuture();
+		BC_HARD_ASSERT_TRUE(future.wait_for(5s) == std::future_status::ready);
+		const auto [result, passwords] = future.get();
+		if (!lookups[i].expectedPassword) {
+			BC_ASSERT_CPP_EQUAL(result, AuthDbResult::PASSWORD_NOT_FOUND);
+			continue;
+		}
+		BC_ASSERT_CPP_EQUAL(result, AuthDbResult::PASSWORD_FOUND);
+		BC_HARD_ASSERT_CPP_EQUAL(passwords.size(), 1);
+		BC_ASSERT_CPP_EQUAL(passwords[0].pass, *lookups[i].expectedPassword);
+	}
+}
+
 namespace {
 TestSuite _("SociAuthDB",
             {
@@ -165,6 +268,8 @@ TestSuite _("SociAuthDB",
                 CLASSY_TEST((customPasswordRequestParamInjection<MySqlBackend, domain>)),
                 CLASSY_TEST((customPasswordRequestParamInjection<MySqlBackend, authId>)),
                 CLASSY_TEST((customPasswordRequestParamInjection<MySqlBackend, none>)),
+                CLASSY_TEST(concurrentPasswordLookups),
+                CLASSY_TEST(batchedPasswordLookups),
             },
             Hooks().afterSuite([] {
 	            sMysqlSuiteServer = std::nullopt;
@@ -22,6 +22,7 @@
 #include <fstream>
 #include <memory>
 #include <optional>
+#include <set>
 #include <sstream>
 #include <string>
 
@@ -862,6 +863,40 @@ void forcedAudioCodec() {
 	BC_ASSERT_CPP_EQUAL(legBCodec->getClockRate(), 8000);
 }
 
+/*
+ * With several workers, the proxy dispatches calls to the B2BUA workers according to their Call-ID, and each worker
+ * bridges the calls it receives (worker i being the one reached on the port of 'b2bua-server/transport' + i).
+ */
+void multipleWorkersDispatchCallsByCallId() {
+	constexpr size_t kWorkers = 2;
+	B2buaAndProxyServer server{"config/flexisip_b2bua.conf", false};
+	const auto* configRoot = server.getAgent()->getConfigManager().getRoot();
+	auto* b2buaServerConfig = configRoot->get<GenericStruct>("b2bua-server");
+	b2buaServerConfig->get<ConfigInt>("workers")->set(to_string(kWorkers));
+	configRoot->get<GenericStruct>("module::B2bua")->get<ConfigInt>("workers")->set(to_string(kWorkers));
+	server.start();
+	const auto basePort = stoi(SipUri{b2buaServerConfig->get<ConfigString>("transport")->read()}.getPort());
+
+	ClientBuilder builder{*server.getAgent()};
+	auto caller = builder.build("sip:caller@sip.example.org");
+	auto callee = builder.build("sip:callee@sip.example.org");
+
+	// Call-IDs are random: place calls until every worker bridged at least one of them.
+	set<size_t> usedWorkers{};
+	for (auto call = 0; call < 16 && usedWorkers.size() < kWorkers; ++call) {
+		const auto& callerCall = caller.call(callee);
+		BC_HARD_ASSERT(callerCall != nullptr);
+		const auto& calleeCall = ClientCall::getLinphoneCall(callee.getCurrentCall().value());
+
+		const auto worker = hash<string_view>{}(callerCall->getCallLog()->getCallId()) % kWorkers;
+		BC_ASSERT_CPP_EQUAL(calleeCall->getRemoteContactAddress()->getPort(), basePort + static_cast<int>(worker));
+		usedWorkers.insert(worker);
+
+		BC_HARD_ASSERT(caller.endCurrentCall(callee));
+	}
+	BC_ASSERT_CPP_EQUAL(usedWorkers.size(), kWorkers);
+}
+
 const char VP8[] = "vp8";
 // const char H264[] = "h264";
 
@@ -887,6 +922,7 @@ TestSuite _{
 		CLASSY_TEST(answerToPauseWithAudioInactive),
         CLASSY_TEST(unknownMediaAttrAreFilteredOutOnReinvites),
         CLASSY_TEST(forcedAudioCodec),
+        CLASSY_TEST(multipleWorkersDispatchCallsByCallId),
     },
 };
 } // namespace
@@ -7,6 +7,8 @@
 #include <atomic>
 #include <future>
 
+#include <sys/resource.h>
+
 #include "b2bua/b2bua-server.hh"
 #include "b2bua/sip-bridge/accounts/loaders/static-account-loader.hh"
 #include "tester.hh"
@@ -42,10 +44,19 @@ ostream& operator<<(ostream& stream, const unordered_set<T>& set) {
 	return stream << "\n}";
 }
 
+/** Peak resident set size of the process, in KiB */
+usize_t peakResidentSetKiB() {
+	auto usage = rusage{};
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss;
+}
+
 /** Attempt to load the given amount of accounts into a linphone::Core.
- *  Fail if it took more the given amount of milliseconds
+ *  Fail if it took more the given amount of milliseconds, or if the peak memory usage of the process grew by more than
+ *  the given amount of MiB while loading.
+ *  Accounts that do not need to register must only be instantiated in the core once selected.
  */
-template <usize_t accountCount, usize_t maxMs>
+template <usize_t accountCount, usize_t maxMs, usize_t maxMiB = 100>
 void loadManyAccounts() {
 	const auto& suRoot = make_shared<sofiasip::SuRoot>();
 	auto b2buaConfMan = ConfigManager();
@@ -68,11 +79,25 @@ void loadManyAccounts() {
 		account.outboundProxy = "<sip:" + randomString(10) + ".example.org;transport=tls>";
 	}
 
+	const auto selectedUri = accounts.front().uri;
+
+	const auto peakKiBBefore = peakResidentSetKiB();
 	const auto& before = chrono::steady_clock::now();
 	auto pool = AccountPool(suRoot, b2buaCore, "perfTestAccountPool", poolConfig,
 	                        make_unique<StaticAccountLoader>(std::move(accounts)));
-	BC_ASSERT_LOWER_STRICT(chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - before).count(),
-	                       maxMs, usize_t, "%d");
+	const auto elapsedMs = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - before).count();
+	const auto grownKiB = peakResidentSetKiB() - peakKiBBefore;
+	SLOGD << __FUNCTION__ << " - Loaded " << accountCount << " accounts in " << elapsedMs << "ms, peak memory grew by "
+	      << grownKiB << "KiB";
+	BC_ASSERT_LOWER_STRICT(elapsedMs, maxMs, usize_t, "%d");
+	BC_ASSERT_LOWER_STRICT(grownKiB, maxMiB * 1024, usize_t, "%d");
+
+	BC_ASSERT_CPP_EQUAL(pool.size(), accountCount);
+	BC_ASSERT_CPP_EQUAL(b2buaCore->getAccountList().size(), 0);
+	const auto& selected = pool.getAccountByUri(selectedUri);
+	BC_HARD_ASSERT(selected != nullptr);
+	BC_ASSERT(selected->getLinphoneAccount() != nullptr);
+	BC_ASSERT_CPP_EQUAL(b2buaCore->getAccountList().size(), 1);
 }
 
 enum class WithAuth : bool {
@@ -230,6 +255,7 @@ const TestSuite _{
         // Keep benchmarking out of the default (regression tests) runs
         CLASSY_TEST((loadManyAccounts<300, 2'100>)).tag("benchmark").tag("Skip"),
         CLASSY_TEST((loadManyAccounts<3000, 90'000>)).tag("benchmark").tag("Skip"),
+        CLASSY_TEST((loadManyAccounts<100'000, 20'000, 400>)).tag("benchmark").tag("Skip"),
         CLASSY_TEST((reRegisterManyAccounts<30, 10, 3, 3 * 1000 / 2, WithAuth::No>)).tag("benchmark").tag("Skip"),
         CLASSY_TEST((reRegisterManyAccounts<30, 10, 4, 4 * 1000 / 2, WithAuth::Yes>)).tag("benchmark").tag("Skip"),
         CLASSY_TEST((reRegisterManyAccounts<300, 10, 20, 20 * 1000 / 2, WithAuth::No>)).tag("benchmark").tag("Skip"),
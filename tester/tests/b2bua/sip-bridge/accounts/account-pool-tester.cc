@@ -270,13 +270,32 @@ void emptyThenPublishSqlTest() {
 
 	///////// Account added
 	SUITE_SCOPE->sql
-	    << R"sql(INSERT INTO users VALUES ("account2", "some.provider.example.com", "userID", "NEWp@$sword", "addedAlias", "new.domain.org", "<sip:new.outbound.org:5060;transport=tcp>"))sql";
+	    << R"sql(INSERT INTO users VALUES ("account2", "some.provider.example.com", "userID", "OLDp@$sword", "oldAlias", "old.domain.org", "<sip:old.outbound.org:5060;transport=tcp>"))sql";
 
 	ready.command({"PUBLISH", "flexisip/B2BUA/account",
 	               R"({"username": "account2","domain": "some.provider.example.com","identifier":"userID"})"},
 	              {});
 
 	shared_ptr<Account> actualAccount2{};
+	asserter
+	    .wait([&pool, &actualAccount2] {
+		    actualAccount2 = pool.getAccountByUri("sip:account2@some.provider.example.com");
+		    FAIL_IF(!actualAccount2 || actualAccount2->getAlias().str() != "sip:oldAlias@old.domain.org");
+		    return ASSERTION_PASSED();
+	    })
+	    .assert_passed();
+	// Accounts that do not register are only instantiated when first needed
+	BC_HARD_ASSERT(!actualAccount2->isInstantiated());
+
+	///////// Account updated before it was ever used
+	SUITE_SCOPE->sql << R"sql(DELETE FROM users WHERE usernameInDb = "account2")sql";
+	SUITE_SCOPE->sql
+	    << R"sql(INSERT INTO users VALUES ("account2", "some.provider.example.com", "userID", "NEWp@$sword", "addedAlias", "new.domain.org", "<sip:new.outbound.org:5060;transport=tcp>"))sql";
+
+	ready.command({"PUBLISH", "flexisip/B2BUA/account",
+	               R"({"username": "account2","domain": "some.provider.example.com","identifier":"userID"})"},
+	              {});
+
 	asserter
 	    .wait([&pool, &actualAccount2] {
 		    actualAccount2 = pool.getAccountByUri("sip:account2@some.provider.example.com");
@@ -284,6 +303,8 @@ void emptyThenPublishSqlTest() {
 		    return ASSERTION_PASSED();
 	    })
 	    .assert_passed();
+	// The update did not instantiate the account: it is created from the updated description when first needed.
+	BC_HARD_ASSERT(!actualAccount2->isInstantiated());
 
 	///////// ASSERT AFTER UPDATE
 	BC_HARD_ASSERT_TRUE(pool.size() == 1);
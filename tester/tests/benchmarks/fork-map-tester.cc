@@ -0,0 +1,223 @@
+/*
+    Flexisip, a flexible SIP proxy server with media capabilities.
+    Copyright (C) 2010-2024 Belledonne Communications SARL, All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "flexisip/fork-context/fork-map.hh"
+#include "flexisip/logmanager.hh"
+
+#include "utils/test-patterns/test.hh"
+#include "utils/test-suite.hh"
+
+/*
+ * Late-fork dispatch triggered by contact registrations, with a large number of pending forks: each registration looks
+ * up the late forks of the registered AoR then the dispatched forks finish and are removed from the store, as done by
+ * ModuleRouter::onContactRegistered() and ModuleRouter::onForkContextFinished().
+ * The legacy std::multimap store is measured as a baseline.
+ * Run them with: flexisip_tester --suite "Fork map" --verbose
+ */
+
+namespace flexisip::tester {
+namespace {
+using namespace std;
+using namespace std::chrono;
+
+struct FakeFork {
+	vector<string> keys;
+	bool forkLate;
+};
+using FakeForkPtr = shared_ptr<FakeFork>;
+
+/*
+ * Same operations as ModuleRouter on top of the legacy multimap.
+ */
+class LegacyForkStore {
+public:
+	void add(const string& key, const FakeForkPtr& fork) {
+		mForks.emplace(key, fork);
+	}
+	vector<FakeForkPtr> getLateForks(const string& key) const {
+		vector<FakeForkPtr> lateForks{};
+		lateForks.reserve(mForks.count(key));
+		auto range = mForks.equal_range(key);
+		for (auto it = range.first; it != range.second; ++it) {
+			if (it->second->forkLate) lateForks.emplace_back(it->second);
+		}
+		return lateForks;
+	}
+	size_t remove(const FakeForkPtr& fork) {
+		size_t removed = 0;
+		for (const auto& key : fork->keys) {
+			auto range = mForks.equal_range(key);
+			for (auto it = range.first; it != range.second;) {
+				if (it->second == fork) {
+					it = mForks.erase(it);
+					removed++;
+				} else ++it;
+			}
+		}
+		return removed;
+	}
+	size_t size() const {
+		return mForks.size();
+	}
+
+private:
+	multimap<string, FakeForkPtr> mForks{};
+};
+
+class ForkStore {
+public:
+	void add(const string& key, const FakeForkPtr& fork) {
+		mForks.add(key, fork);
+	}
+	vector<FakeForkPtr> getLateForks(const string& key) const {
+		vector<FakeForkPtr> lateForks{};
+		const auto* forks = mForks.find(key);
+		if (forks == nullptr) return lateForks;
+		lateForks.reserve(forks->size());
+		for (const auto& fork : *forks) {
+			if (fork->forkLate) lateForks.emplace_back(fork);
+		}
+		return lateForks;
+	}
+	size_t remove(const FakeForkPtr& fork) {
+		return mForks.remove(fork->keys, fork);
+	}
+	size_t size() const {
+		return mForks.size();
+	}
+
+private:
+	ForkMap<FakeForkPtr> mForks{};
+};
+
+string aorOf(size_t index) {
+	return "sip:user-" + to_string(index) + "@sip.example.org";
+}
+
+/*
+ * Store pendingForks forks, spread over pendingForks / forksPerAor AoRs, one out of ten also being stored with an
+ * alias key. Then register every AoR in random order: dispatch its late forks and finish them.
+ */
+template <typename Store, size_t pendingForks, size_t forksPerAor = 2>
+void lateForkDispatch() {
+	const auto aorCount = pendingForks / forksPerAor;
+	vector<FakeForkPtr> forks{};
+	forks.reserve(pendingForks);
+	for (size_t i = 0; i < pendingForks; i++) {
+		auto fork = make_shared<FakeFork>(FakeFork{{aorOf(i % aorCount)}, i % 7 != 0});
+		if (i % 10 == 0) fork->keys.emplace_back("sip:alias-" + to_string(i) + "@sip.example.org");
+		forks.emplace_back(std::move(fork));
+	}
+
+	Store store{};
+	auto start = steady_clock::now();
+	for (const auto& fork : forks) {
+		for (const auto& key : fork->keys) {
+			store.add(key, fork);
+		}
+	}
+	const auto insertion = duration_cast<milliseconds>(steady_clock::now() - start);
+	const auto entries = store.size();
+
+	vector<size_t> registrations(aorCount);
+	for (size_t i = 0; i < aorCount; i++) {
+		registrations[i] = i;
+	}
+	shuffle(registrations.begin(), registrations.end(), mt19937{42});
+
+	size_t dispatched = 0;
+	size_t removed = 0;
+	start = steady_clock::now();
+	for (const auto index : registrations) {
+		const auto lateForks = store.getLateForks(aorOf(index));
+		dispatched += lateForks.size();
+		for (const auto& fork : lateForks) {
+			removed += store.remove(fork);
+		}
+	}
+	const auto dispatch = duration_cast<microseconds>(steady_clock::now() - start);
+
+	SLOGI << "Fork map benchmark - " << (is_same_v<Store, ForkStore> ? "hashed index" : "legacy multimap") << ", "
+	      << pendingForks << " pending forks over " << aorCount << " AoRs: insertion in " << insertion.count()
+	      << "ms, " << registrations.size() << " registrations dispatching " << dispatched << " late forks in "
+	      << dispatch.count() / 1000 << "ms (" << dispatch.count() * 1000 / registrations.size()
+	      << "ns per registration)";
+
+	size_t expectedLateForks = 0;
+	size_t expectedEntries = 0;
+	for (const auto& fork : forks) {
+		expectedEntries += fork->keys.size();
+		if (fork->forkLate) {
+			expectedLateForks++;
+		}
+	}
+	BC_ASSERT_CPP_EQUAL(entries, expectedEntries);
+	BC_ASSERT_CPP_EQUAL(dispatched, expectedLateForks);
+	BC_ASSERT_CPP_EQUAL(store.size(), entries - removed);
+}
+
+/*
+ * A fork stored with an alias key is found with both keys and removed from both at once.
+ */
+void forkMapAliases() {
+	ForkMap<FakeForkPtr> forkMap{};
+	auto fork = make_shared<FakeFork>(FakeFork{{"sip:user@sip.example.org", "sip:alias@sip.example.org"}, true});
+	auto other = make_shared<FakeFork>(FakeFork{{"sip:user@sip.example.org"}, true});
+	for (const auto& key : fork->keys) {
+		forkMap.add(key, fork);
+	}
+	forkMap.add(other->keys.front(), other);
+	BC_ASSERT_CPP_EQUAL(forkMap.size(), 3);
+	BC_ASSERT_CPP_EQUAL(forkMap.keyCount(), 2);
+
+	const auto* forks = forkMap.find("sip:user@sip.example.org");
+	BC_HARD_ASSERT(forks != nullptr);
+	BC_ASSERT_TRUE(*forks == vector<FakeForkPtr>({fork, other}));
+	BC_ASSERT(forkMap.find("sip:unknown@sip.example.org") == nullptr);
+
+	BC_ASSERT_CPP_EQUAL(forkMap.remove(fork->keys, fork), 2);
+	BC_ASSERT(forkMap.find("sip:alias@sip.example.org") == nullptr);
+	forks = forkMap.find("sip:user@sip.example.org");
+	BC_HARD_ASSERT(forks != nullptr);
+	BC_ASSERT_TRUE(*forks == vector<FakeForkPtr>({other}));
+	BC_ASSERT_CPP_EQUAL(forkMap.remove(fork->keys, fork), 0);
+
+	BC_ASSERT_CPP_EQUAL(forkMap.remove(other->keys, other), 1);
+	BC_ASSERT_TRUE(forkMap.empty());
+	BC_ASSERT_CPP_EQUAL(forkMap.keyCount(), 0);
+}
+
+TestSuite _("Fork map",
+            {
+                CLASSY_TEST(forkMapAliases),
+                CLASSY_TEST((lateForkDispatch<ForkStore, 10'000>)).tag("benchmark"),
+                CLASSY_TEST((lateForkDispatch<LegacyForkStore, 10'000>)).tag("benchmark"),
+                CLASSY_TEST((lateForkDispatch<ForkStore, 500'000>)).tag("benchmark").tag("Skip"),
+                CLASSY_TEST((lateForkDispatch<LegacyForkStore, 500'000>)).tag("benchmark").tag("Skip"),
+            });
+} // namespace
+} // namespace flexisip::tester
@@ -0,0 +1,259 @@
+/*
+    Flexisip, a flexible SIP proxy server with media capabilities.
+    Copyright (C) 2010-2024 Belledonne Communications SARL, All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "sofia-wrapper/nta-agent.hh"
+#include "sofia-wrapper/sip-header-private.hh"
+#include "utils/allocation-counter.hh"
+#include "utils/contact-inserter.hh"
+#include "utils/core-assert.hh"
+#include "utils/server/proxy-server.hh"
+#include "utils/sip-load-replayer.hh"
+#include "utils/test-patterns/test.hh"
+#include "utils/test-suite.hh"
+#include "utils/tmp-dir.hh"
+
+/*
+ * End-to-end benchmarks of the proxy pipeline: SIP scenarios are replayed through an Agent with the internal registrar
+ * over loopback TCP connections, and the throughput, latency percentiles and allocations are reported.
+ * Run them with: flexisip_benchmark --suite "Proxy load benchmark" --verbose
+ */
+
+namespace flexisip::tester {
+namespace {
+using namespace std;
+using namespace std::chrono_literals;
+using namespace sofiasip;
+
+// clang-format off
+const SipScenario kRegisterStorm{"REGISTER storm", {
+    "REGISTER sip:localhost SIP/2.0\r\n"
+    "From: <sip:user-{index}@localhost>;tag=register-{index}\r\n"
+    "To: <sip:user-{index}@localhost>\r\n"
+    "Call-ID: register-{index}\r\n"
+    "CSeq: 1 REGISTER\r\n"
+    "Contact: <sip:user-{index}@{callee};transport=tcp>\r\n"
+    "Expires: 600\r\n"
+    "Content-Length: 0\r\n\r\n",
+}};
+
+const SipScenario kCall{"INVITE/200/ACK/BYE", {
+    "INVITE sip:callee@localhost SIP/2.0\r\n"
+    "From: <sip:caller@localhost>;tag=caller-{index}\r\n"
+    "To: <sip:callee@localhost>\r\n"
+    "Call-ID: call-{index}\r\n"
+    "CSeq: 1 INVITE\r\n"
+    "Contact: <sip:caller@127.0.0.1;transport=tcp>\r\n"
+    "Content-Length: 0\r\n\r\n",
+
+    "ACK sip:callee@{callee};transport=tcp SIP/2.0\r\n"
+    "From: <sip:caller@localhost>;tag=caller-{index}\r\n"
+    "To: <sip:callee@localhost>;tag={to-tag}\r\n"
+    "Call-ID: call-{index}\r\n"
+    "CSeq: 1 ACK\r\n"
+    "Content-Length: 0\r\n\r\n",
+
+    "BYE sip:callee@{callee};transport=tcp SIP/2.0\r\n"
+    "From: <sip:caller@localhost>;tag=caller-{index}\r\n"
+    "To: <sip:callee@localhost>;tag={to-tag}\r\n"
+    "Call-ID: call-{index}\r\n"
+    "CSeq: 2 BYE\r\n"
+    "Content-Length: 0\r\n\r\n",
+}};
+
+const SipScenario kMessage{"MESSAGE fan-out", {
+    "MESSAGE sip:callee@localhost SIP/2.0\r\n"
+    "From: <sip:caller@localhost>;tag=message-{index}\r\n"
+    "To: <sip:callee@localhost>\r\n"
+    "Call-ID: message-{index}\r\n"
+    "CSeq: 1 MESSAGE\r\n"
+    "Content-Type: text/plain\r\n"
+    "Content-Length: 5\r\n\r\n"
+    "Hello",
+}};
+// clang-format on
+
+class ProxyLoadBench {
+public:
+	ProxyLoadBench()
+	    : mProxy{{
+	          {"global/transports", "sip:127.0.0.1:0;transport=tcp"},
+	          {"module::Registrar/enabled", "true"},
+	          {"module::Registrar/reg-domains", "localhost"},
+	          {"module::DoSProtection/enabled", "false"},
+	      }} {
+		mProxy.start();
+		mReplayer = make_unique<SipLoadReplayer>(mProxy.getRoot(), "sip:127.0.0.1:"s + mProxy.getFirstPort() +
+		                                                                ";transport=tcp");
+	}
+
+	// Register `deviceCount` contacts of sip:callee@localhost, all reaching the callee user agent of the replayer.
+	void registerCallee(int deviceCount) {
+		ContactInserter inserter{mProxy.getAgent()->getRegistrarDb()};
+		inserter.setAor("sip:callee@localhost").setExpire(1h).withUniqueId(true);
+		for (auto device = 0; device < deviceCount; ++device) {
+			const auto contact = "sip:callee@" + mReplayer->getCalleeAddress() + ";transport=tcp;device=" +
+			                     to_string(device);
+			inserter.insert({contact});
+		}
+		BC_HARD_ASSERT(CoreAssert{mProxy}.iterateUpTo(
+		    16, [&inserter]() { return inserter.finished(); }, 2s));
+	}
+
+	SipLoadReport run(const SipScenario& scenario, size_t iterations, size_t concurrency) {
+		const auto report = mReplayer->replay(scenario, iterations, concurrency);
+		SLOGI << "Proxy load benchmark - '" << scenario.name << "' x" << iterations << " (concurrency "
+		      << concurrency << "): " << report;
+		BC_ASSERT_CPP_EQUAL(report.transactions, iterations * expectedTransactions(scenario));
+		BC_ASSERT_CPP_EQUAL(report.failedTransactions, 0);
+		return report;
+	}
+
+private:
+	static size_t expectedTransactions(const SipScenario& scenario) {
+		return count_if(scenario.requests.begin(), scenario.requests.end(),
+		                [](const string& request) { return request.rfind("ACK ", 0) != 0; });
+	}
+
+	Server mProxy;
+	unique_ptr<SipLoadReplayer> mReplayer;
+};
+
+template <size_t iterations, size_t concurrency>
+void registerStorm() {
+	ProxyLoadBench bench{};
+	bench.run(kRegisterStorm, iterations, concurrency);
+}
+
+template <size_t iterations, size_t concurrency>
+void calls() {
+	ProxyLoadBench bench{};
+	bench.registerCallee(1);
+	bench.run(kCall, iterations, concurrency);
+}
+
+template <size_t devices, size_t iterations, size_t concurrency>
+void messageFanOut() {
+	ProxyLoadBench bench{};
+	bench.registerCallee(devices);
+	bench.run(kMessage, iterations, concurrency);
+}
+
+/*
+ * Recorded traces can be replayed as well: requests are separated by lines made of "--".
+ */
+void replayRecordedTrace() {
+	TmpDir dir{__FUNCTION__};
+	const auto tracePath = dir.path() / "register.trace";
+	{
+		ofstream trace{tracePath};
+		trace << "REGISTER sip:localhost SIP/2.0\n"
+		         "From: <sip:user-{index}@localhost>;tag=register-{index}\n"
+		         "To: <sip:user-{index}@localhost>\n"
+		         "Call-ID: register-{index}\n"
+		         "CSeq: 1 REGISTER\n"
+		         "Contact: <sip:user-{index}@{callee};transport=tcp>\n"
+		         "Content-Length: 0\n"
+		         "--\n"
+		         "REGISTER sip:localhost SIP/2.0\n"
+		         "From: <sip:user-{index}@localhost>;tag=register-{index}\n"
+		         "To: <sip:user-{index}@localhost>\n"
+		         "Call-ID: register-{index}\n"
+		         "CSeq: 2 REGISTER\n"
+		         "Contact: *\n"
+		         "Expires: 0\n"
+		         "Content-Length: 0\n";
+	}
+
+	const auto scenario = SipScenario::fromTraceFile(tracePath);
+	BC_HARD_ASSERT_CPP_EQUAL(scenario.requests.size(), 2);
+
+	ProxyLoadBench bench{};
+	bench.run(scenario, 10, 2);
+}
+
+/*
+ * Count the heap allocations made for each INVITE transaction that goes through the proxy, from the reception of the
+ * request to the forwarding of the final response.
+ * The callee is registered with a contact that refuses TCP connections, so that each transaction completes with a
+ * 503 generated by the proxy without involving another user agent.
+ */
+void allocationsPerProxiedInvite() {
+	constexpr auto transactionCount = 200;
+	Server proxy{{
+	    {"global/transports", "sip:127.0.0.1:0;transport=tcp"},
+	    {"module::Registrar/enabled", "true"},
+	    {"module::Registrar/reg-domains", "localhost"},
+	    {"module::DoSProtection/enabled", "false"},
+	}};
+	proxy.start();
+	CoreAssert asserter{proxy};
+
+	ContactInserter inserter{proxy.getAgent()->getRegistrarDb()};
+	inserter.setAor("sip:callee@localhost").setExpire(1h).insert({"sip:callee@127.0.0.1:1;transport=tcp"});
+	BC_HARD_ASSERT(asserter.iterateUpTo(
+	    8, [&inserter]() { return inserter.finished(); }, 1s));
+
+	const auto proxyUri = "sip:127.0.0.1:"s + proxy.getFirstPort() + ";transport=tcp";
+	NtaAgent caller{proxy.getRoot(), "sip:127.0.0.1:0;transport=tcp"};
+	const auto sendInvite = [&](int index) {
+		auto request = make_unique<MsgSip>();
+		request->makeAndInsert<SipHeaderRequest>(sip_method_invite, "sip:callee@localhost");
+		request->makeAndInsert<SipHeaderFrom>("sip:caller@localhost", "stub-from-tag");
+		request->makeAndInsert<SipHeaderTo>("sip:callee@localhost");
+		request->makeAndInsert<SipHeaderCallID>("stub-call-id-" + to_string(index));
+		request->makeAndInsert<SipHeaderCSeq>(20u, sip_method_invite);
+		request->makeAndInsert<SipHeaderContact>("<sip:caller@127.0.0.1;transport=tcp>");
+		auto transaction = caller.createOutgoingTransaction(std::move(request), proxyUri);
+		BC_HARD_ASSERT(asserter.iterateUpTo(
+		    32, [&transaction]() { return transaction->isCompleted(); }, 2s));
+		BC_ASSERT_TRUE(transaction->getStatus() >= 300);
+	};
+
+	// Warm up connections, caches and free lists.
+	for (auto i = 0; i < 10; ++i) {
+		sendInvite(i);
+	}
+
+	AllocationCounter counter{};
+	for (auto i = 0; i < transactionCount; ++i) {
+		sendInvite(10 + i);
+	}
+	const auto allocations = counter.count();
+	SLOGI << __FUNCTION__ << " - " << transactionCount << " INVITE transactions: " << allocations
+	      << " allocations, i.e. " << allocations / transactionCount << " per transaction";
+}
+
+TestSuite _("Proxy load benchmark",
+            {
+                CLASSY_TEST(replayRecordedTrace).tag("benchmark"),
+                CLASSY_TEST(allocationsPerProxiedInvite).tag("benchmark"),
+                CLASSY_TEST((registerStorm<100, 10>)).tag("benchmark"),
+                CLASSY_TEST((calls<100, 10>)).tag("benchmark"),
+                CLASSY_TEST((messageFanOut<3, 100, 10>)).tag("benchmark"),
+                CLASSY_TEST((registerStorm<10'000, 100>)).tag("benchmark").tag("Skip"),
+                CLASSY_TEST((calls<10'000, 100>)).tag("benchmark").tag("Skip"),
+                CLASSY_TEST((messageFanOut<10, 10'000, 100>)).tag("benchmark").tag("Skip"),
+            });
+} // namespace
+} // namespace flexisip::tester
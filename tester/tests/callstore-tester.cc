@@ -0,0 +1,148 @@
+/*
+    Flexisip, a flexible SIP proxy server with media capabilities.
+    Copyright (C) 2010-2024 Belledonne Communications SARL, All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "callstore.hh"
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "flexisip/sofia-wrapper/msg-sip.hh"
+
+#include "sofia-wrapper/sip-header-private.hh"
+#include "utils/test-patterns/test.hh"
+#include "utils/test-suite.hh"
+
+using namespace std;
+
+namespace flexisip::tester {
+namespace {
+
+/*
+ * Create a stub INVITE request, with a random Call-ID.
+ */
+MsgSip makeInvite(const string& fromTag) {
+	MsgSip msg{};
+	msg.makeAndInsert<sofiasip::SipHeaderRequest>(::sip_method_invite, "sip:callee@sip.example.org");
+	msg.makeAndInsert<sofiasip::SipHeaderCallID>("stub-call-id");
+	msg.makeAndInsert<sofiasip::SipHeaderCSeq>(20u, ::sip_method_invite);
+	msg.makeAndInsert<sofiasip::SipHeaderFrom>("sip:stub-user@sip.example.org", fromTag);
+	return msg;
+}
+
+/*
+ * Calls are found and removed by Call-ID, other calls stay untouched.
+ */
+void findAndRemoveByCallId() {
+	CallStore store{};
+	vector<MsgSip> invites{};
+	vector<shared_ptr<CallContextBase>> calls{};
+	for (auto i = 0; i < 10; ++i) {
+		invites.push_back(makeInvite("stub-from-tag-" + to_string(i)));
+		calls.push_back(make_shared<CallContextBase>(invites.back().getSip()));
+		store.store(calls.back());
+	}
+	// A second call sharing the Call-ID of the first one (e.g. another branch of the same INVITE)
+	const auto sameCallId = make_shared<CallContextBase>(invites.front().getSip());
+	store.store(sameCallId);
+	BC_ASSERT_CPP_EQUAL(store.size(), 11);
+
+	for (size_t i = 0; i < calls.size(); ++i) {
+		BC_ASSERT(store.find(nullptr, invites[i].getSip(), true) == calls[i]);
+	}
+	auto unknown = makeInvite("stub-from-tag");
+	BC_ASSERT(store.find(nullptr, unknown.getSip(), true) == nullptr);
+
+	store.findAndRemoveExcept(nullptr, invites.front().getSip(), sameCallId, true);
+	BC_ASSERT_CPP_EQUAL(store.size(), 10);
+	BC_ASSERT(store.find(nullptr, invites.front().getSip(), true) == sameCallId);
+
+	store.remove(calls[5]);
+	BC_ASSERT_CPP_EQUAL(store.size(), 9);
+	BC_ASSERT(store.find(nullptr, invites[5].getSip(), true) == nullptr);
+	BC_ASSERT(store.find(nullptr, invites[6].getSip(), true) == calls[6]);
+
+	// Every call is inactive for a negative inactivity period
+	store.removeAndDeleteInactives(-1);
+	BC_ASSERT_CPP_EQUAL(store.size(), 0);
+	BC_ASSERT(store.find(nullptr, invites[6].getSip(), true) == nullptr);
+}
+
+/*
+ * Inactive calls are all removed after enough invocations, even when the store holds more calls than a single
+ * invocation checks.
+ */
+void removeInactivesIncrementally() {
+	constexpr auto callCount = 5'000;
+	CallStore store{};
+	for (auto i = 0; i < callCount; ++i) {
+		auto invite = makeInvite("stub-from-tag");
+		store.store(make_shared<CallContextBase>(invite.getSip()));
+	}
+
+	store.removeAndDeleteInactives(-1);
+	BC_ASSERT(0 < store.size());
+	BC_ASSERT(store.size() < callCount);
+
+	for (auto i = 0; i < 10 && store.size() != 0; ++i) {
+		store.removeAndDeleteInactives(-1);
+	}
+	BC_ASSERT_CPP_EQUAL(store.size(), 0);
+}
+
+/*
+ * Store the given amount of calls then look each of them up from its INVITE.
+ * Fail if a lookup took more than the given amount of nanoseconds on average: the cost of a lookup must not depend on
+ * the amount of stored calls.
+ */
+template <size_t callCount, size_t maxAverageNs>
+void findAmongManyCalls() {
+	CallStore store{};
+	vector<MsgSip> invites{};
+	invites.reserve(callCount);
+	for (size_t i = 0; i < callCount; ++i) {
+		invites.push_back(makeInvite("stub-from-tag"));
+		store.store(make_shared<CallContextBase>(invites.back().getSip()));
+	}
+
+	auto found = 0;
+	const auto before = chrono::steady_clock::now();
+	for (auto& invite : invites) {
+		if (store.find(nullptr, invite.getSip(), true) != nullptr) ++found;
+	}
+	const auto elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - before);
+
+	const auto averageNs = static_cast<size_t>(elapsed.count()) / callCount;
+	SLOGD << __FUNCTION__ << " - " << callCount << " calls, " << averageNs << "ns per lookup on average";
+	BC_ASSERT_CPP_EQUAL(found, callCount);
+	BC_ASSERT(averageNs < maxAverageNs);
+}
+
+TestSuite _("CallStore",
+            {
+                CLASSY_TEST(findAndRemoveByCallId),
+                CLASSY_TEST(removeInactivesIncrementally),
+                // Smoke test
+                CLASSY_TEST((findAmongManyCalls<1'000, 50'000>)).tag("benchmark"),
+                // Keep benchmarking out of the default (regression tests) runs
+                CLASSY_TEST((findAmongManyCalls<20'000, 50'000>)).tag("benchmark").tag("Skip"),
+                CLASSY_TEST((findAmongManyCalls<100'000, 50'000>)).tag("benchmark").tag("Skip"),
+            });
+
+} // namespace
+} // namespace flexisip::tester
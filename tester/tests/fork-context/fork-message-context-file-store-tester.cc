@@ -0,0 +1,251 @@
+/*
+    Flexisip, a flexible SIP proxy server with media capabilities.
+    Copyright (C) 2010-2024 Belledonne Communications SARL, All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "fork-context/fork-message-context-file-store.hh"
+
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "flexisip/module-router.hh"
+
+#include "agent.hh"
+#include "utils/chat-room-builder.hh"
+#include "utils/client-builder.hh"
+#include "utils/client-core.hh"
+#include "utils/core-assert.hh"
+#include "utils/server/proxy-server.hh"
+#include "utils/test-patterns/test.hh"
+#include "utils/test-suite.hh"
+#include "utils/tmp-dir.hh"
+
+using namespace std;
+using namespace std::chrono_literals;
+
+namespace flexisip::tester {
+namespace {
+
+ForkMessageContextDb makeFork(int index, time_t expirationDate = 1'700'000'000) {
+	ForkMessageContextDb dbFork{1.0 + index,
+	                            index,
+	                            false,
+	                            *gmtime(&expirationDate),
+	                            "MESSAGE sip:user-" + to_string(index) + "@sip.example.org SIP/2.0\r\n" +
+	                                string(200, 'x'),
+	                            sofiasip::MsgSipPriority::Normal};
+	dbFork.dbKeys = {"sip:user-" + to_string(index) + "@sip.example.org"};
+	dbFork.dbBranches.emplace_back("uid-" + to_string(index), 0.5, "branch request", "SIP/2.0 503", 1);
+	return dbFork;
+}
+
+void assertSameFork(const ForkMessageContextDb& actual, const ForkMessageContextDb& expected) {
+	auto actualDate = actual.expirationDate;
+	auto expectedDate = expected.expirationDate;
+	BC_ASSERT_CPP_EQUAL(actual.currentPriority, expected.currentPriority);
+	BC_ASSERT_CPP_EQUAL(actual.deliveredCount, expected.deliveredCount);
+	BC_ASSERT_CPP_EQUAL(actual.isFinished, expected.isFinished);
+	BC_ASSERT_CPP_EQUAL(timegm(&actualDate), timegm(&expectedDate));
+	BC_ASSERT_CPP_EQUAL(actual.request, expected.request);
+	BC_ASSERT(actual.msgPriority == expected.msgPriority);
+	BC_ASSERT_TRUE(actual.dbKeys == expected.dbKeys);
+	BC_HARD_ASSERT_CPP_EQUAL(actual.dbBranches.size(), expected.dbBranches.size());
+	for (size_t i = 0; i < actual.dbBranches.size(); ++i) {
+		BC_ASSERT_CPP_EQUAL(actual.dbBranches[i].contactUid, expected.dbBranches[i].contactUid);
+		BC_ASSERT_CPP_EQUAL(actual.dbBranches[i].priority, expected.dbBranches[i].priority);
+		BC_ASSERT_CPP_EQUAL(actual.dbBranches[i].request, expected.dbBranches[i].request);
+		BC_ASSERT_CPP_EQUAL(actual.dbBranches[i].lastResponse, expected.dbBranches[i].lastResponse);
+		BC_ASSERT_CPP_EQUAL(actual.dbBranches[i].clearedCount, expected.dbBranches[i].clearedCount);
+	}
+}
+
+void saveUpdateAndDelete() {
+	TmpDir dir{__func__};
+	ForkMessageContextFileStore store{dir.path()};
+
+	const auto uuid = store.saveForkMessageContext(makeFork(1));
+	assertSameFork(store.findForkMessageByUuid(uuid), makeFork(1));
+
+	auto updated = makeFork(1);
+	updated.deliveredCount = 3;
+	updated.dbBranches.emplace_back("uid-2", 1.0, "other branch request", "", 0);
+	store.updateForkMessageContext(updated, uuid);
+	assertSameFork(store.findForkMessageByUuid(uuid), updated);
+	BC_ASSERT_CPP_EQUAL(store.getForkCount(), 1);
+
+	store.deleteByUuid(uuid);
+	BC_ASSERT_CPP_EQUAL(store.getForkCount(), 0);
+	BC_ASSERT_THROWN(store.findForkMessageByUuid(uuid), runtime_error);
+	BC_ASSERT_THROWN(store.updateForkMessageContext(updated, uuid), runtime_error);
+}
+
+/*
+ * Forks are restored from the segments left by a previous instance, with their latest state, and deleted forks are
+ * not resurrected.
+ */
+void reopen() {
+	TmpDir dir{__func__};
+	string kept{}, updated{}, deleted{};
+	auto updatedFork = makeFork(2, 1'600'000'000);
+	updatedFork.deliveredCount = 7;
+	{
+		ForkMessageContextFileStore store{dir.path()};
+		kept = store.saveForkMessageContext(makeFork(1));
+		updated = store.saveForkMessageContext(makeFork(2));
+		deleted = store.saveForkMessageContext(makeFork(3));
+		store.updateForkMessageContext(updatedFork, updated);
+		store.deleteByUuid(deleted);
+	}
+
+	ForkMessageContextFileStore store{dir.path()};
+	BC_ASSERT_CPP_EQUAL(store.getForkCount(), 2);
+	const auto allForks = store.findAllForkMessage();
+	BC_HARD_ASSERT_CPP_EQUAL(allForks.size(), 2);
+	// Sorted by expiration date.
+	BC_ASSERT_CPP_EQUAL(allForks[0].uuid, updated);
+	BC_ASSERT_TRUE(allForks[0].dbKeys == updatedFork.dbKeys);
+	BC_ASSERT_CPP_EQUAL(allForks[1].uuid, kept);
+	assertSameFork(store.findForkMessageByUuid(kept), makeFork(1));
+	assertSameFork(store.findForkMessageByUuid(updated), updatedFork);
+	BC_ASSERT_THROWN(store.findForkMessageByUuid(deleted), runtime_error);
+
+	const auto uuid = store.saveForkMessageContext(makeFork(4));
+	BC_ASSERT(uuid != kept && uuid != updated && uuid != deleted);
+}
+
+/*
+ * A record partially written when the process stopped is dropped, the previous ones are still readable.
+ */
+void truncatedRecord() {
+	TmpDir dir{__func__};
+	string uuid{};
+	{
+		ForkMessageContextFileStore store{dir.path()};
+		uuid = store.saveForkMessageContext(makeFork(1));
+	}
+	for (const auto& entry : filesystem::directory_iterator{dir.path()}) {
+		if (filesystem::file_size(entry.path()) == 0) continue;
+		ofstream{entry.path(), ios::binary | ios::app} << "FMS1 partial record";
+	}
+
+	ForkMessageContextFileStore store{dir.path()};
+	BC_ASSERT_CPP_EQUAL(store.getForkCount(), 1);
+	assertSameFork(store.findForkMessageByUuid(uuid), makeFork(1));
+}
+
+/*
+ * Segments are removed once their forks are deleted, and a long-lived fork does not keep its segment on disk.
+ */
+void segmentsReclaimed() {
+	TmpDir dir{__func__};
+	ForkMessageContextFileStore store{dir.path(), 4096};
+
+	vector<string> uuids{};
+	for (auto i = 0; i < 100; ++i) {
+		uuids.push_back(store.saveForkMessageContext(makeFork(i)));
+	}
+	const auto segmentCount = store.getSegmentCount();
+	BC_ASSERT(segmentCount > 5);
+
+	for (size_t i = 1; i < uuids.size(); ++i) {
+		store.deleteByUuid(uuids[i]);
+	}
+	BC_ASSERT(store.getSegmentCount() <= 2);
+	assertSameFork(store.findForkMessageByUuid(uuids[0]), makeFork(0));
+
+	store.deleteByUuid(uuids[0]);
+	BC_ASSERT_CPP_EQUAL(store.getSegmentCount(), 1);
+	BC_ASSERT_CPP_EQUAL(store.getForkCount(), 0);
+}
+
+/*
+ * ModuleRouter evicts an undelivered message to the store once it has been idle for message-spill-delay, loads it back
+ * when its recipient registers again and deletes it from the store once delivered.
+ */
+void spilledByModuleRouter() {
+	TmpDir dir{__func__};
+	Server proxy{{
+	    {"global/transports", "sip:127.0.0.1:0;transport=tcp"},
+	    {"module::Registrar/enabled", "true"},
+	    {"module::Registrar/reg-domains", "sip.example.org"},
+	    {"module::Router/message-fork-late", "true"},
+	    {"module::Router/message-spill-directory", dir.path().string()},
+	    {"module::Router/message-spill-delay", "1"},
+	}};
+	proxy.start();
+	const auto router = dynamic_pointer_cast<ModuleRouter>(proxy.getAgent()->findModule("Router"));
+	BC_HARD_ASSERT(router != nullptr);
+	const auto store = dynamic_pointer_cast<ForkMessageContextFileStore>(router->getForkMessageRepository());
+	BC_HARD_ASSERT(store != nullptr);
+	const auto& messageForks = router->mStats.mCountMessageForks;
+	const auto& proxyForks = router->mStats.mCountMessageProxyForks;
+
+	ClientBuilder builder{*proxy.getAgent()};
+	const auto sender = builder.build("sip:sender@sip.example.org");
+	const auto recipient = builder.build("sip:recipient@sip.example.org");
+	CoreAssert asserter{sender, recipient, proxy};
+	recipient.disconnect();
+
+	sender.chatroomBuilder().build({recipient.getMe()})->createMessageFromUtf8("spilled")->send();
+
+	// The fork is saved to the store and evicted from memory once idle for message-spill-delay.
+	asserter
+	    .waitUntil(5s,
+	               [&store, &messageForks] {
+		               FAIL_IF(store->getForkCount() != 1);
+		               FAIL_IF(messageForks->finish->read() != 1);
+		               return ASSERTION_PASSED();
+	               })
+	    .hard_assert_passed();
+	BC_ASSERT_CPP_EQUAL(proxyForks->start->read(), 1u);
+	BC_ASSERT_CPP_EQUAL(proxyForks->finish->read(), 0u);
+	BC_ASSERT(store->findForkMessageByUuid(store->findAllForkMessage().front().uuid).request.find("spilled") !=
+	          string::npos);
+
+	// It is loaded back from the store and delivered when the recipient registers again.
+	recipient.reconnect();
+	asserter
+	    .wait([&recipient] {
+		    FAIL_IF(recipient.getAccount()->getState() != linphone::RegistrationState::Ok);
+		    FAIL_IF(recipient.getCore()->getUnreadChatMessageCount() != 1);
+		    return ASSERTION_PASSED();
+	    })
+	    .assert_passed();
+
+	// Then deleted from the store.
+	asserter
+	    .wait([&store, &proxyForks] {
+		    FAIL_IF(proxyForks->finish->read() != 1);
+		    FAIL_IF(store->getForkCount() != 0);
+		    return ASSERTION_PASSED();
+	    })
+	    .assert_passed();
+}
+
+TestSuite _("ForkMessageContextFileStore",
+            {
+                CLASSY_TEST(saveUpdateAndDelete),
+                CLASSY_TEST(reopen),
+                CLASSY_TEST(truncatedRecord),
+                CLASSY_TEST(segmentsReclaimed),
+                CLASSY_TEST(spilledByModuleRouter),
+            });
+} // namespace
+} // namespace flexisip::tester
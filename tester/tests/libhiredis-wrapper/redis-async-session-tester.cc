@@ -7,9 +7,11 @@
 #include <cstddef>
 #include <cstdint>
 #include <exception>
+#include <map>
 #include <memory>
 #include <optional>
 #include <stdexcept>
+#include <string>
 #include <variant>
 #include <vector>
 
@@ -281,6 +283,51 @@ void subscriptionsSession_subscriptionFreedOnUnsubscribe() {
 	BC_ASSERT_CPP_EQUAL(capturedData.use_count(), 1);
 }
 
+/*
+ * Several topics subscribed, then unsubscribed, with a single command each. Every message reaches the subscription of
+ * its own topic.
+ */
+void subscriptionsSession_batchedSubscriptions() {
+	redis::async::Session commandsSession{};
+	redis::async::SubscriptionSession subscriptionsSession{};
+	auto* commands = std::get_if<decltype(commandsSession)::Ready>(&SUITE_SCOPE->connect(commandsSession));
+	BC_HARD_ASSERT(commands != nullptr);
+	auto* subsReady = std::get_if<decltype(subscriptionsSession)::Ready>(&SUITE_SCOPE->connect(subscriptionsSession));
+	BC_HARD_ASSERT(subsReady != nullptr);
+	auto subscriptions = subsReady->subscriptions();
+	const std::vector<std::string> topics{"batched topic 1", "batched topic 2", "batched topic 3"};
+	std::map<std::string, std::string> payloads{};
+	auto subscribedCount = 0;
+
+	subscriptions.subscribe(topics, [&payloads, &subscribedCount](auto topic, redis::async::Reply reply) {
+		const auto array = EXPECT_VARIANT(redis::reply::Array).in(std::move(reply));
+		const auto type = EXPECT_VARIANT(redis::reply::String).in(array[0]);
+		BC_ASSERT_CPP_EQUAL(EXPECT_VARIANT(redis::reply::String).in(array[1]), topic);
+		if (type == "subscribe") {
+			subscribedCount++;
+			return;
+		}
+		if (type != "message") return;
+		payloads[std::string{topic}] = EXPECT_VARIANT(redis::reply::String).in(array[2]);
+	});
+	BC_ASSERT_CPP_EQUAL(subscriptions.size(), topics.size());
+	BC_ASSERT_TRUE(SUITE_SCOPE->asserter.iterateUpTo(
+	    3, [&subscribedCount, &topics]() { return subscribedCount == int(topics.size()); }));
+
+	for (const auto& topic : topics) {
+		commands->command({"PUBLISH", topic, "payload of " + topic}, {});
+	}
+	BC_ASSERT_TRUE(
+	    SUITE_SCOPE->asserter.iterateUpTo(3, [&payloads, &topics]() { return payloads.size() == topics.size(); }));
+	for (const auto& topic : topics) {
+		BC_ASSERT_CPP_EQUAL(payloads[topic], "payload of " + topic);
+	}
+
+	subscriptions.unsubscribe({topics[0], topics[2], "never subscribed"});
+	BC_ASSERT_TRUE(SUITE_SCOPE->asserter.iterateUpTo(3, [&subscriptions]() { return subscriptions.size() == 1; }));
+	BC_ASSERT_TRUE(subscriptions[topics[1]].subscribed());
+}
+
 namespace {
 TestSuite _("redis::async::Context",
             {
@@ -293,6 +340,7 @@ TestSuite _("redis::async::Context",
                 CLASSY_TEST(subscriptionsSession_exceptionInCallback),
                 CLASSY_TEST(subscriptionsSession_autoReSub),
                 CLASSY_TEST(subscriptionsSession_subscriptionFreedOnUnsubscribe),
+                CLASSY_TEST(subscriptionsSession_batchedSubscriptions),
             },
             Hooks()
                 .beforeSuite([]() {
@@ -0,0 +1,133 @@
+/*
+    Flexisip, a flexible SIP proxy server with media capabilities.
+    Copyright (C) 2010-2024 Belledonne Communications SARL, All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "belle-sip/belle-sip.h"
+
+#include "flexisip/event.hh"
+#include "flexisip/sofia-wrapper/msg-sip.hh"
+
+#include "sofia-wrapper/nta-agent.hh"
+#include "utils/bellesip-utils.hh"
+#include "utils/core-assert.hh"
+#include "utils/server/injected-module-info.hh"
+#include "utils/server/proxy-server.hh"
+#include "utils/test-patterns/test.hh"
+#include "utils/test-suite.hh"
+
+using namespace std;
+using namespace std::chrono_literals;
+using namespace sofiasip;
+
+namespace flexisip::tester {
+
+namespace {
+
+/*
+ * Requests are balanced over the routes answering the OPTIONS health checks only, and the "weight" parameter of the
+ * configured routes is not forwarded.
+ */
+void unhealthyRouteIsExcluded() {
+	auto optionsReceived = 0;
+	auto messagesReceived = 0;
+	// Answers 200 to every request.
+	BellesipUtils target{"127.0.0.1", 0, "TCP", [](int) {},
+	                     [&optionsReceived, &messagesReceived](const belle_sip_request_event_t* event) {
+		                     const string method = belle_sip_request_get_method(belle_sip_request_event_get_request(event));
+		                     if (method == "OPTIONS") ++optionsReceived;
+		                     else if (method == "MESSAGE") ++messagesReceived;
+	                     }};
+	const auto targetRoute = "sip:127.0.0.1:" + to_string(target.getListeningPort()) + ";transport=tcp";
+	// Nothing listens on this port: connections are refused, and the route is excluded at its first health check.
+	const auto deadRoute = "sip:127.0.0.1:1;transport=tcp"s;
+
+	vector<string> forwardedRoutes{};
+	InjectedHooks hooks{
+	    .injectAfterModule = "LoadBalancer",
+	    .onRequest =
+	        [&forwardedRoutes](shared_ptr<RequestSipEvent>& ev) {
+		        const auto* route = ev->getMsgSip()->getSip()->sip_route;
+		        forwardedRoutes.emplace_back(route ? url_as_string(ev->getHome(), route->r_url) : "");
+	        },
+	    .requestMethods = {sip_method_message},
+	};
+	Server proxy{
+	    {
+	        {"global/transports", "sip:127.0.0.1:0;transport=tcp"},
+	        {"module::DoSProtection/enabled", "false"},
+	        {"module::LoadBalancer/enabled", "true"},
+	        // Most of the calls would go to the dead route if it was not excluded.
+	        {"module::LoadBalancer/routes", "<" + targetRoute + ";weight=1> <" + deadRoute + ";weight=9>"},
+	        {"module::LoadBalancer/health-check-interval", "1"},
+	    },
+	    &hooks,
+	};
+	proxy.start();
+	CoreAssert asserter{proxy, target};
+
+	// Let both routes be probed at least twice, so that the dead one has answered (locally) by now.
+	asserter.waitUntil(5s, [&optionsReceived] { return optionsReceived >= 2; }).hard_assert_passed();
+
+	NtaAgent client{proxy.getRoot(), "sip:127.0.0.1:0;transport=tcp"};
+	const auto proxyUri = "sip:127.0.0.1:"s + proxy.getFirstPort() + ";transport=tcp";
+	constexpr auto kMessageCount = 10;
+	vector<shared_ptr<NtaOutgoingTransaction>> transactions{};
+	for (auto i = 0; i < kMessageCount; ++i) {
+		ostringstream request{};
+		request << "MESSAGE sip:callee@sip.example.org SIP/2.0\r\n"
+		        << "Via: SIP/2.0/TCP 127.0.0.1\r\n"
+		        << "From: <sip:caller@sip.example.org>;tag=stub-tag\r\n"
+		        << "To: <sip:callee@sip.example.org>\r\n"
+		        << "Call-ID: stub-call-id-" << i << "\r\n"
+		        << "CSeq: 20 MESSAGE\r\n"
+		        << "Content-Type: text/plain\r\n";
+		transactions.push_back(client.createOutgoingTransaction(request.str(), proxyUri));
+	}
+
+	asserter
+	    .waitUntil(5s,
+	               [&transactions] {
+		               for (const auto& transaction : transactions) {
+			               FAIL_IF(!transaction->isCompleted());
+		               }
+		               return ASSERTION_PASSED();
+	               })
+	    .assert_passed();
+	for (const auto& transaction : transactions) {
+		BC_ASSERT_CPP_EQUAL(transaction->getStatus(), 200);
+	}
+	BC_ASSERT_CPP_EQUAL(messagesReceived, kMessageCount);
+	BC_HARD_ASSERT_CPP_EQUAL(forwardedRoutes.size(), kMessageCount);
+	for (const auto& route : forwardedRoutes) {
+		BC_ASSERT_CPP_EQUAL(route, targetRoute);
+	}
+}
+
+TestSuite _("LoadBalancerModule",
+            {
+                CLASSY_TEST(unhealthyRouteIsExcluded),
+            });
+
+} // namespace
+
+} // namespace flexisip::tester
@@ -0,0 +1,91 @@
+/*
+    Flexisip, a flexible SIP proxy server with media capabilities.
+    Copyright (C) 2010-2024 Belledonne Communications SARL, All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <chrono>
+#include <memory>
+
+#include "flexisip/configmanager.hh"
+
+#include "agent.hh"
+#include "utils/client-builder.hh"
+#include "utils/client-call.hh"
+#include "utils/client-core.hh"
+#include "utils/core-assert.hh"
+#include "utils/server/proxy-server.hh"
+#include "utils/test-patterns/test.hh"
+#include "utils/test-suite.hh"
+
+using namespace std;
+using namespace std::chrono_literals;
+
+namespace flexisip::tester {
+namespace {
+
+/*
+ * When all tickers are saturated, new calls are not transcoded, while re-INVITEs of the calls already transcoded still
+ * go through the Transcoder.
+ */
+void saturationOnlyBypassesNewCalls() {
+	Server proxy{{
+	    {"global/transports", "sip:127.0.0.1:0;transport=tcp"},
+	    {"module::Registrar/enabled", "true"},
+	    {"module::Registrar/reg-domains", "sip.example.org"},
+	    {"module::MediaRelay/enabled", "false"},
+	    {"module::Transcoder/enabled", "true"},
+	    {"module::Transcoder/pin-tickers", "false"},
+	}};
+	proxy.start();
+	auto* transcoderConfig = proxy.getConfigManager()->getRoot()->get<GenericStruct>("module::Transcoder");
+	// Incremented each time the Transcoder takes an INVITE in charge.
+	const auto* transcodedInvites = transcoderConfig->getStat("count-calls");
+
+	ClientBuilder builder{*proxy.getAgent()};
+	const auto caller = builder.build("sip:caller@sip.example.org");
+	const auto callee = builder.build("sip:callee@sip.example.org");
+	const auto otherCaller = builder.build("sip:other-caller@sip.example.org");
+	const auto otherCallee = builder.build("sip:other-callee@sip.example.org");
+	CoreAssert asserter{caller, proxy, callee, otherCaller, otherCallee};
+
+	BC_HARD_ASSERT(caller.call(callee) != nullptr);
+	BC_ASSERT_CPP_EQUAL(transcodedInvites->read(), 1u);
+
+	// Saturate the tickers: every ticker is at least as loaded as the new limit.
+	transcoderConfig->get<ConfigInt>("max-ticker-load")->set("0");
+	proxy.getAgent()->findModule("Transcoder")->reload();
+
+	const auto callerCall = caller.getCurrentCall();
+	BC_HARD_ASSERT(callerCall.has_value());
+	callerCall->update([](auto&& params) { return std::move(params); });
+	asserter
+	    .wait([&callerCall] {
+		    return LOOP_ASSERTION(callerCall->getState() == linphone::Call::State::StreamsRunning);
+	    })
+	    .assert_passed();
+	BC_ASSERT_CPP_EQUAL(transcodedInvites->read(), 2u);
+
+	BC_HARD_ASSERT(otherCaller.call(otherCallee) != nullptr);
+	BC_ASSERT_CPP_EQUAL(transcodedInvites->read(), 2u);
+}
+
+TestSuite _("Transcoder",
+            {
+                CLASSY_TEST(saturationOnlyBypassesNewCalls),
+            });
+
+} // namespace
+} // namespace flexisip::tester
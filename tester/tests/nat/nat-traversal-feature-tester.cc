@@ -198,7 +198,7 @@ void registerUser() {
 		void onContactUpdated(const std::shared_ptr<ExtendedContact>&) override {
 		}
 		void onRecordFound(const std::shared_ptr<Record>& r) override {
-			mPath = r->getExtendedContacts().latest()->get()->mPath.front();
+			mPath = r->getExtendedContacts().latest()->get()->getPath().front();
 		};
 		void onError(const SipStatus&) override {
 		}
@@ -0,0 +1,191 @@
+/*
+    Flexisip, a flexible SIP proxy server with media capabilities.
+    Copyright (C) 2010-2024 Belledonne Communications SARL, All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <belle-sip/belle-sip.h>
+#include <belle-sip/bodyhandler.h>
+
+#include "presence/presence-server.hh"
+#include "presence/presentity/presentity-manager.hh"
+#include "presence/presentity/presentity-presence-information.hh"
+#include "presence/subscription/list-subscription.hh"
+#include "xml/pidf+xml.hh"
+
+#include "utils/bellesip-utils.hh"
+#include "utils/test-patterns/test.hh"
+#include "utils/test-suite.hh"
+
+using namespace std;
+
+namespace flexisip::tester {
+namespace {
+
+const string kEntity = "sip:user@sip.example.org";
+
+// Instance part (Content-Id and pidf document) of a rlmi NOTIFY.
+struct NotifiedPart {
+	string cid;
+	string pidf;
+};
+
+/*
+ * List subscription keeping the pidf parts of the NOTIFYs it builds instead of sending them.
+ */
+class NotifyCaptureListSubscription : public ListSubscription {
+public:
+	NotifyCaptureListSubscription(belle_sip_server_transaction_t* ist,
+	                              belle_sip_provider_t* provider,
+	                              const shared_ptr<StatPair>& stats)
+	    : ListSubscription(3600, ist, provider, 10, stats, [](const auto&) {}) {
+		mName = bellesip::shared_ptr<const belle_sip_uri_t>{belle_sip_uri_parse("sip:rls@sip.example.org")};
+	}
+
+	shared_ptr<PresentityPresenceInformationListener> addResource(const string& uri) {
+		auto* presentity = belle_sip_uri_parse(uri.c_str());
+		belle_sip_object_ref(presentity);
+		mListeners.push_back(make_shared<PresentityResourceListener>(*this, presentity));
+		belle_sip_object_unref(presentity);
+		return mListeners.back();
+	}
+
+	vector<NotifiedPart> mLastNotifiedParts{};
+
+protected:
+	void sendNotify(belle_sip_multipart_body_handler_t* body) override {
+		belle_sip_object_ref(body);
+		mLastNotifiedParts.clear();
+		// The first part is the rlmi document, followed by one pidf document per instance.
+		const auto* parts = belle_sip_multipart_body_handler_get_parts(body);
+		for (parts = parts ? parts->next : nullptr; parts != nullptr; parts = parts->next) {
+			auto* part = static_cast<belle_sip_body_handler_t*>(parts->data);
+			NotifiedPart notified{};
+			for (const auto* headers = belle_sip_body_handler_get_headers(part); headers; headers = headers->next) {
+				auto* header = static_cast<belle_sip_header_t*>(headers->data);
+				if (string{belle_sip_header_get_name(header)} == "Content-Id") {
+					notified.cid = belle_sip_header_get_unparsed_value(header);
+				}
+			}
+			notified.pidf.assign(
+			    static_cast<const char*>(belle_sip_memory_body_handler_get_buffer(BELLE_SIP_MEMORY_BODY_HANDLER(part))),
+			    belle_sip_body_handler_get_size(part));
+			mLastNotifiedParts.push_back(std::move(notified));
+		}
+		belle_sip_object_unref(body);
+	}
+};
+
+string publish(PresentityManager& manager, const string& tupleId) {
+	istringstream pidf{R"xml(<?xml version="1.0" encoding="UTF-8"?>
+<presence xmlns="urn:ietf:params:xml:ns:pidf" entity=")xml" +
+	                   kEntity + R"xml(">
+ <tuple id=")xml" + tupleId +
+	                   R"xml(">
+  <status>
+   <basic>open</basic>
+  </status>
+ </tuple>
+</presence>)xml"};
+	auto* entity = belle_sip_uri_parse(kEntity.c_str());
+	belle_sip_object_ref(entity);
+	auto eTag =
+	    manager.handlePublishFor(entity, "", Xsd::Pidf::parsePresence(pidf, Xsd::XmlSchema::Flags::dont_validate), 3600);
+	belle_sip_object_unref(entity);
+	return eTag;
+}
+
+/*
+ * Full state NOTIFYs reuse the body part of presentities that did not change since the last NOTIFY, serialize again
+ * the presentities that changed (pending states) and the ones for which the listener switched to extended
+ * notifications.
+ */
+void fullStateReusesCachedBodyParts() {
+	BellesipUtils utils{"127.0.0.1", 0, "tcp", [](int) {}, [](const belle_sip_request_event_t*) {}};
+	auto statsCounter = make_unique<StatCounter64>("stub-name", "stub-help", 0xdead);
+	auto stats = make_shared<StatPair>(statsCounter.get(), statsCounter.get());
+	const PresenceStats presenceStats{stats, stats, stats, stats, stats, stats};
+	PresentityManager presentityManager{belle_sip_provider_get_sip_stack(utils.getProvider()), presenceStats, 10};
+
+	ostringstream rawRequest{};
+	rawRequest << "SUBSCRIBE sip:rls@sip.example.org SIP/2.0\r\n"
+	           << "Via: SIP/2.0/TCP 127.0.0.1:1234;branch=" BELLE_SIP_BRANCH_MAGIC_COOKIE ".stub-branch\r\n"
+	           << "Max-Forwards: 70\r\n"
+	           << "From: <sip:watcher@sip.example.org>;tag=stub-from-tag\r\n"
+	           << "To: <sip:rls@sip.example.org>\r\n"
+	           << "Call-ID: stub-call-id\r\n"
+	           << "CSeq: 20 SUBSCRIBE\r\n"
+	           << "Event: presence\r\n"
+	           << "Expires: 3600\r\n"
+	           << "Content-Length: 0\r\n\r\n";
+	auto* request = BELLE_SIP_REQUEST(belle_sip_message_parse(rawRequest.str().c_str()));
+	auto* transaction = belle_sip_provider_create_server_transaction(utils.getProvider(), request);
+	auto subscription = make_shared<NotifyCaptureListSubscription>(transaction, utils.getProvider(), stats);
+	auto listener = subscription->addResource(kEntity);
+
+	publish(presentityManager, "first-tuple");
+	auto* entity = belle_sip_uri_parse(kEntity.c_str());
+	belle_sip_object_ref(entity);
+	auto presentity = presentityManager.getPresenceInfo(entity);
+	belle_sip_object_unref(entity);
+	BC_HARD_ASSERT(presentity != nullptr);
+
+	// First NOTIFY: the pending state is serialized, without the published tuples as notifications are not extended.
+	listener->onInformationChanged(*presentity, listener->extendedNotifyEnabled());
+	subscription->notify(true);
+	BC_HARD_ASSERT_CPP_EQUAL(subscription->mLastNotifiedParts.size(), 1);
+	const auto firstPart = subscription->mLastNotifiedParts.front();
+	BC_ASSERT(firstPart.pidf.find("first-tuple") == string::npos);
+
+	// Nothing changed: the very same body part is sent again.
+	subscription->notify(true);
+	BC_HARD_ASSERT_CPP_EQUAL(subscription->mLastNotifiedParts.size(), 1);
+	BC_ASSERT_CPP_EQUAL(subscription->mLastNotifiedParts.front().cid, firstPart.cid);
+	BC_ASSERT_CPP_EQUAL(subscription->mLastNotifiedParts.front().pidf, firstPart.pidf);
+
+	// The listener now accepts extended notifications: the cached body part does not fit anymore.
+	listener->enableExtendedNotify(true);
+	subscription->notify(true);
+	BC_HARD_ASSERT_CPP_EQUAL(subscription->mLastNotifiedParts.size(), 1);
+	const auto extendedPart = subscription->mLastNotifiedParts.front();
+	BC_ASSERT_CPP_EQUAL(extendedPart.cid, firstPart.cid);
+	BC_ASSERT(extendedPart.pidf.find("first-tuple") != string::npos);
+
+	// The presentity changes: its pending state is serialized again.
+	publish(presentityManager, "second-tuple");
+	listener->onInformationChanged(*presentity, listener->extendedNotifyEnabled());
+	subscription->notify(true);
+	BC_HARD_ASSERT_CPP_EQUAL(subscription->mLastNotifiedParts.size(), 1);
+	BC_ASSERT(subscription->mLastNotifiedParts.front().pidf.find("second-tuple") != string::npos);
+	BC_ASSERT(subscription->mLastNotifiedParts.front().pidf != extendedPart.pidf);
+
+	// Partial state NOTIFYs only contain the pending states.
+	subscription->notify(false);
+	BC_ASSERT_CPP_EQUAL(subscription->mLastNotifiedParts.size(), 0);
+
+	belle_sip_transaction_terminate(BELLE_SIP_TRANSACTION(transaction));
+}
+
+const TestSuite _("ListSubscription",
+                  {
+                      CLASSY_TEST(fullStateReusesCachedBodyParts),
+                  });
+
+} // namespace
+} // namespace flexisip::tester
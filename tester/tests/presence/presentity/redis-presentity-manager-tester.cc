@@ -0,0 +1,255 @@
+/*
+    Flexisip, a flexible SIP proxy server with media capabilities.
+    Copyright (C) 2010-2024 Belledonne Communications SARL, All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "presence/presentity/redis-presentity-manager.hh"
+
+#include <chrono>
+#include <sstream>
+#include <string>
+
+#include <belle-sip/belle-sip.h>
+
+#include "presence/presence-server.hh"
+#include "presence/presentity/presentity-presence-information-listener.hh"
+#include "presence/presentity/presentity-presence-information.hh"
+#include "xml/pidf+xml.hh"
+
+#include "utils/bellesip-utils.hh"
+#include "utils/core-assert.hh"
+#include "utils/redis-sync-access.hh"
+#include "utils/server/redis-server.hh"
+#include "utils/test-patterns/test.hh"
+#include "utils/test-suite.hh"
+
+using namespace std;
+using namespace std::chrono_literals;
+
+namespace flexisip::tester {
+namespace {
+
+using namespace redis::async;
+
+const string kEntity = "sip:user@sip.example.org";
+const string kWatcher = "sip:watcher@sip.example.org";
+
+/*
+ * Subscriber to a presentity, keeping the last pidf document it was notified with.
+ */
+class StubListener : public PresentityPresenceInformationListener {
+public:
+	StubListener()
+	    : mPresentity(belle_sip_uri_parse(kEntity.c_str())), mWatcher(belle_sip_uri_parse(kWatcher.c_str())) {
+		enableExtendedNotify(true);
+	}
+
+	const belle_sip_uri_t* getPresentityUri() const override {
+		return mPresentity.get();
+	}
+	void onInformationChanged(PresentityPresenceInformation& presenceInformation, bool) override {
+		mLastPidf = presenceInformation.getPidf(true);
+	}
+	void onExpired(PresentityPresenceInformation&) override {
+	}
+	const belle_sip_uri_t* getFrom() override {
+		return mWatcher.get();
+	}
+	const belle_sip_uri_t* getTo() override {
+		return mWatcher.get();
+	}
+
+	bool notifiedWith(const string& tupleId) const {
+		return mLastPidf.find(tupleId) != string::npos;
+	}
+
+private:
+	bellesip::shared_ptr<belle_sip_uri_t> mPresentity;
+	bellesip::shared_ptr<belle_sip_uri_t> mWatcher;
+	string mLastPidf{};
+};
+
+/*
+ * Two presence servers sharing presentities through the same Redis server. Only the second one has a subscriber to
+ * the presentity.
+ */
+class RedisPresentityManagerTest : public Test {
+public:
+	RedisPresentityManagerTest()
+	    : mStatsCounter(make_unique<StatCounter64>("stub-name", "stub-help", 0xdead)),
+	      mStats(make_shared<StatPair>(mStatsCounter.get(), mStatsCounter.get())),
+	      mPresenceStats{mStats, mStats, mStats, mStats, mStats, mStats},
+	      mPublisher(mRoot,
+	                 belle_sip_provider_get_sip_stack(mPublisherStack.getProvider()),
+	                 mPresenceStats,
+	                 10,
+	                 RedisParameters{.domain = "127.0.0.1", .port = mRedis.port()}),
+	      mSubscriber(mRoot,
+	                  belle_sip_provider_get_sip_stack(mSubscriberStack.getProvider()),
+	                  mPresenceStats,
+	                  10,
+	                  RedisParameters{.domain = "127.0.0.1", .port = mRedis.port()}) {
+	}
+
+	void operator()() override {
+		auto asserter = CoreAssert(mRoot, mPublisherStack, mSubscriberStack);
+		// Wait for both presence servers to listen to presentity updates.
+		asserter
+		    .iterateUpTo(
+		        0x20,
+		        [this] {
+			        const auto& reply = mRedisCtx.command("PUBSUB NUMSUB %s", RedisPresentityManager::kChannel.data());
+			        FAIL_IF(reply->type != REDIS_REPLY_ARRAY || reply->elements != 2);
+			        FAIL_IF(reply->element[1]->integer != 2);
+			        return ASSERTION_PASSED();
+		        },
+		        2s)
+		    .hard_assert_passed();
+
+		shared_ptr<PresentityPresenceInformationListener> listener = mListener;
+		mSubscriber.addOrUpdateListener(listener, 3600);
+		testWith(asserter);
+	}
+
+protected:
+	virtual void testWith(CoreAssert<>& asserter) = 0;
+
+	string publish(PresentityManager& manager, const string& tupleId, int expires) {
+		istringstream pidf{R"xml(<?xml version="1.0" encoding="UTF-8"?>
+<presence xmlns="urn:ietf:params:xml:ns:pidf" entity=")xml" +
+		                   kEntity + R"xml(">
+ <tuple id=")xml" + tupleId +
+		                   R"xml(">
+  <status>
+   <basic>open</basic>
+  </status>
+ </tuple>
+</presence>)xml"};
+		const bellesip::shared_ptr<belle_sip_uri_t> entity{belle_sip_uri_parse(kEntity.c_str())};
+		return manager.handlePublishFor(entity.get(), "",
+		                                Xsd::Pidf::parsePresence(pidf, Xsd::XmlSchema::Flags::dont_validate), expires);
+	}
+
+	bool isStored(const string& eTag) {
+		const auto& reply = mRedisCtx.command("HEXISTS %s %s", key().c_str(), eTag.c_str());
+		return reply->type == REDIS_REPLY_INTEGER && reply->integer == 1;
+	}
+
+	static string key() {
+		return string{RedisPresentityManager::kKeyPrefix} + kEntity;
+	}
+
+	RedisServer mRedis{};
+	RedisSyncContext mRedisCtx{redisConnect("127.0.0.1", mRedis.port())};
+	sofiasip::SuRoot mRoot{};
+	BellesipUtils mPublisherStack{"127.0.0.1", 0, "tcp", [](int) {}, [](const belle_sip_request_event_t*) {}};
+	BellesipUtils mSubscriberStack{"127.0.0.1", 0, "tcp", [](int) {}, [](const belle_sip_request_event_t*) {}};
+	unique_ptr<StatCounter64> mStatsCounter;
+	shared_ptr<StatPair> mStats;
+	PresenceStats mPresenceStats;
+	RedisPresentityManager mPublisher;
+	RedisPresentityManager mSubscriber;
+	shared_ptr<StubListener> mListener = make_shared<StubListener>();
+};
+
+/*
+ * A publication made through a presence server is notified to the subscribers of another one.
+ */
+class PublishSeenByOtherInstance : public RedisPresentityManagerTest {
+	void testWith(CoreAssert<>& asserter) override {
+		const auto eTag = publish(mPublisher, "published-tuple", 3600);
+
+		asserter.wait([this] { return mListener->notifiedWith("published-tuple"); }).assert_passed();
+		BC_ASSERT(isStored(eTag));
+	}
+};
+
+/*
+ * A publication can be refreshed through another presence server than the one it was made through: the stored
+ * publication is moved to the new eTag.
+ */
+class RefreshThroughOtherInstance : public RedisPresentityManagerTest {
+	void testWith(CoreAssert<>& asserter) override {
+		const auto eTag = publish(mPublisher, "published-tuple", 3600);
+		asserter.wait([this] { return mListener->notifiedWith("published-tuple"); }).hard_assert_passed();
+
+		const auto newEtag = mSubscriber.handlePublishRefreshedFor(eTag, 3600);
+
+		BC_ASSERT(newEtag != eTag);
+		asserter.wait([this, &eTag, &newEtag] { return isStored(newEtag) && !isStored(eTag); }).assert_passed();
+		BC_ASSERT(mListener->notifiedWith("published-tuple"));
+	}
+};
+
+/*
+ * An expired publication is removed from Redis and from the subscribers of other presence servers.
+ */
+class ExpiredPublication : public RedisPresentityManagerTest {
+	void testWith(CoreAssert<>& asserter) override {
+		const auto eTag = publish(mPublisher, "short-lived-tuple", 2);
+		asserter.wait([this] { return mListener->notifiedWith("short-lived-tuple"); }).hard_assert_passed();
+
+		asserter
+		    .waitUntil(5s, [this, &eTag] { return !mListener->notifiedWith("short-lived-tuple") && !isStored(eTag); })
+		    .assert_passed();
+	}
+};
+
+/*
+ * A publication removed (PUBLISH with Expires: 0) through a presence server is removed from the subscribers of
+ * other presence servers.
+ */
+class RemoteRemoval : public RedisPresentityManagerTest {
+	void testWith(CoreAssert<>& asserter) override {
+		const auto eTag = publish(mPublisher, "removed-tuple", 3600);
+		asserter.wait([this] { return mListener->notifiedWith("removed-tuple"); }).hard_assert_passed();
+
+		mPublisher.handlePublishRefreshedFor(eTag, 0);
+
+		asserter.wait([this] { return !mListener->notifiedWith("removed-tuple"); }).assert_passed();
+		BC_ASSERT(!isStored(eTag));
+	}
+};
+
+/*
+ * The presentity hash expires with its latest publication, and publications left expired in it (e.g. by a presence
+ * server that went away) are removed when it is reloaded.
+ */
+class StoredPublicationsExpire : public RedisPresentityManagerTest {
+	void testWith(CoreAssert<>& asserter) override {
+		mRedisCtx.command("HSET %s stale-etag %s", key().c_str(), "1 <presence/>");
+		publish(mPublisher, "long-lived-tuple", 3600);
+		publish(mPublisher, "short-lived-tuple", 60);
+		asserter.wait([this] { return mListener->notifiedWith("short-lived-tuple"); }).hard_assert_passed();
+
+		asserter.wait([this] { return !isStored("stale-etag"); }).assert_passed();
+		const auto& ttl = mRedisCtx.command("TTL %s", key().c_str());
+		BC_HARD_ASSERT_CPP_EQUAL(ttl->type, REDIS_REPLY_INTEGER);
+		BC_ASSERT(3540 < ttl->integer && ttl->integer <= 3600);
+	}
+};
+
+TestSuite _("RedisPresentityManager",
+            {
+                CLASSY_TEST(PublishSeenByOtherInstance),
+                CLASSY_TEST(RefreshThroughOtherInstance),
+                CLASSY_TEST(ExpiredPublication),
+                CLASSY_TEST(RemoteRemoval),
+                CLASSY_TEST(StoredPublicationsExpire),
+            });
+
+} // namespace
+} // namespace flexisip::tester
@@ -16,6 +16,9 @@
     along with this program. If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <string>
+#include <vector>
+
 #include "flexisip/configmanager.hh"
 #include "flexisip/sofia-wrapper/su-root.hh"
 
@@ -69,9 +72,43 @@ static void qValueConstructorTests(void) {
 	                      msgExpiresName, -0.001, 0.0);
 }
 
+/*
+ * Path, Accept and User-Agent are kept serialized in the contact URL until accessed: check they survive a round-trip
+ * through the serialized form, including when the deserialized contact is copied or serialized again before parsing.
+ */
+static void lazyHeadersRoundTrip() {
+	const string msgExpiresName = "message-expires";
+	sofiasip::Home home{};
+	const auto* sipContact = sip_contact_make(home.home(), "<sip:kijou@192.0.2.1:4242;transport=tcp>");
+	const ExtendedContactCommon common{{"sip:edge.example.org;lr", "sip:core.example.org"}, "call-id", "unique-id"};
+	ExtendedContact original{common,
+	                         sipContact,
+	                         3600,
+	                         7,
+	                         getCurrentTime(),
+	                         false,
+	                         {"application/sdp", "text/plain"},
+	                         "Linphone (Ubuntu)",
+	                         msgExpiresName};
+	const auto serialized = original.serializeAsUrlEncodedParams();
+
+	ExtendedContact parsed{"unique-id", serialized.c_str(), msgExpiresName};
+	ExtendedContact copy{parsed};
+	BC_ASSERT_CPP_EQUAL(parsed.serializeAsUrlEncodedParams(), serialized);
+
+	for (const auto* contact : {&parsed, &copy}) {
+		BC_ASSERT_TRUE(contact->getPath() == (vector<string>{"sip:edge.example.org;lr", "sip:core.example.org"}));
+		BC_ASSERT_TRUE(contact->getAcceptHeaders() == (vector<string>{"application/sdp", "text/plain"}));
+		BC_ASSERT_CPP_EQUAL(contact->getUserAgent(), "Linphone (Ubuntu)");
+		BC_ASSERT_CPP_EQUAL(contact->getDeviceName().asString(), "Ubuntu");
+		BC_ASSERT_CPP_EQUAL(contact->mCSeq, 7);
+	}
+}
+
 namespace {
 TestSuite _("Extended contact",
             {
                 TEST_NO_TAG("ExtendedContact constructor with qValue tests", qValueConstructorTests),
+                TEST_NO_TAG("Path, Accept and User-Agent are parsed on demand", lazyHeadersRoundTrip),
             });
 }
@@ -19,6 +19,8 @@
 #include <chrono>
 #include <memory>
 #include <optional>
+#include <set>
+#include <string>
 
 #include <sys/resource.h>
 
@@ -339,6 +341,64 @@ void no_perm_to_subscribe() {
 	BC_ASSERT_CPP_EQUAL(*actualTopic, topic);
 }
 
+/**
+ * Registrar subscriptions are resumed when the connection to Redis is lost and established again, including those sent
+ * right before the connection broke and never acknowledged.
+ */
+void subscriptions_resumed_after_reconnection() {
+	auto& registrar = SUITE_SCOPE->proxyServer.getAgent()->getRegistrarDb();
+	const auto* registrarBackend = dynamic_cast<const RegistrarDbRedisAsync*>(&registrar.getRegistrarBackend());
+	BC_HARD_ASSERT(registrarBackend != nullptr);
+	const Record::Key acknowledgedTopic{SipUri("sip:acknowledged@example.org"), registrar.useGlobalDomain()};
+	const Record::Key freshTopic{SipUri("sip:fresh@example.org"), registrar.useGlobalDomain()};
+	std::set<std::string> notifiedTopics{};
+	const auto listener = std::make_shared<ContactRegisteredCallback>(
+	    [&notifiedTopics](const std::shared_ptr<Record>& record, const auto&) {
+		    notifiedTopics.insert(record->getKey().asString());
+	    });
+	const auto isSubscribed = [&registrarBackend](const Record::Key& topic) {
+		const auto* subSession = registrarBackend->getRedisClient().getSubSessionIfReady();
+		if (!subSession) return false;
+		const auto entry = subSession->subscriptions()[topic.asString()];
+		return entry.subscribed() && !entry.isFresh();
+	};
+
+	registrar.subscribe(acknowledgedTopic, listener);
+	BC_HARD_ASSERT(SUITE_SCOPE->asserter.iterateUpTo(
+	    10, [&isSubscribed, &acknowledgedTopic] { return isSubscribed(acknowledgedTopic); }, 50ms));
+	// Send the SUBSCRIBE but break the connection before Redis answers it.
+	registrar.subscribe(freshTopic, listener);
+	SUITE_SCOPE->proxyServer.getRoot()->step(1ms);
+	SUITE_SCOPE->redis.restart();
+
+	BC_ASSERT_TRUE(
+	    SUITE_SCOPE->asserter.iterateUpTo(10, [&registrarBackend] { return !registrarBackend->isConnected(); }));
+	// Wait for the server to be up again
+	auto ctx = RedisSyncContext(redisConnect("localhost", SUITE_SCOPE->redis.port()));
+	const auto publish = [&ctx](const Record::Key& topic) {
+		const auto reply = ctx.command("PUBLISH %s 'stub-payload'", topic.asString().c_str());
+		BC_HARD_ASSERT_CPP_EQUAL(reply->type, REDIS_REPLY_INTEGER);
+		return reply->integer;
+	};
+	SUITE_SCOPE->asserter
+	    .waitUntil(5s,
+	               [&publish, &acknowledgedTopic, &freshTopic] {
+		               FAIL_IF(publish(acknowledgedTopic) == 0);
+		               FAIL_IF(publish(freshTopic) == 0);
+		               return ASSERTION_PASSED();
+	               })
+	    .assert_passed();
+	SUITE_SCOPE->asserter
+	    .iterateUpTo(
+	        1, [&notifiedTopics] { return LOOP_ASSERTION(notifiedTopics.size() == 2); }, 100ms)
+	    .assert_passed();
+	BC_ASSERT_CPP_EQUAL(notifiedTopics.count(acknowledgedTopic.asString()), 1);
+	BC_ASSERT_CPP_EQUAL(notifiedTopics.count(freshTopic.asString()), 1);
+
+	registrar.unsubscribe(acknowledgedTopic, listener);
+	registrar.unsubscribe(freshTopic, listener);
+}
+
 TestSuite main("RegistrarDbRedis",
                {
                    CLASSY_TEST(mContext_should_be_checked_on_serializeAndSendToRedis),
@@ -347,6 +407,7 @@ TestSuite main("RegistrarDbRedis",
                    CLASSY_TEST(subscribe_to_key_expiration),
                    CLASSY_TEST(periodic_replication_check),
                    CLASSY_TEST(no_perm_to_subscribe),
+                   CLASSY_TEST(subscriptions_resumed_after_reconnection),
                },
                Hooks()
                    .beforeSuite([]() {
@@ -22,6 +22,10 @@
 #include <sstream>
 #include <string>
 #include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "bctoolbox/tester.h"
 
@@ -29,6 +33,7 @@
 #include "flexisip/registrar/registar-listeners.hh"
 #include "flexisip/utils/sip-uri.hh"
 
+#include "registrar/binding-parameters.hh"
 #include "registrar/extended-contact.hh"
 #include "registrar/record.hh"
 #include "registrar/registrar-db.hh"
@@ -160,6 +165,167 @@ class TestFetchExpiringContacts : public RegistrarDbTest<TDatabase> {
 	}
 };
 
+template <DbImplementation TDatabase>
+class TestFetchList : public RegistrarDbTest<TDatabase> {
+	class Listener : public ListContactUpdateListener {
+	public:
+		void onContactsUpdated() override {
+			calls++;
+		}
+		int calls = 0;
+	};
+
+	void testExec() noexcept override {
+		auto& regDb = this->getRegistrarDb();
+		ContactInserter inserter(regDb);
+		inserter.withUniqueId(true);
+		inserter.setExpire(100s).setAor("sip:alice@te.st").insert({"sip:alice@127.0.0.1:5060"});
+		inserter.setAor("sip:bob@te.st").insert({"sip:bob@127.0.0.1:5060"}).insert({"sip:bob@127.0.0.1:5061"});
+		inserter.setExpire(1s).setAor("sip:expired@te.st").insert({"sip:expired@127.0.0.1:5060"});
+		BC_ASSERT_TRUE(this->waitFor([&inserter] { return inserter.finished(); }, 1s));
+		// Let the last contact expire
+		this->waitFor([] { return false; }, 2s);
+
+		// Cold loading script
+		auto listener = make_shared<Listener>();
+		regDb.fetchList({SipUri("sip:alice@te.st"), SipUri("sip:unknown@te.st"), SipUri("sip:bob@te.st"),
+		                 SipUri("sip:expired@te.st")},
+		                listener);
+		BC_ASSERT_TRUE(this->waitFor([&listener] { return listener->calls != 0; }, 1s));
+		BC_ASSERT_CPP_EQUAL(listener->calls, 1);
+		BC_HARD_ASSERT_CPP_EQUAL(listener->records.size(), 2);
+		unordered_map<string, size_t> contactsByAor{};
+		for (const auto& record : listener->records) {
+			contactsByAor[record->getKey().toString()] = record->getExtendedContacts().size();
+		}
+		BC_ASSERT_CPP_EQUAL(contactsByAor["alice@te.st"], 1);
+		BC_ASSERT_CPP_EQUAL(contactsByAor["bob@te.st"], 2);
+
+		// Script should be hot
+		listener = make_shared<Listener>();
+		regDb.fetchList({SipUri("sip:bob@te.st")}, listener);
+		BC_ASSERT_TRUE(this->waitFor([&listener] { return listener->calls != 0; }, 1s));
+		BC_ASSERT_CPP_EQUAL(listener->records.size(), 1);
+
+		// An empty list must not leave the listener hanging
+		listener = make_shared<Listener>();
+		regDb.fetchList({}, listener);
+		BC_ASSERT_TRUE(this->waitFor([&listener] { return listener->calls != 0; }, 1s));
+		BC_ASSERT_CPP_EQUAL(listener->records.size(), 0);
+	}
+};
+
+template <DbImplementation TDatabase>
+class TestFetchWithAliases : public RegistrarDbTest<TDatabase> {
+	class Listener : public ContactUpdateListener {
+	public:
+		void onRecordFound(const shared_ptr<Record>& r) override {
+			calls++;
+			record = r;
+		}
+		void onError(const SipStatus&) override {
+			BC_FAIL("This test doesn't expect an error response on fetch");
+		}
+		void onInvalid(const SipStatus&) override {
+			BC_FAIL("This test doesn't expect an invalid response on fetch");
+		}
+		void onContactUpdated(const shared_ptr<ExtendedContact>&) override {
+		}
+
+		int calls = 0;
+		shared_ptr<Record> record{};
+	};
+
+	void testExec() noexcept override {
+		auto& regDb = this->getRegistrarDb();
+		ContactInserter inserter(regDb);
+		inserter.withUniqueId(true).setExpire(100s);
+		inserter.setAor("sip:bob@te.st").insert({"sip:bob@127.0.0.1:5060"}).insert({"sip:bob@127.0.0.1:5061"});
+		inserter.setAlias(true).setAor("sip:+33612345678@te.st").insert({"sip:bob@te.st"});
+		inserter.setAor("sip:unknown-alias@te.st").insert({"sip:unknown@te.st"});
+		BC_ASSERT_TRUE(this->waitFor([&inserter] { return inserter.finished(); }, 1s));
+
+		// Cold loading script
+		auto listener = make_shared<Listener>();
+		regDb.fetch(SipUri("sip:+33612345678@te.st"), listener, true);
+		BC_ASSERT_TRUE(this->waitFor([&listener] { return listener->calls != 0; }, 1s));
+		// Let a duplicated answer come in, if any
+		this->waitFor([] { return false; }, 100ms);
+		BC_ASSERT_CPP_EQUAL(listener->calls, 1);
+		BC_HARD_ASSERT(listener->record != nullptr);
+		unordered_set<string> contacts{};
+		for (const auto& contact : listener->record->getExtendedContacts()) {
+			contacts.insert(contact->urlAsString());
+		}
+		BC_ASSERT_CPP_EQUAL(contacts.size(), 3);
+		BC_ASSERT_TRUE(contacts.count("sip:bob@te.st") == 1);
+		BC_ASSERT_TRUE(contacts.count("sip:bob@127.0.0.1:5060") == 1);
+		BC_ASSERT_TRUE(contacts.count("sip:bob@127.0.0.1:5061") == 1);
+
+		// Script should be hot. The alias leads nowhere, only the alias itself is returned.
+		listener = make_shared<Listener>();
+		regDb.fetch(SipUri("sip:unknown-alias@te.st"), listener, true);
+		BC_ASSERT_TRUE(this->waitFor([&listener] { return listener->calls != 0; }, 1s));
+		BC_HARD_ASSERT(listener->record != nullptr);
+		BC_ASSERT_CPP_EQUAL(listener->record->getExtendedContacts().size(), 1);
+	}
+};
+
+template <DbImplementation TDatabase>
+class TestBindMany : public RegistrarDbTest<TDatabase> {
+	class BindListener : public ContactUpdateListener {
+	public:
+		void onRecordFound(const shared_ptr<Record>& r) override {
+			if (r != nullptr && r->getExtendedContacts().size() == 1) bound++;
+		}
+		void onError(const SipStatus&) override {
+			BC_FAIL("This test doesn't expect an error response on bind");
+		}
+		void onInvalid(const SipStatus&) override {
+			BC_FAIL("This test doesn't expect an invalid response on bind");
+		}
+		void onContactUpdated(const shared_ptr<ExtendedContact>&) override {
+		}
+
+		size_t bound = 0;
+	};
+	class FetchListener : public ListContactUpdateListener {
+	public:
+		void onContactsUpdated() override {
+			done = true;
+		}
+		bool done = false;
+	};
+
+	void testExec() noexcept override {
+		// More than a few batches
+		constexpr size_t bindingCount = 1234;
+		auto& regDb = this->getRegistrarDb();
+		sofiasip::Home home{};
+		const auto* contact = sip_contact_make(home.home(), "<sip:chatroom@127.0.0.1:6064;transport=tcp>");
+		BC_HARD_ASSERT(contact != nullptr);
+		vector<pair<SipUri, const sip_contact_t*>> bindings{};
+		vector<SipUri> aors{};
+		for (size_t i = 0; i < bindingCount; i++) {
+			aors.emplace_back("sip:chatroom-" + to_string(i) + "@te.st");
+			bindings.emplace_back(aors.back(), contact);
+		}
+		BindingParameters parameters{};
+		parameters.callId = "bind-many";
+		parameters.globalExpire = 100;
+
+		auto bindListener = make_shared<BindListener>();
+		regDb.bindMany(bindings, parameters, bindListener);
+		BC_ASSERT_TRUE(this->waitFor([&bindListener] { return bindListener->bound == bindingCount; }, 5s));
+		BC_ASSERT_CPP_EQUAL(bindListener->bound, bindingCount);
+
+		auto fetchListener = make_shared<FetchListener>();
+		regDb.fetchList(aors, fetchListener);
+		BC_ASSERT_TRUE(this->waitFor([&fetchListener] { return fetchListener->done; }, 1s));
+		BC_ASSERT_CPP_EQUAL(fetchListener->records.size(), bindingCount);
+	}
+};
+
 namespace {
 template <typename TDatabase>
 void MaxContactsByAorIsHonored(TDatabase& dbImpl, const SipUri& aor) {
@@ -776,6 +942,12 @@ TestSuite _(
         TEST_NO_TAG("Fetch expiring contacts on Redis", run<TestFetchExpiringContacts<DbImplementation::Redis>>),
         TEST_NO_TAG("Fetch expiring contacts in Internal DB",
                     run<TestFetchExpiringContacts<DbImplementation::Internal>>),
+        TEST_NO_TAG("Fetch a list of records on Redis", run<TestFetchList<DbImplementation::Redis>>),
+        TEST_NO_TAG("Fetch a list of records in Internal DB", run<TestFetchList<DbImplementation::Internal>>),
+        TEST_NO_TAG("Resolve aliases on Redis", run<TestFetchWithAliases<DbImplementation::Redis>>),
+        TEST_NO_TAG("Resolve aliases in Internal DB", run<TestFetchWithAliases<DbImplementation::Internal>>),
+        TEST_NO_TAG("Bind many records on Redis", run<TestBindMany<DbImplementation::Redis>>),
+        TEST_NO_TAG("Bind many records in Internal DB", run<TestBindMany<DbImplementation::Internal>>),
         TEST_NO_TAG("An AOR cannot contain more than max-contacts-by-aor [Internal]",
                     run<InternalMaxContactsByAorIsHonored>),
         TEST_NO_TAG("An AOR cannot contain more than max-contacts-by-aor [Redis]", run<RedisMaxContactsByAorIsHonored>),
@@ -0,0 +1,64 @@
+/*
+    Flexisip, a flexible SIP proxy server with media capabilities.
+    Copyright (C) 2010-2024 Belledonne Communications SARL, All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "utils/pool-allocator.hh"
+
+#include <cstdint>
+#include <memory>
+
+#include "utils/test-patterns/test.hh"
+#include "utils/test-suite.hh"
+
+namespace flexisip::tester {
+
+using namespace std;
+
+namespace {
+
+struct Payload {
+	uint64_t values[8];
+};
+
+/*
+ * Objects created with makePooled() give their memory block back to the free list of the thread on destruction, and
+ * the next object of the same type reuses it instead of allocating.
+ */
+void blocksAreRecycled() {
+	auto object = makePooled<Payload>();
+	const auto* address = object.get();
+	object.reset();
+
+	object = makePooled<Payload>();
+	BC_ASSERT_TRUE(object.get() == address);
+	for (auto i = 0; i < 100; ++i) {
+		object.reset();
+		object = makePooled<Payload>();
+		BC_ASSERT_TRUE(object.get() == address);
+	}
+
+	// Live objects do not share their block.
+	const auto other = makePooled<Payload>();
+	BC_ASSERT_TRUE(other.get() != address);
+}
+
+TestSuite _("PoolAllocator",
+            {
+                CLASSY_TEST(blocksAreRecycled),
+            });
+} // namespace
+} // namespace flexisip::tester
@@ -0,0 +1,109 @@
+/*
+    Flexisip, a flexible SIP proxy server with media capabilities.
+    Copyright (C) 2010-2024 Belledonne Communications SARL, All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "utils/rendezvous-hash.hh"
+
+#include <map>
+#include <string>
+
+#include "utils/test-patterns/test.hh"
+#include "utils/test-suite.hh"
+
+namespace flexisip::tester {
+
+using namespace std;
+
+namespace {
+
+constexpr auto kKeyCount = 10000;
+
+RendezvousHash<string> makeRing(int nodeCount) {
+	RendezvousHash<string> ring{};
+	for (int i = 0; i < nodeCount; ++i) {
+		ring.add("node" + to_string(i), hash<string>{}("node" + to_string(i)));
+	}
+	return ring;
+}
+
+/*
+ * The same key is always assigned to the same node, and every node gets a share of the keys.
+ */
+void stableAssignment() {
+	const auto ring = makeRing(4);
+	map<string, int> shares{};
+	for (uint64_t key = 0; key < kKeyCount; ++key) {
+		const auto* node = ring.pick(key);
+		BC_HARD_ASSERT(node != nullptr);
+		BC_ASSERT_CPP_EQUAL(*node, *ring.pick(key));
+		shares[*node]++;
+	}
+
+	BC_ASSERT_CPP_EQUAL(shares.size(), 4);
+	for (const auto& [node, share] : shares) {
+		BC_ASSERT_TRUE(kKeyCount / 4 * 0.8 < share && share < kKeyCount / 4 * 1.2);
+	}
+}
+
+/*
+ * Adding a node only moves keys to this node. Skipping a node only moves the keys that were assigned to it.
+ */
+void minimalDisruption() {
+	const auto before = makeRing(4);
+	const auto after = makeRing(5);
+	auto moved = 0;
+	for (uint64_t key = 0; key < kKeyCount; ++key) {
+		const auto& oldNode = *before.pick(key);
+		const auto& newNode = *after.pick(key);
+		if (oldNode == newNode) continue;
+		BC_ASSERT_CPP_EQUAL(newNode, "node4");
+		moved++;
+	}
+	BC_ASSERT_TRUE(kKeyCount / 5 * 0.8 < moved && moved < kKeyCount / 5 * 1.2);
+
+	for (uint64_t key = 0; key < kKeyCount; ++key) {
+		const auto& node = *after.pick(key);
+		const auto& failover = *after.pick(key, [](const string& candidate) { return candidate != "node2"; });
+		if (node != "node2") BC_ASSERT_CPP_EQUAL(failover, node);
+		else BC_ASSERT_CPP_NOT_EQUAL(failover, "node2");
+	}
+
+	BC_ASSERT_TRUE(after.pick(0, [](const string&) { return false; }) == nullptr);
+}
+
+/*
+ * Shares of keys are proportional to node weights.
+ */
+void weightedAssignment() {
+	RendezvousHash<string> ring{};
+	ring.add("light", 1, 1.0);
+	ring.add("heavy", 2, 3.0);
+	auto heavyShare = 0;
+	for (uint64_t key = 0; key < kKeyCount; ++key) {
+		if (*ring.pick(key) == "heavy") heavyShare++;
+	}
+	BC_ASSERT_TRUE(kKeyCount * 3 / 4 * 0.9 < heavyShare && heavyShare < kKeyCount * 3 / 4 * 1.1);
+}
+
+TestSuite _("RendezvousHash",
+            {
+                CLASSY_TEST(stableAssignment),
+                CLASSY_TEST(minimalDisruption),
+                CLASSY_TEST(weightedAssignment),
+            });
+} // namespace
+} // namespace flexisip::tester
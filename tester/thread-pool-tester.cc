@@ -1,6 +1,6 @@
 /*
     Flexisip, a flexible SIP proxy server with media capabilities.
-    Copyright (C) 2010-2023 Belledonne Communications SARL, All rights reserved.
+    Copyright (C) 2010-2024 Belledonne Communications SARL, All rights reserved.
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU Affero General Public License as
@@ -16,6 +16,17 @@
     along with this program. If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <chrono>
+#include <condition_variable>
+#include <queue>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "flexisip/logmanager.hh"
+
+#include "utils/asserts.hh"
 #include "utils/test-patterns/test.hh"
 #include "utils/test-suite.hh"
 #include "utils/thread/auto-thread-pool.hh"
@@ -118,11 +129,196 @@ private:
 };
 
 namespace {
+using namespace std::chrono;
+
+/*
+ * Queued tasks are executed by order of priority, then by order of submission.
+ */
+void tasksAreExecutedByPriority() {
+	BasicThreadPool threadPool{1, 0};
+	mutex gateMutex{};
+	condition_variable gate{};
+	bool open = false;
+	mutex orderMutex{};
+	vector<string> order{};
+	const auto record = [&](const string& name) {
+		return [&, name]() {
+			lock_guard<mutex> lock(orderMutex);
+			order.emplace_back(name);
+		};
+	};
+
+	// Keep the only thread busy while the other tasks are queued.
+	BC_HARD_ASSERT_TRUE(threadPool.run([&]() {
+		unique_lock<mutex> lock(gateMutex);
+		gate.wait(lock, [&]() { return open; });
+	}));
+	BC_HARD_ASSERT_TRUE(threadPool.run(record("low"), ThreadPool::Priority::Low));
+	BC_HARD_ASSERT_TRUE(threadPool.run(record("normal 1")));
+	BC_HARD_ASSERT_TRUE(threadPool.run(record("high"), ThreadPool::Priority::High));
+	BC_HARD_ASSERT_TRUE(threadPool.run(record("normal 2"), ThreadPool::Priority::Normal));
+	{
+		lock_guard<mutex> lock(gateMutex);
+		open = true;
+	}
+	gate.notify_all();
+	threadPool.stop();
+
+	BC_ASSERT_TRUE(order == vector<string>({"high", "normal 1", "normal 2", "low"}));
+	const auto stats = threadPool.getStats();
+	BC_ASSERT_CPP_EQUAL(stats.executedTasks, 5);
+	BC_ASSERT_CPP_EQUAL(stats.rejectedTasks, 0);
+	BC_ASSERT_CPP_EQUAL(threadPool.getQueuedTaskCount(), 0);
+	BC_ASSERT_TRUE(stats.maxRunTime <= stats.totalRunTime);
+	BC_ASSERT_TRUE(stats.maxQueueTime <= stats.totalQueueTime);
+	BC_ASSERT_FALSE(threadPool.run([]() {}));
+}
+
+/*
+ * Tasks submitted by a running task are executed, by the same thread or stolen by another one.
+ */
+template <typename ThreadPoolType>
+void tasksSubmittedFromThePool() {
+	ThreadPoolType threadPool{4, 0};
+	atomic_uint executed{0};
+	for (int i = 0; i < 10; i++) {
+		threadPool.run([&]() {
+			for (int j = 0; j < 10; j++) {
+				threadPool.run([&]() { executed++; });
+			}
+			executed++;
+		});
+	}
+	BC_ASSERT_TRUE(BcAssert<>().waitUntil(1s, [&]() { return executed == 110; }));
+	threadPool.stop();
+	BC_ASSERT_CPP_EQUAL(threadPool.getStats().executedTasks, 110);
+}
+
+/*
+ * Single queue guarded by one mutex, as used by the thread pools before work stealing. Measured as a baseline.
+ */
+class SingleQueueThreadPool {
+public:
+	explicit SingleQueueThreadPool(unsigned int threadNumber) {
+		for (unsigned int i = 0; i < threadNumber; i++) {
+			mThreads.emplace_back([this]() {
+				while (true) {
+					ThreadPool::Task task;
+					{
+						unique_lock<mutex> lock(mMutex);
+						mCondition.wait(lock, [this]() { return !mTasks.empty() || mStopped; });
+						if (mTasks.empty()) return;
+						task = std::move(mTasks.front());
+						mTasks.pop();
+					}
+					task();
+				}
+			});
+		}
+	}
+	~SingleQueueThreadPool() {
+		stop();
+	}
+
+	bool run(ThreadPool::Task task) {
+		{
+			lock_guard<mutex> lock(mMutex);
+			mTasks.push(std::move(task));
+		}
+		mCondition.notify_one();
+		return true;
+	}
+	void stop() {
+		{
+			lock_guard<mutex> lock(mMutex);
+			mStopped = true;
+		}
+		mCondition.notify_all();
+		for (auto& thread : mThreads) {
+			if (thread.joinable()) thread.join();
+		}
+	}
+
+private:
+	vector<thread> mThreads{};
+	mutex mMutex{};
+	condition_variable mCondition{};
+	queue<ThreadPool::Task> mTasks{};
+	bool mStopped = false;
+};
+
+/*
+ * Several threads submit short tasks, as the main loop and the DB threads do, to a pool of 4 threads.
+ * Run them with: flexisip_tester --suite "Thread pool tests" --verbose
+ */
+template <typename ThreadPoolType, unsigned int producers, unsigned int tasksPerProducer>
+void throughput() {
+	constexpr auto threadNumber = 4u;
+	constexpr auto taskCount = producers * tasksPerProducer;
+	unique_ptr<ThreadPoolType> threadPool{};
+	if constexpr (is_same_v<ThreadPoolType, SingleQueueThreadPool>) {
+		threadPool = make_unique<ThreadPoolType>(threadNumber);
+	} else {
+		threadPool = make_unique<ThreadPoolType>(threadNumber, 0);
+	}
+
+	atomic_uint executed{0};
+	atomic_uint64_t checksum{0};
+	const auto start = steady_clock::now();
+	vector<thread> submitters{};
+	for (unsigned int producer = 0; producer < producers; producer++) {
+		submitters.emplace_back([&, producer]() {
+			for (unsigned int i = 0; i < tasksPerProducer; i++) {
+				threadPool->run([&, value = uint64_t{producer} * tasksPerProducer + i]() {
+					checksum += value % 7;
+					executed++;
+				});
+			}
+		});
+	}
+	for (auto& submitter : submitters) {
+		submitter.join();
+	}
+	// Queued tasks are executed before the threads terminate.
+	threadPool->stop();
+	const auto elapsed = duration_cast<microseconds>(steady_clock::now() - start);
+	BC_ASSERT_CPP_EQUAL(executed.load(), taskCount);
+
+	uint64_t expectedChecksum = 0;
+	for (uint64_t value = 0; value < taskCount; value++) {
+		expectedChecksum += value % 7;
+	}
+	BC_ASSERT_CPP_EQUAL(checksum.load(), expectedChecksum);
+
+	string poolName = is_same_v<ThreadPoolType, SingleQueueThreadPool> ? "single queue"
+	                  : is_same_v<ThreadPoolType, BasicThreadPool>     ? "BasicThreadPool"
+	                                                                   : "AutoThreadPool";
+	SLOGI << "Thread pool benchmark - " << poolName << ", " << producers << " submitters, " << taskCount
+	      << " tasks in " << elapsed.count() / 1000 << "ms (" << taskCount * 1000 / max<int64_t>(elapsed.count(), 1)
+	      << " tasks per ms)";
+	if constexpr (!is_same_v<ThreadPoolType, SingleQueueThreadPool>) {
+		const auto stats = threadPool->getStats();
+		BC_ASSERT_CPP_EQUAL(stats.executedTasks, taskCount);
+		SLOGI << "Thread pool benchmark - " << poolName << ": " << stats.stolenTasks << " stolen tasks, queue time avg "
+		      << duration_cast<microseconds>(stats.totalQueueTime / taskCount).count() << "us max "
+		      << duration_cast<microseconds>(stats.maxQueueTime).count() << "us";
+	}
+}
+
 TestSuite _("Thread pool tests",
             {
                 TEST_NO_TAG("BasicThreadPool testing", run<ThreadPoolTest<BasicThreadPool>>),
                 TEST_NO_TAG("AutoThreadPool testing", run<ThreadPoolTest<AutoThreadPool>>),
+                CLASSY_TEST(tasksAreExecutedByPriority),
+                CLASSY_TEST(tasksSubmittedFromThePool<BasicThreadPool>),
+                CLASSY_TEST(tasksSubmittedFromThePool<AutoThreadPool>),
+                CLASSY_TEST((throughput<BasicThreadPool, 4, 25'000>)).tag("benchmark"),
+                CLASSY_TEST((throughput<AutoThreadPool, 4, 25'000>)).tag("benchmark"),
+                CLASSY_TEST((throughput<SingleQueueThreadPool, 4, 25'000>)).tag("benchmark"),
+                CLASSY_TEST((throughput<BasicThreadPool, 16, 250'000>)).tag("benchmark").tag("Skip"),
+                CLASSY_TEST((throughput<AutoThreadPool, 16, 250'000>)).tag("benchmark").tag("Skip"),
+                CLASSY_TEST((throughput<SingleQueueThreadPool, 16, 250'000>)).tag("benchmark").tag("Skip"),
             });
-}
+} // namespace
 } // namespace tester
 } // namespace flexisip
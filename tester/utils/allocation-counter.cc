@@ -0,0 +1,78 @@
+/*
+    Flexisip, a flexible SIP proxy server with media capabilities.
+    Copyright (C) 2010-2024 Belledonne Communications SARL, All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "allocation-counter.hh"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+namespace {
+
+atomic<uint64_t> sAllocations{0};
+
+void* countedAlloc(size_t size) {
+	sAllocations.fetch_add(1, memory_order_relaxed);
+	if (size == 0) size = 1;
+	if (auto* ptr = malloc(size)) return ptr;
+	throw bad_alloc{};
+}
+
+} // namespace
+
+void* operator new(size_t size) {
+	return countedAlloc(size);
+}
+void* operator new[](size_t size) {
+	return countedAlloc(size);
+}
+void* operator new(size_t size, const nothrow_t&) noexcept {
+	try {
+		return countedAlloc(size);
+	} catch (const bad_alloc&) {
+		return nullptr;
+	}
+}
+void* operator new[](size_t size, const nothrow_t&) noexcept {
+	return operator new(size, nothrow);
+}
+void operator delete(void* ptr) noexcept {
+	free(ptr);
+}
+void operator delete[](void* ptr) noexcept {
+	free(ptr);
+}
+void operator delete(void* ptr, size_t) noexcept {
+	free(ptr);
+}
+void operator delete[](void* ptr, size_t) noexcept {
+	free(ptr);
+}
+
+namespace flexisip::tester {
+
+AllocationCounter::AllocationCounter() noexcept : mStart{sAllocations.load(memory_order_relaxed)} {
+}
+
+uint64_t AllocationCounter::count() const noexcept {
+	return sAllocations.load(memory_order_relaxed) - mStart;
+}
+
+} // namespace flexisip::tester
@@ -0,0 +1,41 @@
+/*
+    Flexisip, a flexible SIP proxy server with media capabilities.
+    Copyright (C) 2010-2024 Belledonne Communications SARL, All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+namespace flexisip::tester {
+
+/**
+ * Count the heap allocations made through the global operator new, by any thread, since its construction.
+ * Memory allocated by C libraries (e.g. sofia-sip homes) through malloc() is not accounted.
+ * Counting replaces the global operator new and delete of the whole executable: only link it into
+ * flexisip_benchmark.
+ */
+class AllocationCounter {
+public:
+	AllocationCounter() noexcept;
+
+	std::uint64_t count() const noexcept;
+
+private:
+	std::uint64_t mStart;
+};
+
+} // namespace flexisip::tester
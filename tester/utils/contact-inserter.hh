@@ -78,6 +78,10 @@ public:
 		if (enabled) withUniqueId(true);
 		return *this;
 	}
+	ContactInserter& setAlias(bool alias) {
+		mParameters.alias = alias;
+		return *this;
+	}
 	ContactInserter& setExpire(std::chrono::seconds expire) {
 		mParameters.globalExpire = expire.count();
 		return *this;
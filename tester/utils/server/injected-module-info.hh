@@ -18,6 +18,8 @@ struct InjectedHooks {
 	std::string injectAfterModule{};
 	std::function<void(std::shared_ptr<RequestSipEvent>&)> onRequest = [](auto&) {};
 	std::function<void(std::shared_ptr<ResponseSipEvent>&)> onResponse = [](auto&) {};
+	SipMethodSet requestMethods = SipMethodSet::all();
+	SipMethodSet responseMethods = SipMethodSet::all();
 };
 
 // A helper class to register a custom module instance to the Agent's module chain
@@ -45,6 +47,13 @@ private:
 		    : Module(ag, moduleInfo), mHooks(hooks) {
 		}
 
+		SipMethodSet getHandledRequestMethods() const override {
+			return mHooks.requestMethods;
+		}
+		SipMethodSet getHandledResponseMethods() const override {
+			return mHooks.responseMethods;
+		}
+
 	private:
 		void onRequest(std::shared_ptr<RequestSipEvent>& ev) override {
 			mHooks.onRequest(ev);
@@ -0,0 +1,251 @@
+/*
+    Flexisip, a flexible SIP proxy server with media capabilities.
+    Copyright (C) 2010-2024 Belledonne Communications SARL, All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sip-load-replayer.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+
+#include <sofia-sip/sip_status.h>
+#include <sofia-sip/sip_tag.h>
+
+#include "flexisip/logmanager.hh"
+#include "flexisip/sofia-wrapper/msg-sip.hh"
+
+#include "allocation-counter.hh"
+
+using namespace std;
+using namespace std::chrono;
+
+namespace flexisip::tester {
+
+namespace {
+
+void replaceAll(string& str, string_view pattern, string_view value) {
+	for (auto pos = str.find(pattern); pos != string::npos; pos = str.find(pattern, pos + value.size())) {
+		str.replace(pos, pattern.size(), value);
+	}
+}
+
+} // namespace
+
+SipScenario SipScenario::fromTraceFile(const filesystem::path& path) {
+	ifstream file{path};
+	if (!file) throw runtime_error{"cannot open SIP trace file '" + path.string() + "'"};
+
+	SipScenario scenario{path.stem().string(), {}};
+	string line{}, request{};
+	const auto flush = [&scenario, &request]() {
+		if (request.find_first_not_of("\r\n") != string::npos) scenario.requests.push_back(request + "\r\n");
+		request.clear();
+	};
+	while (getline(file, line)) {
+		if (!line.empty() && line.back() == '\r') line.pop_back();
+		if (line == "--") {
+			flush();
+			continue;
+		}
+		// Skip blank lines between two messages.
+		if (request.empty() && line.empty()) continue;
+		request += line + "\r\n";
+	}
+	flush();
+	return scenario;
+}
+
+double SipLoadReport::transactionsPerSecond() const {
+	const auto seconds = duration_cast<duration<double>>(elapsed).count();
+	return seconds > 0 ? transactions / seconds : 0.0;
+}
+
+microseconds SipLoadReport::latencyPercentile(double percentile) const {
+	if (latencies.empty()) return microseconds{0};
+	const auto rank = static_cast<size_t>(percentile / 100.0 * (latencies.size() - 1) + 0.5);
+	return latencies[min(rank, latencies.size() - 1)];
+}
+
+ostream& operator<<(ostream& stream, const SipLoadReport& report) {
+	return stream << report.transactions << " transactions (" << report.failedTransactions << " failed) in "
+	              << duration_cast<milliseconds>(report.elapsed).count() << "ms, "
+	              << static_cast<uint64_t>(report.transactionsPerSecond()) << " transactions/s, latency p50="
+	              << report.latencyPercentile(50).count() << "us p90=" << report.latencyPercentile(90).count()
+	              << "us p99=" << report.latencyPercentile(99).count() << "us, "
+	              << (report.transactions ? report.allocations / report.transactions : 0)
+	              << " allocations/transaction";
+}
+
+struct SipLoadReplayer::Sequence {
+	SipLoadReplayer& replayer;
+	size_t index{0};
+	size_t step{0};
+	string toTag{};
+	nta_outgoing_t* transaction{nullptr};
+	steady_clock::time_point sentAt{};
+	bool active{false};
+};
+
+SipLoadReplayer::SipLoadReplayer(const shared_ptr<sofiasip::SuRoot>& root, const string& proxyUri)
+    : mRoot{root}, mProxyUri{proxyUri} {
+	mCaller = nta_agent_create(mRoot->getCPtr(), URL_STRING_MAKE("sip:127.0.0.1:0;transport=tcp"), nullptr, nullptr,
+	                           TAG_END());
+	mCallee = nta_agent_create(mRoot->getCPtr(), URL_STRING_MAKE("sip:127.0.0.1:0;transport=tcp"), nullptr, nullptr,
+	                           TAG_END());
+	if (mCaller == nullptr || mCallee == nullptr) throw runtime_error{"creating nta_agent_t failed"};
+
+	// Default leg of the callee: receives every incoming request, whatever its dialog.
+	mCalleeLeg = nta_leg_tcreate(mCallee, &SipLoadReplayer::onIncomingRequest,
+	                             reinterpret_cast<nta_leg_magic_t*>(this), NTATAG_NO_DIALOG(1), TAG_END());
+	if (mCalleeLeg == nullptr) throw runtime_error{"creating nta_leg_t failed"};
+}
+
+SipLoadReplayer::~SipLoadReplayer() {
+	for (const auto& sequence : mSequences) {
+		if (sequence->transaction) nta_outgoing_destroy(sequence->transaction);
+	}
+	nta_leg_destroy(mCalleeLeg);
+	nta_agent_destroy(mCallee);
+	nta_agent_destroy(mCaller);
+}
+
+string SipLoadReplayer::getCalleeAddress() const {
+	const auto* url = nta_agent_contact(mCallee)->m_url;
+	return string{url->url_host} + ":" + url->url_port;
+}
+
+SipLoadReport SipLoadReplayer::replay(const SipScenario& scenario,
+                                      size_t iterations,
+                                      size_t concurrency,
+                                      milliseconds timeout) {
+	mScenario = &scenario;
+	mIterations = iterations;
+	mNextIndex = 0;
+	mFinished = 0;
+	mReport = SipLoadReport{};
+	mReport.latencies.reserve(iterations * scenario.requests.size());
+	mSequences.clear();
+
+	const AllocationCounter allocations{};
+	const auto startedAt = steady_clock::now();
+	for (size_t i = 0; i < min(concurrency, iterations); ++i) {
+		mSequences.push_back(make_unique<Sequence>(Sequence{*this}));
+		start(*mSequences.back());
+	}
+	const auto deadline = startedAt + timeout;
+	while (mFinished < mIterations && steady_clock::now() < deadline) {
+		mRoot->step(10ms);
+	}
+	mReport.elapsed = steady_clock::now() - startedAt;
+	mReport.allocations = allocations.count();
+
+	for (const auto& sequence : mSequences) {
+		if (!sequence->active) continue;
+		if (sequence->transaction) nta_outgoing_destroy(sequence->transaction);
+		sequence->transaction = nullptr;
+		sequence->active = false;
+		mReport.failedTransactions++;
+	}
+	if (mFinished < mIterations) {
+		SLOGW << "SipLoadReplayer - '" << scenario.name << "' replay timed out after " << mFinished << "/"
+		      << mIterations << " iterations";
+	}
+	sort(mReport.latencies.begin(), mReport.latencies.end());
+	mScenario = nullptr;
+	return mReport;
+}
+
+void SipLoadReplayer::start(Sequence& sequence) {
+	if (mNextIndex >= mIterations) {
+		sequence.active = false;
+		return;
+	}
+	sequence.index = mNextIndex++;
+	sequence.step = 0;
+	sequence.toTag.clear();
+	sequence.active = true;
+	sendNextRequest(sequence);
+}
+
+void SipLoadReplayer::sendNextRequest(Sequence& sequence) {
+	while (sequence.step < mScenario->requests.size()) {
+		auto raw = mScenario->requests[sequence.step++];
+		replaceAll(raw, "{index}", to_string(sequence.index));
+		replaceAll(raw, "{callee}", getCalleeAddress());
+		replaceAll(raw, "{to-tag}", sequence.toTag);
+		auto request = MsgSip{0, raw};
+		const auto* sip = request.getSip();
+		if (sip == nullptr || sip->sip_request == nullptr) {
+			SLOGE << "SipLoadReplayer - invalid request in scenario '" << mScenario->name << "':\n" << raw;
+			mReport.failedTransactions++;
+			continue;
+		}
+
+		const auto* route = URL_STRING_MAKE(mProxyUri.c_str());
+		if (sip->sip_request->rq_method == sip_method_ack) {
+			nta_msg_tsend(mCaller, msg_ref_create(request.getMsg()), route, TAG_END());
+			continue;
+		}
+
+		sequence.sentAt = steady_clock::now();
+		sequence.transaction =
+		    nta_outgoing_mcreate(mCaller, &SipLoadReplayer::onOutgoingResponse,
+		                         reinterpret_cast<nta_outgoing_magic_t*>(&sequence), route, request.getMsg(), TAG_END());
+		if (sequence.transaction == nullptr) {
+			mReport.failedTransactions++;
+			continue;
+		}
+		// The transaction now holds a reference on the message.
+		msg_ref(request.getMsg());
+		return;
+	}
+
+	mFinished++;
+	start(sequence);
+}
+
+void SipLoadReplayer::onResponse(Sequence& sequence, const sip_t* response) {
+	const auto status = response ? response->sip_status->st_status : 408;
+	if (status < 200) return;
+
+	mReport.transactions++;
+	mReport.latencies.push_back(duration_cast<microseconds>(steady_clock::now() - sequence.sentAt));
+	if (status >= 300) mReport.failedTransactions++;
+	if (response && response->sip_to && response->sip_to->a_tag) sequence.toTag = response->sip_to->a_tag;
+
+	nta_outgoing_destroy(sequence.transaction);
+	sequence.transaction = nullptr;
+	sendNextRequest(sequence);
+}
+
+int SipLoadReplayer::onOutgoingResponse(nta_outgoing_magic_t* magic, nta_outgoing_t*, const sip_t* sip) {
+	auto& sequence = *reinterpret_cast<Sequence*>(magic);
+	sequence.replayer.onResponse(sequence, sip);
+	return 0;
+}
+
+int SipLoadReplayer::onIncomingRequest(nta_leg_magic_t* magic, nta_leg_t*, nta_incoming_t* transaction, const sip_t* sip) {
+	if (sip->sip_request->rq_method == sip_method_ack) return 0;
+
+	const auto& replayer = *reinterpret_cast<SipLoadReplayer*>(magic);
+	nta_incoming_tag(transaction, nullptr);
+	nta_incoming_treply(transaction, SIP_200_OK, SIPTAG_CONTACT(nta_agent_contact(replayer.mCallee)), TAG_END());
+	return 0;
+}
+
+} // namespace flexisip::tester
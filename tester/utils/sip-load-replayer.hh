@@ -0,0 +1,124 @@
+/*
+    Flexisip, a flexible SIP proxy server with media capabilities.
+    Copyright (C) 2010-2024 Belledonne Communications SARL, All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sofia-sip/nta.h>
+
+#include "flexisip/sofia-wrapper/su-root.hh"
+
+namespace flexisip::tester {
+
+/**
+ * A sequence of SIP requests played by a user agent, one after the other: each request is sent once the previous one
+ * has received its final response (ACK requests are sent without waiting for anything).
+ *
+ * Requests are raw messages in which the following placeholders are substituted before sending:
+ *  - {index}: the index of the replayed sequence, to make user names and Call-IDs unique,
+ *  - {callee}: the "host:port" address of the callee user agent of the replayer,
+ *  - {to-tag}: the tag of the To header of the last response received in the sequence.
+ */
+struct SipScenario {
+	/**
+	 * Load a scenario from a recorded trace: raw SIP requests separated by lines only made of "--".
+	 */
+	static SipScenario fromTraceFile(const std::filesystem::path& path);
+
+	std::string name;
+	std::vector<std::string> requests;
+};
+
+/**
+ * Results of a replay.
+ */
+struct SipLoadReport {
+	std::size_t transactions{0};
+	std::size_t failedTransactions{0};
+	std::chrono::steady_clock::duration elapsed{};
+	// Time between the sending of each request and the reception of its final response, sorted by increasing order.
+	std::vector<std::chrono::microseconds> latencies{};
+	// Heap allocations made by the whole process (proxy and user agents) during the replay.
+	std::uint64_t allocations{0};
+
+	double transactionsPerSecond() const;
+	std::chrono::microseconds latencyPercentile(double percentile) const;
+};
+
+std::ostream& operator<<(std::ostream& stream, const SipLoadReport& report);
+
+/**
+ * Replay SipScenario instances against a proxy, over loopback TCP connections.
+ *
+ * The replayer owns a caller user agent, that sends the requests of the scenario, and a callee user agent, that answers
+ * 200 to every request it receives. Both run on the event loop given at construction, which is usually the one of the
+ * proxy under test.
+ */
+class SipLoadReplayer {
+public:
+	SipLoadReplayer(const std::shared_ptr<sofiasip::SuRoot>& root, const std::string& proxyUri);
+	SipLoadReplayer(const SipLoadReplayer&) = delete;
+	~SipLoadReplayer();
+
+	/**
+	 * @return the "host:port" address of the callee user agent, to use in registered contacts.
+	 */
+	std::string getCalleeAddress() const;
+
+	/**
+	 * Play the scenario `iterations` times, keeping up to `concurrency` sequences in progress at the same time.
+	 * Stops early if the whole replay takes longer than `timeout`.
+	 */
+	SipLoadReport replay(const SipScenario& scenario,
+	                     std::size_t iterations,
+	                     std::size_t concurrency,
+	                     std::chrono::milliseconds timeout = std::chrono::seconds{60});
+
+private:
+	struct Sequence;
+
+	void start(Sequence& sequence);
+	void sendNextRequest(Sequence& sequence);
+	void onResponse(Sequence& sequence, const sip_t* response);
+
+	static int onOutgoingResponse(nta_outgoing_magic_t* magic, nta_outgoing_t* transaction, const sip_t* sip);
+	static int onIncomingRequest(nta_leg_magic_t* magic, nta_leg_t* leg, nta_incoming_t* transaction, const sip_t* sip);
+
+	std::shared_ptr<sofiasip::SuRoot> mRoot;
+	std::string mProxyUri;
+	nta_agent_t* mCaller{nullptr};
+	nta_agent_t* mCallee{nullptr};
+	nta_leg_t* mCalleeLeg{nullptr};
+
+	// State of the replay in progress.
+	const SipScenario* mScenario{nullptr};
+	std::vector<std::unique_ptr<Sequence>> mSequences{};
+	std::size_t mNextIndex{0};
+	std::size_t mIterations{0};
+	std::size_t mFinished{0};
+	SipLoadReport mReport{};
+};
+
+} // namespace flexisip::tester